@@ -20,3 +20,47 @@ add_test(NAME xbmgmt2
   WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
 
 set_tests_properties(xbutil xbmgmt PROPERTIES ENVIRONMENT INTERNAL_BUILD=1)
+
+# ERT firmware scheduler against simulated hardware
+add_test(NAME ert_sim_polling
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/ert/scheduler/ert_sim --cmds 2000 --cus 8 --slot-size 0x400
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+add_test(NAME ert_sim_interrupt
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/ert/scheduler/ert_sim --cmds 2000 --cus 40 --slot-size 0x200 --cu-dma --cu-isr --cq-int --cu-jitter 500
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+add_test(NAME ert_sim_v30
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/ert/scheduler/ert_sim --v30 --kds30 --cq-int --cmds 2000 --cus 8
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+# Shared KDS core in user space against simulated CUs
+add_test(NAME kds_bench_cu
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/core/common/drv/user/kds_bench --cus 8 --clients 4 --cmds 5000
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+add_test(NAME kds_bench_shared
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/core/common/drv/user/kds_bench --cus 8 --clients 4 --cus-per-client 2 --cmds 2000 --latency 10 --depth 2
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+add_test(NAME kds_bench_ert
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/core/common/drv/user/kds_bench --ert --clients 4 --cmds 5000
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+add_test(NAME kds_bench_power_of_two
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/core/common/drv/user/kds_bench --cus 8 --clients 4 --cmds 2000 --latency 10 --depth 2 --policy power_of_two
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+add_test(NAME kds_bench_fair_share
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/core/common/drv/user/kds_bench --cus 4 --clients 4 --window 4 --noisy-window 256 --cmds 2000 --latency 10 --policy fair_share --stat
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+# Kernel printf buffer decode, compiled formats against per record parsing
+add_test(NAME printf_bench
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/xocl/api/printf/test/printf_bench --work-items 256 --iterations 1
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+
+# PL trace decoder, batched data packets against per packet decode
+add_test(NAME trace_s2mm
+  COMMAND ${CMAKE_BINARY_DIR}/runtime_src/xdp/profile/device/test/trace_s2mm_test
+  WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
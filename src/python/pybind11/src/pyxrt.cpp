@@ -25,8 +25,30 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 
+#include <chrono>
+#include <vector>
+
 namespace py = pybind11;
 
+namespace {
+
+// Set kernel arguments from python objects. Check the type before
+// casting, a failing cast throws and is expensive on every launch.
+void
+set_run_args(xrt::run& r, const py::args& args)
+{
+  int i = 0;
+  for (auto item : args) {
+    if (py::isinstance<xrt::bo>(item))
+      r.set_arg(i, item.cast<xrt::bo&>());
+    else if (py::isinstance<py::int_>(item))
+      r.set_arg<int>(i, item.cast<int>());
+    i++;
+  }
+}
+
+} // namespace
+
 PYBIND11_MODULE(pyxrt, m) {
 m.doc() = "Pybind11 module for XRT";
 
@@ -42,6 +64,17 @@ py::enum_<xclBOSyncDirection>(m, "xclBOSyncDirection")
     .value("XCL_BO_SYNC_BO_TO_DEVICE", xclBOSyncDirection::XCL_BO_SYNC_BO_TO_DEVICE)
     .value("XCL_BO_SYNC_BO_FROM_DEVICE", xclBOSyncDirection::XCL_BO_SYNC_BO_FROM_DEVICE);
 
+py::enum_<ert_cmd_state>(m, "ert_cmd_state")
+    .value("ERT_CMD_STATE_NEW", ert_cmd_state::ERT_CMD_STATE_NEW)
+    .value("ERT_CMD_STATE_QUEUED", ert_cmd_state::ERT_CMD_STATE_QUEUED)
+    .value("ERT_CMD_STATE_RUNNING", ert_cmd_state::ERT_CMD_STATE_RUNNING)
+    .value("ERT_CMD_STATE_COMPLETED", ert_cmd_state::ERT_CMD_STATE_COMPLETED)
+    .value("ERT_CMD_STATE_ERROR", ert_cmd_state::ERT_CMD_STATE_ERROR)
+    .value("ERT_CMD_STATE_ABORT", ert_cmd_state::ERT_CMD_STATE_ABORT)
+    .value("ERT_CMD_STATE_SUBMITTED", ert_cmd_state::ERT_CMD_STATE_SUBMITTED)
+    .value("ERT_CMD_STATE_TIMEOUT", ert_cmd_state::ERT_CMD_STATE_TIMEOUT)
+    .value("ERT_CMD_STATE_NORESPONSE", ert_cmd_state::ERT_CMD_STATE_NORESPONSE);
+
 
 /*
  *
@@ -88,16 +121,16 @@ py::class_<xrt::device>(m, "device")
 py::class_<xrt::run>(m, "run")
    .def(py::init<>())
    .def(py::init<const xrt::kernel &>()) 
-   .def("start", &xrt::run::start)
+   .def("start", &xrt::run::start, py::call_guard<py::gil_scoped_release>())
    .def("set_arg", [](xrt::run & r, int i, xrt::bo & item){
        r.set_arg(i, item);
      })
    .def("set_arg", [](xrt::run & r, int i, int & item){
        r.set_arg<int>(i, item);
      })  
-   .def("wait", [](xrt::run & r) {
-       r.wait();
-     })
+   .def("wait", [](xrt::run & r, unsigned int timeout_ms) {
+       return r.wait(std::chrono::milliseconds(timeout_ms));
+     }, py::arg("timeout_ms") = 0, py::call_guard<py::gil_scoped_release>())
     .def("state", &xrt::run::state)
     .def("add_callback", &xrt::run::add_callback)
     ;
@@ -106,23 +139,13 @@ py::class_<xrt::kernel>(m, "kernel")
     .def(py::init([](xrt::device d, const py::array_t<unsigned char> u, const std::string & n, bool e){
         return new xrt::kernel(d, (const unsigned char*) u.request().ptr, n, e);
     }))
-  .def("__call__", [](xrt::kernel & k, py::args args) -> xrt::run {    
-	int i =0;
+  .def("__call__", [](xrt::kernel & k, py::args args) -> xrt::run {
 	xrt::run r(k);
-	
-	for (auto item : args) {
-	  try 
-	    { r.set_arg(i, item.cast<xrt::bo>()); }
-	  catch (std::exception e) {  }
-	  
-	  try 
-	    { r.set_arg<int>(i, item.cast<int>()); }
-	  catch (std::exception e) {  }
-	  
-	  i++;
+	set_run_args(r, args);
+	{
+	  py::gil_scoped_release release;
+	  r.start();
 	}
-	
-	r.start();
 	return r;
     })
     .def("group_id", &xrt::kernel::group_id)
@@ -136,8 +159,22 @@ py::class_<xrt::kernel>(m, "kernel")
  * XRT:: BO
  *
  */
-py::class_<xrt::bo>(m, "bo")
+py::class_<xrt::bo>(m, "bo", py::buffer_protocol())
     .def(py::init<xrt::device,size_t,xrt::buffer_flags,xrt::memory_group>())
+    // Expose host mapped memory of the buffer, numpy.asarray(bo)
+    // or memoryview(bo) views device buffer without copying
+    .def_buffer([](xrt::bo &b) -> py::buffer_info {
+	  return py::buffer_info(b.map(), sizeof(unsigned char),
+				 py::format_descriptor<unsigned char>::format(),
+				 1, { b.size() }, { sizeof(unsigned char) });
+    })
+    .def("map", ([](xrt::bo &b) {
+	  return py::memoryview(py::buffer_info(b.map(), sizeof(unsigned char),
+						py::format_descriptor<unsigned char>::format(),
+						1, { b.size() }, { sizeof(unsigned char) }));
+    }), py::keep_alive<0, 1>())
+    .def("size", &xrt::bo::size)
+    .def("address", &xrt::bo::address)
     .def("write", ([](xrt::bo &b, py::array_t<int> pyb, size_t seek)  {
 	  py::buffer_info info = pyb.request();
 	  int* pybptr = (int*) info.ptr;
@@ -155,6 +192,28 @@ py::class_<xrt::bo>(m, "bo")
      }))
   .def("sync", ([](xrt::bo &b, xclBOSyncDirection dir, size_t size, size_t offset)  {	
 	b.sync(dir, size, offset);
-      }))
+      }), py::call_guard<py::gil_scoped_release>())
     ;
+
+
+/*
+ *
+ * Batched run launch and wait
+ *
+ */
+m.def("start_runs", [](std::vector<xrt::run> runs) {
+    py::gil_scoped_release release;
+    for (auto& r : runs)
+      r.start();
+  }, "Start all runs in the list with one call");
+
+m.def("wait_runs", [](const std::vector<xrt::run>& runs, unsigned int timeout_ms) {
+    std::vector<ert_cmd_state> states;
+    states.reserve(runs.size());
+    py::gil_scoped_release release;
+    for (auto& r : runs)
+      states.push_back(r.wait(std::chrono::milliseconds(timeout_ms)));
+    return states;
+  }, py::arg("runs"), py::arg("timeout_ms") = 0,
+  "Wait for all runs in the list, return list of command states");
 }
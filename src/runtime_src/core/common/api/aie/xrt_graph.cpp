@@ -284,6 +284,28 @@ xrtGraphWaitDone(xrtGraphHandle graph_hdl, int timeoutMilliSec)
   }
 }
 
+std::future<int>
+xrt::aie::
+wait_graph_done_async(xrtGraphHandle graph_hdl, int timeoutMilliSec)
+{
+  // The graph_impl is shared with the waiter so an early
+  // xrtGraphClose does not pull the graph from under it.
+  auto hdl = get_graph_hdl(graph_hdl);
+  return std::async(std::launch::async, [hdl, timeoutMilliSec] {
+    try {
+      return hdl->wait(timeoutMilliSec);
+    }
+    catch (const xrt_core::error& ex) {
+      xrt_core::send_exception_message(ex.what());
+      return ex.get();
+    }
+    catch (const std::exception& ex) {
+      send_exception_message(ex.what());
+      return -1;
+    }
+  });
+}
+
 int
 xrtGraphWait(xrtGraphHandle graph_hdl, uint64_t cycle)
 {
@@ -32,7 +32,9 @@
 #include "core/common/message.h"
 
 #include <map>
+#include <mutex>
 #include <set>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 )
@@ -108,6 +110,19 @@ protected:
   size_t size;             // size of buffer
   bool free_bo;            // should dtor free bo
 
+  // Buffers imported from this buffer by other devices.  Cached for
+  // repeated cross device copies and released with this buffer.  The
+  // cache does not keep the importing device open, an import is
+  // dropped when its device is closed.
+  struct import_type
+  {
+    xclBufferHandle handle;
+    size_t size;
+  };
+  using device_key = std::weak_ptr<xrt_core::device>;
+  mutable std::mutex import_mutex;
+  mutable std::map<device_key, import_type, std::owner_less<device_key>> imports;
+
 public:
   explicit bo_impl(size_t sz)
     : handle(XRT_NULL_BO), size(sz), free_bo(false)
@@ -129,9 +144,17 @@ public:
     : device(parent->device), handle(parent->handle), size(sz), free_bo(false)
   {}
 
+  bo_impl(std::shared_ptr<xrt_core::device> dev, xclBufferHandle bhdl, size_t sz)
+    : device(std::move(dev)), handle(bhdl), size(sz), free_bo(false)
+  {}
+
   virtual
   ~bo_impl()
   {
+    for (auto& import : imports)
+      if (auto target = import.first.lock())
+        target->free_bo(import.second.handle);
+
     if (free_bo)
       device->free_bo(handle);
   }
@@ -154,6 +177,39 @@ public:
     return device->export_bo(handle);
   }
 
+  // Get this buffer imported by the target device, the imported
+  // buffer is the full buffer also for a sub-buffer
+  import_type
+  import_by(const std::shared_ptr<xrt_core::device>& target) const
+  {
+    std::lock_guard<std::mutex> lk(import_mutex);
+
+    // Imports into closed devices were released with the device
+    for (auto itr = imports.begin(); itr != imports.end(); ) {
+      if (itr->first.expired())
+        itr = imports.erase(itr);
+      else
+        ++itr;
+    }
+
+    auto itr = imports.find(target);
+    if (itr != imports.end())
+      return itr->second;
+
+    auto boh = target->import_bo(export_buffer());
+    xclBOProperties prop;
+    try {
+      target->get_bo_properties(boh, &prop);
+    }
+    catch (...) {
+      target->free_bo(boh);
+      throw;
+    }
+    import_type import {boh, prop.size};
+    imports.emplace(target, import);
+    return import;
+  }
+
   void
   write(const void* src, size_t sz, size_t seek)
   {
@@ -187,25 +243,26 @@ public:
     }
 
     // try copying with m2m
-    try {
-      auto m2m = xrt_core::device_query<xrt_core::query::m2m>(get_device());
-      if (xrt_core::query::m2m::to_bool(m2m)) {
+    if (device->get_capabilities().m2m) {
+      try {
         device->copy_bo(get_handle(), src->get_handle(), sz, dst_offset, src_offset);
         return;
       }
-    }
-    catch (const std::exception&) {
+      catch (const std::exception&) {
+      }
     }
 
     // try copying with kdma
-    try {
-      xrt_core::kernel_int::copy_bo_with_kdma
-        (device, sz, get_handle(), dst_offset, src->get_handle(), src_offset);
-      return;
-    }
-    catch (const std::exception& ex) {
-      auto fmt = boost::format("Reverting to host copy of buffers (%s)") % ex.what();
-      xrt_core::message::send(xrt_core::message::severity_level::XRT_WARNING, "XRT",  fmt.str());
+    if (device->get_capabilities().kdma) {
+      try {
+        xrt_core::kernel_int::copy_bo_with_kdma
+          (device, sz, get_handle(), dst_offset, src->get_handle(), src_offset);
+        return;
+      }
+      catch (const std::exception& ex) {
+        auto fmt = boost::format("Reverting to host copy of buffers (%s)") % ex.what();
+        xrt_core::message::send(xrt_core::message::severity_level::XRT_WARNING, "XRT",  fmt.str());
+      }
     }
 
     // revert to copying through host
@@ -213,13 +270,7 @@ public:
   }
 
   void
-  copy_with_export(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset)
-  {
-    // export bo from other device and create an import bo to copy from
-    auto src_export_handle = src->export_buffer();
-    auto src_import_bo = xrt::bo(device->get_user_handle(), src_export_handle);
-    copy(src_import_bo.get_handle().get(), sz, src_offset, dst_offset);
-  }
+  copy_with_export(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset);
 
   void
   copy_through_host(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset)
@@ -358,6 +409,41 @@ public:
   }
 };
 
+// class buffer_import_view - Cached import of a buffer from another device
+//
+// Used as copy source for cross device copies.  The view does not
+// own the imported buffer handle, which is cached by the exporting
+// buffer.  The buffer is mapped only if copied through host.
+class buffer_import_view : public bo_impl
+{
+  mutable void* hbuf = nullptr;
+
+public:
+  buffer_import_view(std::shared_ptr<xrt_core::device> dev, xclBufferHandle bhdl, size_t sz)
+    : bo_impl(std::move(dev), bhdl, sz)
+  {}
+
+  ~buffer_import_view()
+  {
+    if (hbuf)
+      device->unmap_bo(handle, hbuf);
+  }
+
+  virtual bool
+  is_imported() const
+  {
+    return true;
+  }
+
+  virtual void*
+  get_hbuf() const
+  {
+    if (!hbuf)
+      hbuf = device->map_bo(handle, false);
+    return hbuf;
+  }
+};
+
 // class buffer_dbuf - device only buffer
 //
 class buffer_dbuf : public bo_impl
@@ -453,6 +539,112 @@ public:
   }
 };
 
+// class buffer_arena - Sub buffer allocated from a bo_arena
+//
+// The range of the parent buffer is returned to the free list of
+// the arena when the buffer is destroyed.  The buffer participates
+// in ownership of the arena so the free list outlives the buffer.
+class buffer_arena : public buffer_sub
+{
+  std::shared_ptr<bo_arena_impl> arena;
+  std::shared_ptr<bo_impl> chunk;
+  memory_group grp;
+  unsigned int size_class;
+
+public:
+  buffer_arena(std::shared_ptr<bo_arena_impl> ar, std::shared_ptr<bo_impl> par,
+               size_t size, size_t off, memory_group mgrp, unsigned int cls)
+    : buffer_sub(par, size, off)
+    , arena(std::move(ar))
+    , chunk(std::move(par))
+    , grp(mgrp)
+    , size_class(cls)
+  {}
+
+  ~buffer_arena();
+};
+
+void
+bo_impl::
+copy_with_export(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset)
+{
+  // export bo from other device and import to this device to copy
+  // from, the import is reused by later copies from the same bo
+  auto src_import = src->import_by(device);
+  buffer_import_view src_view(device, src_import.handle, src_import.size);
+  copy(&src_view, sz, src_offset + src->get_offset(), dst_offset);
+}
+
+// class bo_arena_impl - Size class allocator of sub buffers
+//
+// Each memory group has a parent buffer (chunk) that is carved into
+// blocks of power of two sizes.  Released blocks are kept in per
+// size class free lists and are preferred over carving new blocks.
+// When a chunk is exhausted a new chunk is allocated, the remainder
+// of the old chunk is not used.
+class bo_arena_impl : public std::enable_shared_from_this<bo_arena_impl>
+{
+  static constexpr size_t default_chunk_size = 4 * 1024 * 1024;
+  static constexpr size_t min_block_size = 64;
+
+  struct block
+  {
+    std::shared_ptr<bo_impl> chunk;
+    size_t offset;
+  };
+
+  struct bank
+  {
+    std::shared_ptr<bo_impl> chunk;       // chunk being carved
+    size_t used = 0;                      // carved bytes of chunk
+    std::vector<std::vector<block>> free; // free blocks per size class
+  };
+
+  xclDeviceHandle dhdl;
+  buffer_flags flags;
+  size_t chunk_size;
+  size_t max_block_size;
+  unsigned int num_classes;
+
+  std::mutex mutex;
+  std::map<memory_group, bank> banks;
+
+  block
+  get_block(memory_group grp, unsigned int cls);
+
+public:
+  bo_arena_impl(xclDeviceHandle xhdl, buffer_flags bflags, size_t csz)
+    : dhdl(xhdl)
+    , flags(bflags)
+    , chunk_size(csz ? csz : default_chunk_size)
+    , max_block_size(min_block_size)
+    , num_classes(1)
+  {
+    if (chunk_size < min_block_size)
+      throw xrt_core::error(-EINVAL, "arena chunk size too small");
+    while (max_block_size * 2 <= chunk_size / 64) {
+      max_block_size *= 2;
+      ++num_classes;
+    }
+  }
+
+  std::shared_ptr<bo_impl>
+  alloc(size_t size, memory_group grp);
+
+  void
+  release(memory_group grp, unsigned int cls, std::shared_ptr<bo_impl> chunk, size_t offset)
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    banks[grp].free[cls].push_back({std::move(chunk), offset});
+  }
+};
+
+buffer_arena::
+~buffer_arena()
+{
+  arena->release(grp, size_class, std::move(chunk), get_offset());
+}
+
 } // namespace xrt
 
 // Implementation details
@@ -584,6 +776,59 @@ get_xcl_device_handle(xrtDeviceHandle dhdl)
 
 } // namespace
 
+namespace xrt {
+
+bo_arena_impl::block
+bo_arena_impl::
+get_block(memory_group grp, unsigned int cls)
+{
+  auto block_size = min_block_size << cls;
+
+  std::lock_guard<std::mutex> lk(mutex);
+  auto& b = banks[grp];
+  if (b.free.empty())
+    b.free.resize(num_classes);
+
+  auto& free = b.free[cls];
+  if (!free.empty()) {
+    auto blk = std::move(free.back());
+    free.pop_back();
+    return blk;
+  }
+
+  // Carve a new block, blocks are aligned to their size
+  auto offset = (b.used + block_size - 1) & ~(block_size - 1);
+  if (!b.chunk || offset + block_size > chunk_size) {
+    b.chunk = ::alloc(dhdl, chunk_size, flags, grp);
+    offset = 0;
+  }
+  b.used = offset + block_size;
+  return {b.chunk, offset};
+}
+
+std::shared_ptr<bo_impl>
+bo_arena_impl::
+alloc(size_t size, memory_group grp)
+{
+  if (!size || size > max_block_size)
+    return ::alloc(dhdl, size, flags, grp);
+
+  unsigned int cls = 0;
+  while ((min_block_size << cls) < size)
+    ++cls;
+
+  auto blk = get_block(grp, cls);
+  try {
+    return std::make_shared<buffer_arena>(shared_from_this(), blk.chunk, size, blk.offset, grp, cls);
+  }
+  catch (...) {
+    release(grp, cls, std::move(blk.chunk), blk.offset);
+    throw;
+  }
+}
+
+} // xrt
+
 ////////////////////////////////////////////////////////////////
 // xrt_bo implementation of extension APIs not exposed to end-user
 ////////////////////////////////////////////////////////////////
@@ -687,6 +932,18 @@ copy(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
   handle->copy(src.handle.get(), sz ? sz : src.size(), src_offset, dst_offset);
 }
 
+bo_arena::
+bo_arena(xclDeviceHandle dhdl, buffer_flags flags, size_t chunk_size)
+  : handle(std::make_shared<bo_arena_impl>(dhdl, flags, chunk_size))
+{}
+
+bo
+bo_arena::
+alloc(size_t size, memory_group grp)
+{
+  return bo(handle->alloc(size, grp));
+}
+
 } // xrt
 
 ////////////////////////////////////////////////////////////////
@@ -286,6 +286,40 @@ get_verbosity()
   return value;
 }
 
+/**
+ * Write runtime_log messages from a background thread.  Senders only
+ * copy the message into a ring buffer.  Warnings and worse are still
+ * written by the sender.
+ */
+inline bool
+get_logging_async()
+{
+  static bool value = detail::get_bool_value("Runtime.runtime_log_async",false);
+  return value;
+}
+
+/**
+ * Format of runtime_log messages, "text" or "compact".  Compact skips
+ * the calendar timestamp and prints seconds since the first message.
+ */
+inline std::string
+get_logging_format()
+{
+  static std::string value = detail::get_string_value("Runtime.runtime_log_format","text");
+  return value;
+}
+
+/**
+ * Max notice, info, and debug messages per second per message tag,
+ * 0 for no limit
+ */
+inline unsigned int
+get_logging_rate_limit()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.runtime_log_rate_limit",0);
+  return value;
+}
+
 inline unsigned int
 get_dma_threads()
 {
@@ -293,6 +327,18 @@ get_dma_threads()
   return value;
 }
 
+/**
+ * Use io_uring instead of Linux AIO for streaming queues that create
+ * their own completion context.  AIO is used if io_uring is not
+ * supported by the kernel.
+ */
+inline bool
+get_stream_io_uring()
+{
+  static bool value = detail::get_bool_value("Runtime.stream_io_uring",false);
+  return value;
+}
+
 inline unsigned int
 get_polling_throttle()
 {
@@ -320,6 +366,16 @@ get_xclbin_programming()
   return get_xclbin_programing();
 }
 
+/**
+ * Skip xclbin download when device already has the same xclbin loaded
+ */
+inline bool
+get_xclbin_skip_identical()
+{
+  static bool value = detail::get_bool_value("Runtime.xclbin_skip_identical",true);
+  return value;
+}
+
 /**
  * Enable xma mode. 1 = default (1 cu cmd at a time); 2 = (upto 2 cu cmds at a time);  
  *     3 = (upto 8 cu cmds at a time);  4 = (upto 64 cu cmds at a time); Max cu cmds at a time per session
@@ -341,6 +397,17 @@ get_xma_cpu_mode()
   return value;
 }
 
+/**
+ * XMA session placement. 0 = default (CU requested by session);
+ *     1 = least loaded CU of same kernel on requested device; 2 = least loaded CU of same kernel on any device
+ */
+inline unsigned int
+get_xma_load_balance()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.xma_load_balance",0x0);
+  return value;
+}
+
 /**
  * Enable / Disable kernel driver scheduling when running in hardware.
  * If disabled, xrt will be scheduling either using the software scheduler
@@ -403,6 +470,18 @@ get_ert_cqint()
   return value;
 }
 
+/**
+ * KDS CU selection policy requested in the configure command, one of
+ * least_used, least_outstanding, power_of_two, fair_share.  Empty
+ * keeps the policy set in the driver (sysfs kds_policy).
+ */
+inline std::string
+get_kds_cu_policy()
+{
+  static std::string value = detail::get_string_value("Runtime.kds_cu_policy","");
+  return value;
+}
+
 /**
  * Set slot size for embedded scheduler CQ
  */
@@ -462,6 +541,25 @@ get_cmdbo_cache()
   return value;
 }
 
+/**
+ * How to wait for AIE graph and GMIO completion. "backoff" spins
+ * briefly, then yields, then sleeps with exponential backoff up to
+ * aie_wait_max_sleep_us between status polls. "spin" busy polls.
+ */
+inline std::string
+get_aie_wait_mode()
+{
+  static std::string value = detail::get_string_value("Runtime.aie_wait_mode","backoff");
+  return value;
+}
+
+inline unsigned int
+get_aie_wait_max_sleep_us()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.aie_wait_max_sleep_us",500);
+  return value;
+}
+
 inline std::string
 get_hw_em_driver()
 {
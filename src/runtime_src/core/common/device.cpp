@@ -29,6 +29,38 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <cstring>
+
+namespace {
+
+// Section cached by register_axlf().  If group topology or group
+// connectivity doesn't exists then use the mem topology or
+// connectivity respectively section for the same.
+const axlf_section_header*
+get_cached_section_header(const axlf* top, axlf_section_kind kind)
+{
+  auto hdr = ::xclbin::get_axlf_section(top, kind);
+  if (hdr)
+    return hdr;
+  if (kind == ASK_GROUP_TOPOLOGY)
+    return ::xclbin::get_axlf_section(top, MEM_TOPOLOGY);
+  if (kind == ASK_GROUP_CONNECTIVITY)
+    return ::xclbin::get_axlf_section(top, CONNECTIVITY);
+  return nullptr;
+}
+
+bool
+is_same_section(const axlf* top, axlf_section_kind kind, const std::vector<char>& data)
+{
+  auto hdr = get_cached_section_header(top, kind);
+  if (!hdr)
+    return data.empty();
+  auto section_data = reinterpret_cast<const char*>(top) + hdr->m_sectionOffset;
+  return hdr->m_sectionSize == data.size()
+    && std::memcmp(section_data, data.data(), data.size()) == 0;
+}
+
+}
 
 namespace xrt_core {
 
@@ -64,6 +96,42 @@ is_nodma() const
   return *m_nodma;
 }
 
+std::shared_ptr<const device::capabilities>
+device::
+update_capabilities() const
+{
+  auto caps = std::make_shared<capabilities>();
+
+  try {
+    caps->m2m = query::m2m::to_bool(device_query<query::m2m>(this));
+  }
+  catch (const std::exception&) {
+  }
+
+  try {
+    caps->kdma = device_query<query::kds_numcdmas>(this);
+  }
+  catch (const std::exception&) {
+  }
+
+  std::shared_ptr<const capabilities> published = std::move(caps);
+  std::atomic_store(&m_caps, published);
+  return published;
+}
+
+device::capabilities
+device::
+get_capabilities() const
+{
+  if (auto caps = std::atomic_load(&m_caps))
+    return *caps;
+
+  std::lock_guard<std::mutex> lk(m_caps_mutex);
+  if (auto caps = std::atomic_load(&m_caps))
+    return *caps;
+  return *update_capabilities();
+}
+
 uuid
 device::
 get_xclbin_uuid() const
@@ -89,23 +157,49 @@ register_axlf(const axlf* top)
                                ASK_GROUP_CONNECTIVITY, ASK_GROUP_TOPOLOGY, 
                                MEM_TOPOLOGY, DEBUG_IP_LAYOUT, SYSTEM_METADATA, CLOCK_FREQ_TOPOLOGY};
   for (auto kind : kinds) {
-    auto hdr = ::xclbin::get_axlf_section(top, kind);
-    if (!hdr) {
-      /* If group topology or group connectivity doesn't exists then use the
-       * mem topology or connectivity respectively section for the same.
-       */
-      if (kind == ASK_GROUP_TOPOLOGY)
-        hdr = ::xclbin::get_axlf_section(top, MEM_TOPOLOGY);
-      else if (kind == ASK_GROUP_CONNECTIVITY)
-        hdr = ::xclbin::get_axlf_section(top, CONNECTIVITY);
-
-      if (!hdr)
-        continue;
-    }
+    auto hdr = get_cached_section_header(top, kind);
+    if (!hdr)
+      continue;
     auto section_data = reinterpret_cast<const char*>(top) + hdr->m_sectionOffset;
     std::vector<char> data{section_data, section_data + hdr->m_sectionSize};
     m_axlf_sections.emplace(kind , std::move(data));
   }
+
+  // Features such as KDMA depend on the xclbin
+  std::lock_guard<std::mutex> lk(m_caps_mutex);
+  update_capabilities();
+}
+
+bool
+device::
+is_xclbin_loaded(const axlf* top) const
+{
+  uuid xclbin_id(top->m_header.uuid);
+  if (!xclbin_id || !config::get_xclbin_skip_identical())
+    return false;
+
+  try {
+    // Another process may have reloaded the device since this process
+    // cached its xclbin, the device must report what it runs
+    auto loaded_id = get_xclbin_uuid();
+    if (!loaded_id || loaded_id != xclbin_id)
+      return false;
+
+    if (m_xclbin_uuid == xclbin_id) {
+      for (auto& section : m_axlf_sections)
+        if (!is_same_section(top, section.first, section.second))
+          return false;
+      return true;
+    }
+
+    // Loaded by another process, compare with sections in driver
+    return is_same_section(top, IP_LAYOUT, device_query<query::ip_layout_raw>(this))
+      && is_same_section(top, MEM_TOPOLOGY, device_query<query::mem_topology_raw>(this));
+  }
+  catch (const std::exception&) {
+    // Download xclbin if device state cannot be read
+  }
+  return false;
 }
 
 std::pair<const char*, size_t>
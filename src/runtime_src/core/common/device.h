@@ -31,6 +31,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <boost/any.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/optional/optional.hpp>
@@ -54,6 +56,18 @@ public:
   using id_type = unsigned int;
   using handle_type = xclDeviceHandle;
 
+  /**
+   * struct capabilities - Device features used by data paths
+   *
+   * A feature that cannot be queried, e.g. in emulation, is reported
+   * as not present.
+   */
+  struct capabilities
+  {
+    bool m2m = false;        // m2m copy engine
+    uint32_t kdma = 0;       // number of KDMA engines
+  };
+
 public:
 
   XRT_CORE_COMMON_EXPORT
@@ -138,6 +152,18 @@ public:
   bool
   is_nodma() const;
 
+  /**
+   * get_capabilities() - Get features of this device
+   *
+   * Return: Capabilities of the device with currently loaded xclbin
+   *
+   * The capabilities are queried once, when first used, and again
+   * when an xclbin is loaded.  Reading them does not access sysfs.
+   */
+  XRT_CORE_COMMON_EXPORT
+  capabilities
+  get_capabilities() const;
+
  private:
   // Private look up function for concrete query::request
   virtual const query::request&
@@ -203,6 +229,24 @@ public:
   uuid
   get_xclbin_uuid() const;
 
+  /**
+   * is_xclbin_loaded() - Check if xclbin is already loaded on device
+   *
+   * Return: true if device has xclbin with same uuid and same meta
+   * data sections loaded.
+   *
+   * The uuid is read from the device, false is returned if the device
+   * does not report one.  The sections are compared with the ones
+   * cached by register_axlf(), or with the sections in the driver if
+   * another process loaded the xclbin.  Emulation shims use this to
+   * skip relaunching the device process, xocl skips the download of
+   * an identical xclbin itself after checking the scheduler is
+   * healthy.  Disabled with xrt.ini Runtime.xclbin_skip_identical=false.
+   */
+  XRT_CORE_COMMON_EXPORT
+  bool
+  is_xclbin_loaded(const axlf*) const;
+
   /**
    * get_axlf_section() - Get section from currently loaded axlf
    *
@@ -294,9 +338,17 @@ public:
   }
 
  private:
+  // query and publish capabilities, caller must hold m_caps_mutex
+  std::shared_ptr<const capabilities>
+  update_capabilities() const;
+
   id_type m_device_id;
   mutable boost::optional<bool> m_nodma = boost::none;
 
+  // published capabilities, accessed with std::atomic_load/store
+  mutable std::mutex m_caps_mutex;
+  mutable std::shared_ptr<const capabilities> m_caps;
+
   // cache xclbin meta data loaded by this process
   uuid m_xclbin_uuid;
   std::map<axlf_section_kind, std::vector<char>> m_axlf_sections;
@@ -29,6 +29,7 @@ enum kds_status {
 };
 
 struct kds_command;
+struct kds_sched;
 
 struct kds_cmd_ops {
 	void (*notify_host)(struct kds_command *xcmd, int status);
@@ -71,6 +72,12 @@ struct kds_command {
 	void			*gem_obj;
 	/* to notify inkernel exec completion */
 	struct in_kernel_cb	*inkern_cb;
+	/* KDS private. KDS interposes on cb.notify_host of started
+	 * commands for CU outstanding and client statistics.
+	 */
+	struct kds_sched	*kds;
+	void (*host_notify)(struct kds_command *xcmd, int status);
+	u64			 submit_ns;
 };
 
 /* execbuf command related funtions */
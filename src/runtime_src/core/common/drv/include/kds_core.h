@@ -12,6 +12,7 @@
 
 #include <linux/list.h>
 #include <linux/mutex.h>
+#include <linux/spinlock.h>
 #include <linux/pid.h>
 #include <linux/device.h>
 #include <linux/uuid.h>
@@ -65,6 +66,16 @@ struct kds_ctx_info {
  * @cu_bitmap: bitmap of opening CU
  * @waitq: Wait queue for poll client
  * @event: Events to notify user client
+ * @stats_lock: Protects below scheduling state and statistics
+ * @weight: Fair share weight, from the nice value of the client process
+ * @outstanding: Number of started commands not yet completed
+ * @backlog: Commands held back by the fair share policy
+ * @num_backlog: Number of commands in @backlog
+ * @s_cnt: Number of started commands
+ * @c_cnt: Number of completed commands
+ * @lat_cnt: Number of latency samples
+ * @lat_sum: Sum of sampled submit to completion latency in ns
+ * @lat_max: Maximum sampled latency in ns
  */
 struct kds_client {
 	struct list_head	  link;
@@ -90,8 +101,43 @@ struct kds_client {
 	u64			  padding[16];
 	wait_queue_head_t	  waitq;
 	atomic_t		  event;
+	spinlock_t		  stats_lock;
+	u32			  weight;
+	u32			  outstanding;
+	struct list_head	  backlog;
+	u32			  num_backlog;
+	u64			  s_cnt;
+	u64			  c_cnt;
+	u64			  lat_cnt;
+	u64			  lat_sum;
+	u64			  lat_max;
 };
 
+/**
+ * CU selection policies, see acquire_cu_idx()
+ *
+ * @KDS_CU_LEAST_USED: CU with the fewest commands since configured
+ * @KDS_CU_LEAST_OUTSTANDING: CU with the fewest commands in flight
+ * @KDS_CU_POWER_OF_TWO: Less loaded of two random candidate CUs
+ * @KDS_CU_FAIR_SHARE: Least outstanding, and a client may only have
+ *	its weighted share of CU queue slots in flight. Commands over
+ *	the share wait in the client backlog until one of its commands
+ *	completes.
+ */
+enum kds_cu_policy {
+	KDS_CU_LEAST_USED = 0,
+	KDS_CU_LEAST_OUTSTANDING,
+	KDS_CU_POWER_OF_TWO,
+	KDS_CU_FAIR_SHARE,
+	KDS_CU_POLICY_MAX, // always the last one
+};
+
+/* In flight commands per CU shared by active clients in fair share */
+#define KDS_FAIR_DEPTH		2
+
+/* One in KDS_LAT_SAMPLE started commands is timestamped */
+#define KDS_LAT_SAMPLE		16
+
 /* the MSB of cu_refs is used for exclusive flag */
 #define CU_EXCLU_MASK		0x80000000
 struct kds_cu_mgmt {
@@ -101,8 +147,17 @@ struct kds_cu_mgmt {
 	int			  num_cdma;
 	u32			  cu_intr[MAX_CUS];
 	u32			  cu_refs[MAX_CUS];
-	u64			  cu_usage[MAX_CUS];
+	/* cu_usage pick and count of least used policy, the completion
+	 * path dispatches backlog commands and must not sleep
+	 */
+	spinlock_t		  usage_lock;
+	atomic64_t		  cu_usage[MAX_CUS];
+	atomic_t		  cu_outstanding[MAX_CUS];
 	int			  configured;
+	u32			  policy;
+	/* policy of sysfs kds_policy, restored when all clients are gone */
+	u32			  default_policy;
+	u32			  rand_state;
 };
 
 /* ERT core */
@@ -122,6 +177,7 @@ struct kds_ert {
  * @ert_disable: remote scheduler is disabled or not
  * @cu_intr_cap: capbility of CU interrupt support
  * @cu_intr: CU or ERT interrupt. 1 for CU, 0 for ERT.
+ * @active_weight: Sum of weight of clients with outstanding commands
  */
 struct kds_sched {
 	struct list_head	clients;
@@ -133,6 +189,7 @@ struct kds_sched {
 	bool			ert_disable;
 	u32			cu_intr_cap;
 	u32			cu_intr;
+	atomic_t		active_weight;
 };
 
 int kds_init_sched(struct kds_sched *kds);
@@ -163,4 +220,6 @@ int store_kds_echo(struct kds_sched *kds, const char *buf, size_t count,
 		   int kds_mode, u32 clients, int *echo);
 ssize_t show_kds_stat(struct kds_sched *kds, char *buf);
 ssize_t show_kds_custat_raw(struct kds_sched *kds, char *buf);
+ssize_t show_kds_policy(struct kds_sched *kds, char *buf);
+int store_kds_policy(struct kds_sched *kds, const char *buf, size_t count);
 #endif
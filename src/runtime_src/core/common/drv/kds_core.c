@@ -59,7 +59,7 @@ ssize_t show_kds_custat_raw(struct kds_sched *kds, char *buf)
 		sz += scnprintf(buf+sz, PAGE_SIZE - sz, cu_fmt, i,
 				xcu->info.kname, xcu->info.iname,
 				xcu->info.addr, xcu->status,
-				cu_mgmt->cu_usage[i]);
+				(u64)atomic64_read(&cu_mgmt->cu_usage[i]));
 	}
 	mutex_unlock(&cu_mgmt->lock);
 
@@ -71,10 +71,22 @@ ssize_t show_kds_custat_raw(struct kds_sched *kds, char *buf)
 	return sz;
 }
 
+static const char * const kds_cu_policy_names[] = {
+	[KDS_CU_LEAST_USED]		= "least_used",
+	[KDS_CU_LEAST_OUTSTANDING]	= "least_outstanding",
+	[KDS_CU_POWER_OF_TWO]		= "power_of_two",
+	[KDS_CU_FAIR_SHARE]		= "fair_share",
+};
+
 ssize_t show_kds_stat(struct kds_sched *kds, char *buf)
 {
 	struct kds_cu_mgmt *cu_mgmt = &kds->cu_mgmt;
-	char *cu_fmt = "  CU[%d] usage(%llu) shared(%d) refcnt(%d) intr(%s)\n";
+	char *cu_fmt = "  CU[%d] usage(%llu) outstanding(%d) shared(%d) refcnt(%d) intr(%s)\n";
+	char *client_fmt = "  Client pid(%d) weight(%u) outstanding(%u) backlog(%u) started(%llu) completed(%llu) latency avg(%llu) max(%llu) us\n";
+	struct kds_client *client;
+	unsigned long flags;
+	u32 weight, outstanding, backlog;
+	u64 s_cnt, c_cnt, lat_avg, lat_max;
 	ssize_t sz = 0;
 	bool shared;
 	int ref;
@@ -88,17 +100,43 @@ ssize_t show_kds_stat(struct kds_sched *kds, char *buf)
 			(kds->cu_intr)? "cu" : "ert");
 	sz += scnprintf(buf+sz, PAGE_SIZE - sz, "Configured: %d\n",
 			cu_mgmt->configured);
+	sz += scnprintf(buf+sz, PAGE_SIZE - sz, "CU policy: %s\n",
+			kds_cu_policy_names[cu_mgmt->policy]);
 	sz += scnprintf(buf+sz, PAGE_SIZE - sz, "Number of CUs: %d\n",
 			cu_mgmt->num_cus);
 	for (i = 0; i < cu_mgmt->num_cus; ++i) {
 		shared = !(cu_mgmt->cu_refs[i] & CU_EXCLU_MASK);
 		ref = cu_mgmt->cu_refs[i] & ~CU_EXCLU_MASK;
 		sz += scnprintf(buf+sz, PAGE_SIZE - sz, cu_fmt,
-				i, cu_mgmt->cu_usage[i], shared, ref,
+				i, (u64)atomic64_read(&cu_mgmt->cu_usage[i]),
+				atomic_read(&cu_mgmt->cu_outstanding[i]),
+				shared, ref,
 				(cu_mgmt->cu_intr[i])? "enable" : "disable");
 	}
 	mutex_unlock(&cu_mgmt->lock);
 
+	mutex_lock(&kds->lock);
+	sz += scnprintf(buf+sz, PAGE_SIZE - sz, "Number of clients: %d\n",
+			kds->num_client);
+	list_for_each_entry(client, &kds->clients, link) {
+		spin_lock_irqsave(&client->stats_lock, flags);
+		weight = client->weight;
+		outstanding = client->outstanding;
+		backlog = client->num_backlog;
+		s_cnt = client->s_cnt;
+		c_cnt = client->c_cnt;
+		lat_avg = client->lat_cnt ?
+			  div64_u64(client->lat_sum, client->lat_cnt) : 0;
+		lat_max = client->lat_max;
+		spin_unlock_irqrestore(&client->stats_lock, flags);
+
+		sz += scnprintf(buf+sz, PAGE_SIZE - sz, client_fmt,
+				pid_nr(client->pid), weight, outstanding,
+				backlog, s_cnt, c_cnt,
+				div_u64(lat_avg, 1000), div_u64(lat_max, 1000));
+	}
+	mutex_unlock(&kds->lock);
+
 	if (sz < PAGE_SIZE - 1)
 		buf[sz++] = 0;
 	else
@@ -106,6 +144,38 @@ ssize_t show_kds_stat(struct kds_sched *kds, char *buf)
 
 	return sz;
 }
+
+ssize_t show_kds_policy(struct kds_sched *kds, char *buf)
+{
+	ssize_t sz = 0;
+	u32 policy = READ_ONCE(kds->cu_mgmt.policy);
+	int i;
+
+	for (i = 0; i < KDS_CU_POLICY_MAX; ++i) {
+		sz += scnprintf(buf+sz, PAGE_SIZE - sz,
+				(i == policy) ? "[%s] " : "%s ",
+				kds_cu_policy_names[i]);
+	}
+	if (sz)
+		buf[sz - 1] = '\n';
+
+	return sz;
+}
+
+int store_kds_policy(struct kds_sched *kds, const char *buf, size_t count)
+{
+	int i;
+
+	for (i = 0; i < KDS_CU_POLICY_MAX; ++i) {
+		if (sysfs_streq(buf, kds_cu_policy_names[i])) {
+			WRITE_ONCE(kds->cu_mgmt.default_policy, i);
+			WRITE_ONCE(kds->cu_mgmt.policy, i);
+			return count;
+		}
+	}
+
+	return -EINVAL;
+}
 /* sysfs end */
 
 /**
@@ -134,6 +204,7 @@ static int
 kds_cu_config(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 {
 	struct kds_client *client = xcmd->client;
+	struct ert_configure_cmd *ecmd = (struct ert_configure_cmd *)xcmd->execbuf;
 	int ret = 0;
 
 	/* This is no-op. The new KDS doesn't need configure command.
@@ -149,6 +220,10 @@ kds_cu_config(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 		goto out;
 	}
 
+	/* CU selection policy requested by the first configuring client */
+	if (ecmd && ecmd->cu_policy && ecmd->cu_policy <= KDS_CU_POLICY_MAX)
+		WRITE_ONCE(cu_mgmt->policy, ecmd->cu_policy - 1);
+
 	cu_mgmt->configured = 1;
 
 out:
@@ -156,6 +231,71 @@ out:
 	return ret;
 }
 
+/* xorshift32, racy updates only perturb the sequence */
+static inline u32
+kds_rand(struct kds_cu_mgmt *cu_mgmt)
+{
+	u32 x = cu_mgmt->rand_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	cu_mgmt->rand_state = x;
+	return x;
+}
+
+/* Fewer outstanding commands wins, ties go to the less used CU */
+static inline bool
+kds_cu_less_loaded(struct kds_cu_mgmt *cu_mgmt, int a, int b)
+{
+	int oa = atomic_read(&cu_mgmt->cu_outstanding[a]);
+	int ob = atomic_read(&cu_mgmt->cu_outstanding[b]);
+
+	if (oa != ob)
+		return oa < ob;
+
+	return atomic64_read(&cu_mgmt->cu_usage[a]) <
+	       atomic64_read(&cu_mgmt->cu_usage[b]);
+}
+
+static int
+least_used_cu(struct kds_cu_mgmt *cu_mgmt, uint8_t *cus, int num)
+{
+	uint8_t index = cus[0];
+	int i;
+
+	for (i = 1; i < num; ++i) {
+		if (atomic64_read(&cu_mgmt->cu_usage[cus[i]]) <
+		    atomic64_read(&cu_mgmt->cu_usage[index]))
+			index = cus[i];
+	}
+
+	return index;
+}
+
+static int
+least_outstanding_cu(struct kds_cu_mgmt *cu_mgmt, uint8_t *cus, int num)
+{
+	uint8_t index = cus[0];
+	int i;
+
+	for (i = 1; i < num; ++i) {
+		if (kds_cu_less_loaded(cu_mgmt, cus[i], index))
+			index = cus[i];
+	}
+
+	return index;
+}
+
+static int
+power_of_two_cu(struct kds_cu_mgmt *cu_mgmt, uint8_t *cus, int num)
+{
+	u32 a = kds_rand(cu_mgmt) % num;
+	u32 b = (a + 1 + kds_rand(cu_mgmt) % (num - 1)) % num;
+
+	return kds_cu_less_loaded(cu_mgmt, cus[b], cus[a]) ? cus[b] : cus[a];
+}
+
 /**
  * acquire_cu_idx - Get ready CU index
  *
@@ -163,6 +303,11 @@ out:
  *
  * Returns: Negative value for error. 0 or positive value for index
  *
+ * Candidate CUs are chosen by cu_mgmt->policy. Only the least used
+ * policy takes a lock, the others read per CU atomic counters and may
+ * race with other submitters, which at worst picks a CU that is one
+ * command busier. This is also called from command completion to
+ * dispatch backlog commands, so it must not sleep.
  */
 static int
 acquire_cu_idx(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
@@ -175,6 +320,7 @@ acquire_cu_idx(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 	uint8_t valid_cus[MAX_CUS];
 	int num_valid = 0;
 	uint8_t index;
+	unsigned long flags;
 	int i;
 
 	num_marked = cu_mask_to_cu_idx(xcmd, user_cus);
@@ -193,25 +339,36 @@ acquire_cu_idx(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 
 	if (num_valid == 1) {
 		index = valid_cus[0];
-		mutex_lock(&cu_mgmt->lock);
 		goto out;
 	} else if (num_valid == 0) {
 		kds_err(client, "All CUs in mask are out of context");
 		return -EINVAL;
 	}
 
-	/* There are more than one valid candidate
-	 * TODO: test if the lock impact the performance on multi processes
-	 */
-	mutex_lock(&cu_mgmt->lock);
-	for (i = 1, index = valid_cus[0]; i < num_valid; ++i) {
-		if (cu_mgmt->cu_usage[valid_cus[i]] < cu_mgmt->cu_usage[index])
-			index = valid_cus[i];
+	/* There are more than one valid candidate */
+	switch (READ_ONCE(cu_mgmt->policy)) {
+	case KDS_CU_LEAST_OUTSTANDING:
+	case KDS_CU_FAIR_SHARE:
+		index = least_outstanding_cu(cu_mgmt, valid_cus, num_valid);
+		break;
+	case KDS_CU_POWER_OF_TWO:
+		index = power_of_two_cu(cu_mgmt, valid_cus, num_valid);
+		break;
+	default:
+		/* Pick and count under lock, or concurrent submitters
+		 * would all pick the same least used CU.
+		 */
+		spin_lock_irqsave(&cu_mgmt->usage_lock, flags);
+		index = least_used_cu(cu_mgmt, valid_cus, num_valid);
+		atomic64_inc(&cu_mgmt->cu_usage[index]);
+		spin_unlock_irqrestore(&cu_mgmt->usage_lock, flags);
+		atomic_inc(&cu_mgmt->cu_outstanding[index]);
+		return index;
 	}
 
 out:
-	++cu_mgmt->cu_usage[index];
-	mutex_unlock(&cu_mgmt->lock);
+	atomic64_inc(&cu_mgmt->cu_usage[index]);
+	atomic_inc(&cu_mgmt->cu_outstanding[index]);
 	return index;
 }
 
@@ -224,6 +381,7 @@ kds_cu_dispatch(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 	if (cu_idx < 0)
 		return cu_idx;
 
+	xcmd->cu_idx = cu_idx;
 	xrt_cu_submit(cu_mgmt->xcus[cu_idx], xcmd);
 	return 0;
 }
@@ -385,9 +543,14 @@ int kds_init_sched(struct kds_sched *kds)
 	INIT_LIST_HEAD(&kds->clients);
 	mutex_init(&kds->lock);
 	mutex_init(&kds->cu_mgmt.lock);
+	spin_lock_init(&kds->cu_mgmt.usage_lock);
 	kds->num_client = 0;
 	kds->bad_state = 0;
 	kds->ert_disable = 0;
+	kds->cu_mgmt.policy = KDS_CU_LEAST_USED;
+	kds->cu_mgmt.default_policy = KDS_CU_LEAST_USED;
+	kds->cu_mgmt.rand_state = 0x2545f491;
+	atomic_set(&kds->active_weight, 0);
 
 	return 0;
 }
@@ -448,6 +611,152 @@ void kds_free_command(struct kds_command *xcmd)
 #endif
 }
 
+/* Fair share of in flight commands for a client.
+ * Called with client->stats_lock held.
+ */
+static inline u32
+kds_client_share(struct kds_sched *kds, struct kds_client *client)
+{
+	u32 total = atomic_read(&kds->active_weight);
+	u32 share;
+
+	if (READ_ONCE(kds->cu_mgmt.policy) != KDS_CU_FAIR_SHARE)
+		return U32_MAX;
+
+	if (!client->outstanding)
+		total += client->weight;
+
+	/* Nobody else is competing */
+	if (total == client->weight)
+		return U32_MAX;
+
+	share = kds->cu_mgmt.num_cus * KDS_FAIR_DEPTH * client->weight / total;
+	return share ? share : 1;
+}
+
+/* Called with client->stats_lock held */
+static inline void
+kds_client_get(struct kds_sched *kds, struct kds_client *client)
+{
+	if (client->outstanding++ == 0)
+		atomic_add(client->weight, &kds->active_weight);
+}
+
+/**
+ * kds_cmd_done - Account a finished command
+ *
+ * @xcmd: Finished command
+ * @status: Command status
+ * @release: Backlog commands now within share are moved to this list
+ *
+ * Notifies host through the original notify_host callback. The caller
+ * is responsible to dispatch commands on @release.
+ */
+static void
+kds_cmd_done(struct kds_command *xcmd, int status, struct list_head *release)
+{
+	struct kds_sched *kds = xcmd->kds;
+	struct kds_client *client = xcmd->client;
+	struct kds_command *next;
+	unsigned long flags;
+	u64 lat = 0;
+
+	if (xcmd->cu_idx < MAX_CUS)
+		atomic_dec(&kds->cu_mgmt.cu_outstanding[xcmd->cu_idx]);
+
+	if (xcmd->submit_ns)
+		lat = ktime_get_raw_fast_ns() - xcmd->submit_ns;
+
+	spin_lock_irqsave(&client->stats_lock, flags);
+	++client->c_cnt;
+	if (xcmd->submit_ns) {
+		++client->lat_cnt;
+		client->lat_sum += lat;
+		if (lat > client->lat_max)
+			client->lat_max = lat;
+	}
+
+	if (--client->outstanding == 0)
+		atomic_sub(client->weight, &kds->active_weight);
+
+	while (client->num_backlog &&
+	       client->outstanding < kds_client_share(kds, client)) {
+		next = list_first_entry(&client->backlog,
+					struct kds_command, list);
+		list_move_tail(&next->list, release);
+		--client->num_backlog;
+		kds_client_get(kds, client);
+	}
+	spin_unlock_irqrestore(&client->stats_lock, flags);
+
+	xcmd->host_notify(xcmd, status);
+}
+
+static void
+kds_dispatch_list(struct kds_sched *kds, struct list_head *cmds)
+{
+	struct kds_command *xcmd;
+
+	/* Failed command may release more backlog onto the list */
+	while (!list_empty(cmds)) {
+		xcmd = list_first_entry(cmds, struct kds_command, list);
+		list_del(&xcmd->list);
+		if (kds_cu_dispatch(&kds->cu_mgmt, xcmd)) {
+			kds_cmd_done(xcmd, KDS_ERROR, cmds);
+			xcmd->cb.free(xcmd);
+		}
+	}
+}
+
+/* Installed as cb.notify_host of started commands */
+static void
+kds_cmd_notify(struct kds_command *xcmd, int status)
+{
+	LIST_HEAD(release);
+
+	kds_cmd_done(xcmd, status, &release);
+	kds_dispatch_list(xcmd->kds, &release);
+}
+
+/**
+ * kds_cmd_start - Account a command about to start
+ *
+ * @kds: KDS
+ * @xcmd: Command to start
+ *
+ * Returns: true if the command should be dispatched now. false if it
+ * exceeds the client fair share and is queued in the client backlog.
+ */
+static bool
+kds_cmd_start(struct kds_sched *kds, struct kds_command *xcmd)
+{
+	struct kds_client *client = xcmd->client;
+	unsigned long flags;
+	bool ready = true;
+
+	xcmd->kds = kds;
+	xcmd->host_notify = xcmd->cb.notify_host;
+	xcmd->cb.notify_host = kds_cmd_notify;
+	xcmd->cu_idx = MAX_CUS;
+
+	spin_lock_irqsave(&client->stats_lock, flags);
+	xcmd->submit_ns = (client->s_cnt++ % KDS_LAT_SAMPLE) ?
+			  0 : ktime_get_raw_fast_ns();
+
+	/* Only CU commands are held back, ERT has its own queue */
+	if (xcmd->type == KDS_CU &&
+	    (client->num_backlog ||
+	     client->outstanding >= kds_client_share(kds, client))) {
+		list_add_tail(&xcmd->list, &client->backlog);
+		++client->num_backlog;
+		ready = false;
+	} else
+		kds_client_get(kds, client);
+	spin_unlock_irqrestore(&client->stats_lock, flags);
+
+	return ready;
+}
+
 int kds_add_command(struct kds_sched *kds, struct kds_command *xcmd)
 {
 	struct kds_client *client = xcmd->client;
@@ -458,6 +767,9 @@ int kds_add_command(struct kds_sched *kds, struct kds_command *xcmd)
 
 	/* TODO: Check if command is blocked */
 
+	if (xcmd->opcode == OP_START && !kds_cmd_start(kds, xcmd))
+		return 0;
+
 	/* Command is good to submit */
 	switch (xcmd->type) {
 	case KDS_CU:
@@ -486,6 +798,11 @@ int kds_init_client(struct kds_sched *kds, struct kds_client *client)
 	init_waitqueue_head(&client->waitq);
 	atomic_set(&client->event, 0);
 
+	spin_lock_init(&client->stats_lock);
+	INIT_LIST_HEAD(&client->backlog);
+	/* nice -20..19 maps to weight 40..1 */
+	client->weight = 20 - task_nice(current);
+
 	mutex_lock(&kds->lock);
 	list_add_tail(&client->link, &kds->clients);
 	kds->num_client++;
@@ -536,8 +853,30 @@ _kds_fini_client(struct kds_sched *kds, struct kds_client *client)
 	WARN_ON(client->num_ctx);
 }
 
+/* Abort commands never dispatched by the fair share policy */
+static void
+kds_flush_backlog(struct kds_sched *kds, struct kds_client *client)
+{
+	struct kds_command *xcmd, *next;
+	unsigned long flags;
+	LIST_HEAD(aborted);
+
+	spin_lock_irqsave(&client->stats_lock, flags);
+	list_splice_tail_init(&client->backlog, &aborted);
+	client->num_backlog = 0;
+	spin_unlock_irqrestore(&client->stats_lock, flags);
+
+	list_for_each_entry_safe(xcmd, next, &aborted, list) {
+		list_del(&xcmd->list);
+		xcmd->host_notify(xcmd, KDS_ABORT);
+		xcmd->cb.free(xcmd);
+	}
+}
+
 void kds_fini_client(struct kds_sched *kds, struct kds_client *client)
 {
+	kds_flush_backlog(kds, client);
+
 #if PRE_ALLOC
 	vfree(client->xcmds);
 	vfree(client->infos);
@@ -553,8 +892,12 @@ void kds_fini_client(struct kds_sched *kds, struct kds_client *client)
 	mutex_lock(&kds->lock);
 	list_del(&client->link);
 	kds->num_client--;
-	if (!kds->num_client)
+	if (!kds->num_client) {
 		kds->cu_mgmt.configured = 0;
+		/* Drop the policy of the last configure command */
+		WRITE_ONCE(kds->cu_mgmt.policy,
+			   READ_ONCE(kds->cu_mgmt.default_policy));
+	}
 	mutex_unlock(&kds->lock);
 }
 
@@ -707,6 +1050,7 @@ int kds_add_cu(struct kds_sched *kds, struct xrt_cu *xcu)
 int kds_del_cu(struct kds_sched *kds, struct xrt_cu *xcu)
 {
 	struct kds_cu_mgmt *cu_mgmt = &kds->cu_mgmt;
+	int retry;
 	int i;
 
 	if (cu_mgmt->num_cus == 0)
@@ -718,7 +1062,17 @@ int kds_del_cu(struct kds_sched *kds, struct xrt_cu *xcu)
 
 		--cu_mgmt->num_cus;
 		cu_mgmt->xcus[i] = NULL;
-		cu_mgmt->cu_usage[i] = 0;
+		atomic64_set(&cu_mgmt->cu_usage[i], 0);
+
+		/* Commands in flight decrement the outstanding counter of
+		 * this slot on completion, so it is not reset here. Give
+		 * them a chance to drain before the slot is reused.
+		 */
+		for (retry = 0; retry < 10; retry++) {
+			if (atomic_read(&cu_mgmt->cu_outstanding[i]) <= 0)
+				break;
+			msleep(100);
+		}
 
 		/* m2m cu */
 		if (xcu->info.intr_id == M2M_CU_ID)
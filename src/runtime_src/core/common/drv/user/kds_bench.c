@@ -0,0 +1,578 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * KDS user space benchmark
+ *
+ * Copyright (C) 2020 Xilinx, Inc.
+ *
+ * Runs the shared KDS core (kds_core.c) and CU model (xrt_cu.c) in
+ * user space against simulated CUs, with a number of client threads
+ * submitting commands, and reports dispatch throughput, command
+ * latency, CU load balance and client fairness.
+ *
+ * A simulated CU has a hardware queue of configurable depth (the
+ * number of credits) and executes its tasks in order, each for a
+ * configurable time.  Time is the host monotonic clock, so CU threads
+ * busy poll exactly as they do in the driver.
+ *
+ * Examples:
+ *   # 8 CUs, 4 clients, every client can use every CU
+ *   kds_bench --cus 8 --clients 4 --cmds 100000
+ *
+ *   # each client owns 2 CUs, 50us kernels with a queue depth of 2
+ *   kds_bench --cus 8 --clients 4 --cus-per-client 2 --latency 50 --depth 2
+ *
+ *   # ERT mode, measures KDS CU selection only
+ *   kds_bench --ert --clients 8
+ *
+ *   # one client keeps 1024 commands in flight, the others 4
+ *   kds_bench --cus 4 --clients 4 --window 4 --noisy-window 1024 \
+ *             --latency 20 --policy fair_share --stat
+ *
+ * Exit status is 0 if all commands completed, 1 if any command failed,
+ * and 2 for usage errors.
+ */
+
+#include <getopt.h>
+#include "kds_core.h"
+
+int kds_compat_verbose;
+
+/* Simulated CU core behind struct xcu_funcs */
+struct sim_cu {
+	int		 max_credits;
+	int		 credits;
+	u64		 latency_ns;
+	u64		 jitter_ns;
+	unsigned int	 seed;
+	/* finish time of tasks in the hardware queue, in order */
+	u64		*finish;
+	u32		 head;
+	u32		 count;
+	u64		 last_finish;
+	u64		 busy_ns;
+	u64		 done;
+};
+
+static int sim_alloc_credit(void *core)
+{
+	struct sim_cu *cu = core;
+
+	return (cu->credits) ? cu->credits-- : 0;
+}
+
+static void sim_free_credit(void *core, u32 count)
+{
+	struct sim_cu *cu = core;
+
+	cu->credits += count;
+	if (cu->credits > cu->max_credits)
+		cu->credits = cu->max_credits;
+}
+
+static int sim_peek_credit(void *core)
+{
+	struct sim_cu *cu = core;
+
+	return cu->credits;
+}
+
+static void sim_configure(void *core, u32 *data, size_t sz, int type)
+{
+}
+
+static void sim_start(void *core)
+{
+	struct sim_cu *cu = core;
+	u64 now = ktime_get_raw_fast_ns();
+	u64 begin = (cu->last_finish > now) ? cu->last_finish : now;
+	u64 run = cu->latency_ns;
+
+	if (cu->jitter_ns)
+		run += (u64)rand_r(&cu->seed) % cu->jitter_ns;
+
+	cu->last_finish = begin + run;
+	cu->finish[(cu->head + cu->count) % cu->max_credits] = cu->last_finish;
+	++cu->count;
+	cu->busy_ns += run;
+}
+
+static void sim_check(void *core, struct xcu_status *status)
+{
+	struct sim_cu *cu = core;
+	u64 now;
+
+	if (!cu->count)
+		return;
+
+	now = ktime_get_raw_fast_ns();
+	while (cu->count && cu->finish[cu->head] <= now) {
+		cu->head = (cu->head + 1) % cu->max_credits;
+		--cu->count;
+		++cu->done;
+		++status->num_done;
+	}
+	/* A queue slot frees up when its task is done */
+	status->num_ready = status->num_done;
+	status->new_status = cu->count ? CU_AP_START : CU_AP_IDLE;
+}
+
+static void sim_reset(void *core)
+{
+}
+
+static int sim_reset_done(void *core)
+{
+	return 1;
+}
+
+static void sim_enable_intr(void *core, u32 intr_type)
+{
+}
+
+static void sim_disable_intr(void *core, u32 intr_type)
+{
+}
+
+static u32 sim_clear_intr(void *core)
+{
+	return 0;
+}
+
+static struct xcu_funcs sim_funcs = {
+	.alloc_credit	= sim_alloc_credit,
+	.free_credit	= sim_free_credit,
+	.peek_credit	= sim_peek_credit,
+	.configure	= sim_configure,
+	.start		= sim_start,
+	.check		= sim_check,
+	.reset		= sim_reset,
+	.reset_done	= sim_reset_done,
+	.enable_intr	= sim_enable_intr,
+	.disable_intr	= sim_disable_intr,
+	.clear_intr	= sim_clear_intr,
+};
+
+/* ERT stand-in, completes every command on submit */
+static void echo_ert_submit(struct kds_ert *ert, struct kds_command *xcmd)
+{
+	xcmd->cb.notify_host(xcmd, KDS_COMPLETED);
+	xcmd->cb.free(xcmd);
+}
+
+static struct kds_ert echo_ert = {
+	.submit = echo_ert_submit,
+};
+
+struct bench_config {
+	int	num_cus;
+	int	num_clients;
+	int	cus_per_client;
+	u64	num_cmds;
+	u32	window;
+	u32	regmap_words;
+	u64	latency_ns;
+	u64	jitter_ns;
+	int	depth;
+	bool	ert;
+	u32	noisy_window;
+	const char *policy;
+	bool	stat;
+};
+
+struct bench_client {
+	struct kds_client	 client;
+	struct device		 dev;
+	struct kds_sched	*kds;
+	const struct bench_config *cfg;
+	pthread_t		 thread;
+	int			 id;
+	u32			 window;
+	u32			 cu_mask[4];
+	u32			 num_mask;
+	pthread_mutex_t		 lock;
+	pthread_cond_t		 cond;
+	u64			 outstanding;
+	u64			 completed;
+	u64			 errors;
+	u64			*latency;
+	u64			 begin;
+	u64			 end;
+};
+
+static inline struct bench_client *to_bench_client(struct kds_client *client)
+{
+	return container_of(client, struct bench_client, client);
+}
+
+static void bench_notify_host(struct kds_command *xcmd, int status)
+{
+	struct bench_client *bc = to_bench_client(xcmd->client);
+	u64 lat = ktime_get_raw_fast_ns() - xcmd->start;
+
+	pthread_mutex_lock(&bc->lock);
+	if (status == KDS_COMPLETED)
+		bc->latency[bc->completed++] = lat;
+	else
+		++bc->errors;
+	--bc->outstanding;
+	pthread_cond_signal(&bc->cond);
+	pthread_mutex_unlock(&bc->lock);
+}
+
+static void bench_free(struct kds_command *xcmd)
+{
+	kds_free_command(xcmd);
+}
+
+static void *bench_client_thread(void *data)
+{
+	struct bench_client *bc = data;
+	const struct bench_config *cfg = bc->cfg;
+	size_t isize = cfg->regmap_words * sizeof(u32);
+	struct kds_command *xcmd;
+	u64 i;
+
+	bc->begin = ktime_get_raw_fast_ns();
+	for (i = 0; i < cfg->num_cmds; ++i) {
+		pthread_mutex_lock(&bc->lock);
+		while (bc->outstanding >= bc->window)
+			pthread_cond_wait(&bc->cond, &bc->lock);
+		++bc->outstanding;
+		pthread_mutex_unlock(&bc->lock);
+
+		xcmd = kds_alloc_command(&bc->client, isize);
+		if (!xcmd) {
+			pthread_mutex_lock(&bc->lock);
+			--bc->outstanding;
+			++bc->errors;
+			pthread_mutex_unlock(&bc->lock);
+			continue;
+		}
+
+		xcmd->type = cfg->ert ? KDS_ERT : KDS_CU;
+		xcmd->opcode = OP_START;
+		memcpy(xcmd->cu_mask, bc->cu_mask, sizeof(bc->cu_mask));
+		xcmd->num_mask = bc->num_mask;
+		xcmd->isize = isize;
+		xcmd->cb.notify_host = bench_notify_host;
+		xcmd->cb.free = bench_free;
+		xcmd->start = ktime_get_raw_fast_ns();
+
+		/* On error KDS notifies and frees the command */
+		(void) kds_add_command(bc->kds, xcmd);
+	}
+
+	pthread_mutex_lock(&bc->lock);
+	while (bc->outstanding)
+		pthread_cond_wait(&bc->cond, &bc->lock);
+	pthread_mutex_unlock(&bc->lock);
+	bc->end = ktime_get_raw_fast_ns();
+
+	return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	u64 x = *(const u64 *)a;
+	u64 y = *(const u64 *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Sorts samples in place */
+static void print_latency(const char *name, u64 *samples, u64 num)
+{
+	double avg = 0;
+	u64 i;
+
+	if (!num) {
+		printf("  %-16s no samples\n", name);
+		return;
+	}
+
+	qsort(samples, num, sizeof(u64), cmp_u64);
+	for (i = 0; i < num; ++i)
+		avg += samples[i];
+	avg /= num;
+
+	printf("  %-16s avg %.1f  p50 %.1f  p99 %.1f  max %.1f us\n", name,
+	       avg / 1000, samples[num / 2] / 1000.0,
+	       samples[(num * 99) / 100] / 1000.0, samples[num - 1] / 1000.0);
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [options]\n"
+	       "  --cus <n>             number of CUs (4)\n"
+	       "  --clients <n>         number of client threads (1)\n"
+	       "  --cus-per-client <n>  CUs in each client's CU mask, 0 for all (0)\n"
+	       "  --cmds <n>            commands per client (100000)\n"
+	       "  --window <n>          outstanding commands per client (128)\n"
+	       "  --noisy-window <n>    outstanding commands of client 0, 0 for --window (0)\n"
+	       "  --regmap <n>          register map words per command (16)\n"
+	       "  --latency <us>        CU execution time (0)\n"
+	       "  --jitter <us>         random extra CU time in [0,n) (0)\n"
+	       "  --depth <n>           CU hardware queue depth (1)\n"
+	       "  --ert                 submit to an echo ERT instead of CU threads\n"
+	       "  --policy <name>       KDS CU selection policy, as sysfs kds_policy\n"
+	       "  --stat                print KDS statistics, as sysfs kds_stat\n"
+	       "  --verbose             print KDS and CU info messages\n",
+	       prog);
+}
+
+static int to_number(const char *str, u64 *val)
+{
+	char *end;
+
+	errno = 0;
+	*val = strtoull(str, &end, 0);
+	if (errno || end == str || *end) {
+		fprintf(stderr, "kds_bench: bad number '%s'\n", str);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option long_options[] = {
+		{"cus",            required_argument, NULL, 'c'},
+		{"clients",        required_argument, NULL, 'n'},
+		{"cus-per-client", required_argument, NULL, 'p'},
+		{"cmds",           required_argument, NULL, 'm'},
+		{"window",         required_argument, NULL, 'w'},
+		{"regmap",         required_argument, NULL, 'r'},
+		{"latency",        required_argument, NULL, 'l'},
+		{"jitter",         required_argument, NULL, 'j'},
+		{"depth",          required_argument, NULL, 'd'},
+		{"ert",            no_argument,       NULL, 'e'},
+		{"noisy-window",   required_argument, NULL, 'N'},
+		{"policy",         required_argument, NULL, 'P'},
+		{"stat",           no_argument,       NULL, 's'},
+		{"verbose",        no_argument,       NULL, 'v'},
+		{"help",           no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+	struct bench_config cfg = {
+		.num_cus	= 4,
+		.num_clients	= 1,
+		.num_cmds	= 100000,
+		.window		= 128,
+		.regmap_words	= 16,
+		.depth		= 1,
+	};
+	struct kds_sched kds = { 0 };
+	struct xrt_cu *xcus;
+	struct sim_cu *cus;
+	struct bench_client *bcs;
+	struct kds_ctx_info info;
+	struct device dev = { .name = "kds_bench" };
+	static char stat_buf[PAGE_SIZE];
+	u64 *all_latency;
+	u64 total = 0, errors = 0, num_samples = 0;
+	u64 begin, end, val = 0;
+	double secs, sum = 0, sum_sq = 0;
+	int opt, i, j, ret = 0;
+
+	while ((opt = getopt_long(argc, argv, "hv", long_options, NULL)) != -1) {
+		if (opt == 'P') {
+			cfg.policy = optarg;
+			continue;
+		}
+		if (optarg && to_number(optarg, &val))
+			return 2;
+
+		switch (opt) {
+		case 'c': cfg.num_cus = val; break;
+		case 'n': cfg.num_clients = val; break;
+		case 'p': cfg.cus_per_client = val; break;
+		case 'm': cfg.num_cmds = val; break;
+		case 'w': cfg.window = val; break;
+		case 'r': cfg.regmap_words = val; break;
+		case 'l': cfg.latency_ns = val * 1000; break;
+		case 'j': cfg.jitter_ns = val * 1000; break;
+		case 'd': cfg.depth = val; break;
+		case 'e': cfg.ert = true; break;
+		case 'N': cfg.noisy_window = val; break;
+		case 's': cfg.stat = true; break;
+		case 'v': ++kds_compat_verbose; break;
+		case 'h': usage(argv[0]); return 0;
+		default: usage(argv[0]); return 2;
+		}
+	}
+
+	if (cfg.num_cus < 1 || cfg.num_cus > 4 * 32 || cfg.num_clients < 1 ||
+	    cfg.cus_per_client < 0 || cfg.cus_per_client > cfg.num_cus ||
+	    cfg.window < 1 || cfg.depth < 1 || cfg.regmap_words > 128) {
+		fprintf(stderr, "kds_bench: invalid configuration\n");
+		usage(argv[0]);
+		return 2;
+	}
+	if (!cfg.cus_per_client)
+		cfg.cus_per_client = cfg.num_cus;
+
+	xcus = calloc(cfg.num_cus, sizeof(*xcus));
+	cus = calloc(cfg.num_cus, sizeof(*cus));
+	bcs = calloc(cfg.num_clients, sizeof(*bcs));
+	all_latency = calloc(cfg.num_clients * cfg.num_cmds + 1, sizeof(u64));
+	if (!xcus || !cus || !bcs || !all_latency) {
+		fprintf(stderr, "kds_bench: out of memory\n");
+		return 2;
+	}
+
+	kds_init_sched(&kds);
+	if (cfg.ert)
+		kds_init_ert(&kds, &echo_ert);
+	if (cfg.policy &&
+	    store_kds_policy(&kds, cfg.policy, strlen(cfg.policy)) < 0) {
+		fprintf(stderr, "kds_bench: unknown policy '%s'\n", cfg.policy);
+		show_kds_policy(&kds, stat_buf);
+		fprintf(stderr, "policies: %s", stat_buf);
+		return 2;
+	}
+
+	for (i = 0; i < cfg.num_cus; ++i) {
+		cus[i].max_credits = cfg.depth;
+		cus[i].credits = cfg.depth;
+		cus[i].latency_ns = cfg.latency_ns;
+		cus[i].jitter_ns = cfg.jitter_ns;
+		cus[i].seed = i + 1;
+		cus[i].finish = calloc(cfg.depth, sizeof(u64));
+
+		xcus[i].dev = &dev;
+		xcus[i].core = &cus[i];
+		xcus[i].funcs = &sim_funcs;
+		xcus[i].info.model = XCU_HLS;
+		xcus[i].info.protocol = CTRL_CHAIN;
+		xcus[i].info.intr_id = i;
+		xcus[i].info.addr = 0x1800000 + ((u64)i << 16);
+		snprintf(xcus[i].info.kname, sizeof(xcus[i].info.kname), "bench");
+		snprintf(xcus[i].info.iname, sizeof(xcus[i].info.iname), "bench_%d", i);
+
+		/* ERT mode never runs commands on CU threads */
+		if (!cfg.ert && xrt_cu_init(&xcus[i])) {
+			fprintf(stderr, "kds_bench: CU %d init failed\n", i);
+			return 2;
+		}
+		if (kds_add_cu(&kds, &xcus[i])) {
+			fprintf(stderr, "kds_bench: add CU %d failed\n", i);
+			return 2;
+		}
+	}
+
+	for (i = 0; i < cfg.num_clients; ++i) {
+		struct bench_client *bc = &bcs[i];
+		int first = (i * cfg.cus_per_client) % cfg.num_cus;
+
+		bc->id = i;
+		bc->window = (i == 0 && cfg.noisy_window) ? cfg.noisy_window : cfg.window;
+		bc->kds = &kds;
+		bc->cfg = &cfg;
+		bc->dev.name = "kds_bench";
+		bc->client.dev = &bc->dev;
+		bc->latency = calloc(cfg.num_cmds + 1, sizeof(u64));
+		pthread_mutex_init(&bc->lock, NULL);
+		pthread_cond_init(&bc->cond, NULL);
+		kds_init_client(&kds, &bc->client);
+
+		/* CU mask and shared contexts on consecutive CUs */
+		mutex_lock(&bc->client.lock);
+		for (j = 0; j < cfg.cus_per_client; ++j) {
+			int cu = (first + j) % cfg.num_cus;
+
+			bc->cu_mask[cu / 32] |= 1U << (cu % 32);
+			info.cu_idx = cu;
+			info.flags = CU_CTX_SHARED;
+			if (kds_add_context(&kds, &bc->client, &info)) {
+				fprintf(stderr, "kds_bench: add context CU %d failed\n", cu);
+				return 2;
+			}
+		}
+		mutex_unlock(&bc->client.lock);
+		bc->num_mask = (cfg.num_cus + 31) / 32;
+	}
+
+	begin = ktime_get_raw_fast_ns();
+	for (i = 0; i < cfg.num_clients; ++i)
+		pthread_create(&bcs[i].thread, NULL, bench_client_thread, &bcs[i]);
+	for (i = 0; i < cfg.num_clients; ++i)
+		pthread_join(bcs[i].thread, NULL);
+	end = ktime_get_raw_fast_ns();
+	secs = (end - begin) / 1e9;
+
+	show_kds_policy(&kds, stat_buf);
+	printf("KDS %s: %d CUs, depth %d, latency %llu us, %d clients, %d CUs per client, window %u, policy %s",
+	       cfg.ert ? "ert" : "cu", cfg.num_cus, cfg.depth,
+	       (unsigned long long)(cfg.latency_ns / 1000), cfg.num_clients,
+	       cfg.cus_per_client, cfg.window, stat_buf);
+
+	for (i = 0; i < cfg.num_clients; ++i) {
+		struct bench_client *bc = &bcs[i];
+		double rate = bc->completed / ((bc->end - bc->begin) / 1e9);
+
+		total += bc->completed;
+		errors += bc->errors;
+		sum += rate;
+		sum_sq += rate * rate;
+		memcpy(all_latency + num_samples, bc->latency, bc->completed * sizeof(u64));
+		num_samples += bc->completed;
+	}
+
+	printf("  commands         %llu in %.3f s\n", (unsigned long long)total, secs);
+	printf("  throughput       %.1f K cmds/s\n", total / secs / 1000);
+	print_latency("latency", all_latency, num_samples);
+
+	printf("  CU usage        ");
+	for (i = 0; i < cfg.num_cus; ++i)
+		printf(" %llu", (unsigned long long)atomic64_read(&kds.cu_mgmt.cu_usage[i]));
+	printf("\n");
+	if (!cfg.ert) {
+		printf("  CU busy         ");
+		for (i = 0; i < cfg.num_cus; ++i)
+			printf(" %.1f%%", 100.0 * cus[i].busy_ns / (end - begin));
+		printf("\n");
+	}
+
+	for (i = 0; i < cfg.num_clients; ++i) {
+		struct bench_client *bc = &bcs[i];
+		char name[32];
+
+		printf("  client %-9d %.1f K cmds/s, window %u\n", i,
+		       bc->completed / ((bc->end - bc->begin) / 1e9) / 1000,
+		       bc->window);
+		snprintf(name, sizeof(name), "  latency");
+		print_latency(name, bc->latency, bc->completed);
+	}
+
+	/* Jain's index over client throughput, 1.0 is perfectly fair */
+	printf("  fairness         %.3f\n",
+	       sum_sq ? (sum * sum) / (cfg.num_clients * sum_sq) : 1.0);
+
+	if (errors) {
+		printf("error: %llu commands failed\n", (unsigned long long)errors);
+		ret = 1;
+	}
+
+	if (cfg.stat) {
+		show_kds_stat(&kds, stat_buf);
+		printf("%s", stat_buf);
+	}
+
+	for (i = 0; i < cfg.num_clients; ++i) {
+		kds_fini_client(&kds, &bcs[i].client);
+		free(bcs[i].latency);
+	}
+	for (i = 0; i < cfg.num_cus; ++i) {
+		kds_del_cu(&kds, &xcus[i]);
+		if (!cfg.ert)
+			xrt_cu_fini(&xcus[i]);
+		free(cus[i].finish);
+	}
+	kds_fini_sched(&kds);
+
+	free(all_latency);
+	free(bcs);
+	free(cus);
+	free(xcus);
+	return ret;
+}
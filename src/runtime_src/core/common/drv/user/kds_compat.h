@@ -0,0 +1,511 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Userspace compatibility layer for the shared KDS core
+ *
+ * Copyright (C) 2020 Xilinx, Inc.
+ *
+ * kds_core.c and xrt_cu.c are written against a small set of kernel
+ * primitives. This header maps them onto libc and pthreads so the
+ * unmodified scheduler sources can be built and exercised in user
+ * space. The linux/ directory next to this file shadows the kernel
+ * headers and includes this file.
+ *
+ * Only what the two sources use is provided, with the same semantics
+ * where it matters for scheduling:
+ *  - list_head is the kernel doubly linked list
+ *  - mutex and spinlock are pthread mutexes
+ *  - semaphore is a counting semaphore on a mutex and condition
+ *  - kthread_run/kthread_stop create and join a pthread
+ *  - bitops are atomic where the kernel versions are atomic
+ */
+
+#ifndef _KDS_COMPAT_H
+#define _KDS_COMPAT_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int32_t  s32;
+/* As in the kernel, so %llx and %llu formats match */
+typedef unsigned long long u64;
+typedef long long s64;
+
+#define __iomem
+#define __packed		__attribute__((packed))
+#define likely(x)		__builtin_expect(!!(x), 1)
+#define unlikely(x)		__builtin_expect(!!(x), 0)
+
+#define KERNEL_VERSION(a, b, c)	(((a) << 16) + ((b) << 8) + (c))
+#define LINUX_VERSION_CODE	KERNEL_VERSION(5, 4, 0)
+
+#define PAGE_SIZE		4096
+#define GFP_KERNEL		0
+#define ERESTARTSYS		512
+
+#define BUG_ON(cond)							\
+	do {								\
+		if (unlikely(cond)) {					\
+			fprintf(stderr, "BUG at %s:%d\n", __FILE__, __LINE__); \
+			abort();					\
+		}							\
+	} while (0)
+
+#define WARN_ON(cond)							\
+	({								\
+		int __ret_warn = !!(cond);				\
+		if (unlikely(__ret_warn))				\
+			fprintf(stderr, "WARNING at %s:%d\n", __FILE__, __LINE__); \
+		__ret_warn;						\
+	})
+
+#define container_of(ptr, type, member)					\
+	((type *)((char *)(ptr) - offsetof(type, member)))
+
+/* Logging, dev_info and dev_dbg are printed only when verbose */
+struct device {
+	const char *name;
+};
+
+extern int kds_compat_verbose;
+
+#define dev_info(dev, fmt, args...)					\
+	do {								\
+		if (kds_compat_verbose)					\
+			fprintf(stderr, fmt "\n", ##args);		\
+	} while (0)
+#define dev_dbg(dev, fmt, args...)					\
+	do {								\
+		if (kds_compat_verbose > 1)				\
+			fprintf(stderr, fmt "\n", ##args);		\
+	} while (0)
+#define dev_err(dev, fmt, args...)					\
+	fprintf(stderr, fmt "\n", ##args)
+
+static inline int
+scnprintf(char *buf, size_t size, const char *fmt, ...)
+{
+	va_list args;
+	int len;
+
+	if (!size)
+		return 0;
+
+	va_start(args, fmt);
+	len = vsnprintf(buf, size, fmt, args);
+	va_end(args);
+
+	if (len < 0)
+		return 0;
+	return ((size_t)len >= size) ? (int)(size - 1) : len;
+}
+
+static inline int
+kstrtou32(const char *s, unsigned int base, u32 *res)
+{
+	unsigned long val;
+	char *end;
+
+	errno = 0;
+	val = strtoul(s, &end, base);
+	if (errno || end == s || (*end && *end != '\n') || val > UINT32_MAX)
+		return -EINVAL;
+	*res = (u32)val;
+	return 0;
+}
+
+/* String equal, ignoring one trailing newline on either side */
+static inline bool
+sysfs_streq(const char *s1, const char *s2)
+{
+	while (*s1 && *s1 == *s2) {
+		s1++;
+		s2++;
+	}
+
+	if (*s1 == *s2)
+		return true;
+	if (!*s1 && *s2 == '\n' && !s2[1])
+		return true;
+	if (*s1 == '\n' && !s1[1] && !*s2)
+		return true;
+	return false;
+}
+
+/* Memory */
+static inline void *kzalloc(size_t size, int flags) { (void)flags; return calloc(1, size); }
+static inline void kfree(const void *p) { free((void *)p); }
+static inline void *vzalloc(size_t size) { return calloc(1, size); }
+static inline void *vmalloc(size_t size) { return malloc(size); }
+static inline void vfree(const void *p) { free((void *)p); }
+
+/* Math, as include/linux/math64.h and limits.h */
+#define U32_MAX				((u32)~0U)
+
+static inline u64 div_u64(u64 dividend, u32 divisor) { return dividend / divisor; }
+static inline u64 div64_u64(u64 dividend, u64 divisor) { return dividend / divisor; }
+
+/* Time */
+static inline void
+msleep(unsigned int msecs)
+{
+	usleep(msecs * 1000);
+}
+
+static inline u64
+ktime_get_raw_fast_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Doubly linked list, as include/linux/list.h */
+struct list_head {
+	struct list_head *next, *prev;
+};
+
+static inline void
+INIT_LIST_HEAD(struct list_head *list)
+{
+	list->next = list;
+	list->prev = list;
+}
+
+static inline void
+__list_add(struct list_head *entry, struct list_head *prev, struct list_head *next)
+{
+	next->prev = entry;
+	entry->next = next;
+	entry->prev = prev;
+	prev->next = entry;
+}
+
+static inline void
+list_add(struct list_head *entry, struct list_head *head)
+{
+	__list_add(entry, head, head->next);
+}
+
+static inline void
+list_add_tail(struct list_head *entry, struct list_head *head)
+{
+	__list_add(entry, head->prev, head);
+}
+
+static inline void
+__list_del_entry(struct list_head *entry)
+{
+	entry->next->prev = entry->prev;
+	entry->prev->next = entry->next;
+}
+
+static inline void
+list_del(struct list_head *entry)
+{
+	__list_del_entry(entry);
+	entry->next = NULL;
+	entry->prev = NULL;
+}
+
+static inline void
+list_move_tail(struct list_head *entry, struct list_head *head)
+{
+	__list_del_entry(entry);
+	list_add_tail(entry, head);
+}
+
+static inline int
+list_empty(const struct list_head *head)
+{
+	return head->next == head;
+}
+
+static inline void
+list_splice_tail_init(struct list_head *list, struct list_head *head)
+{
+	if (list_empty(list))
+		return;
+
+	list->next->prev = head->prev;
+	head->prev->next = list->next;
+	list->prev->next = head;
+	head->prev = list->prev;
+	INIT_LIST_HEAD(list);
+}
+
+#define LIST_HEAD(name) \
+	struct list_head name = { &(name), &(name) }
+
+#define list_entry(ptr, type, member)	container_of(ptr, type, member)
+#define list_first_entry(ptr, type, member) \
+	list_entry((ptr)->next, type, member)
+#define list_next_entry(pos, member) \
+	list_entry((pos)->member.next, __typeof__(*(pos)), member)
+
+#define list_for_each(pos, head) \
+	for (pos = (head)->next; pos != (head); pos = pos->next)
+
+#define list_for_each_entry(pos, head, member)				\
+	for (pos = list_first_entry(head, __typeof__(*pos), member);	\
+	     &pos->member != (head);					\
+	     pos = list_next_entry(pos, member))
+
+#define list_for_each_entry_safe(pos, n, head, member)			\
+	for (pos = list_first_entry(head, __typeof__(*pos), member),	\
+	     n = list_next_entry(pos, member);				\
+	     &pos->member != (head);					\
+	     pos = n, n = list_next_entry(n, member))
+
+/* Mutex. The owner flag only backs mutex_is_locked() assertions */
+struct mutex {
+	pthread_mutex_t	m;
+	int		locked;
+};
+
+static inline void
+mutex_init(struct mutex *lock)
+{
+	pthread_mutex_init(&lock->m, NULL);
+	lock->locked = 0;
+}
+
+static inline void
+mutex_destroy(struct mutex *lock)
+{
+	pthread_mutex_destroy(&lock->m);
+}
+
+static inline void
+mutex_lock(struct mutex *lock)
+{
+	pthread_mutex_lock(&lock->m);
+	lock->locked = 1;
+}
+
+static inline void
+mutex_unlock(struct mutex *lock)
+{
+	lock->locked = 0;
+	pthread_mutex_unlock(&lock->m);
+}
+
+static inline int
+mutex_is_locked(struct mutex *lock)
+{
+	return __atomic_load_n(&lock->locked, __ATOMIC_RELAXED);
+}
+
+/*
+ * Spinlock. A user space spinlock burns the time slice of a preempted
+ * holder, so a mutex is the closer model of a kernel spinlock with
+ * interrupts disabled.
+ */
+typedef pthread_mutex_t spinlock_t;
+
+#define spin_lock_init(lock)		pthread_mutex_init(lock, NULL)
+#define spin_lock(lock)			pthread_mutex_lock(lock)
+#define spin_unlock(lock)		pthread_mutex_unlock(lock)
+#define spin_lock_irqsave(lock, flags)					\
+	do { (void)(flags); pthread_mutex_lock(lock); } while (0)
+#define spin_unlock_irqrestore(lock, flags)				\
+	do { (void)(flags); pthread_mutex_unlock(lock); } while (0)
+
+/* Counting semaphore */
+struct semaphore {
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	unsigned int	count;
+};
+
+static inline void
+sema_init(struct semaphore *sem, int val)
+{
+	pthread_mutex_init(&sem->lock, NULL);
+	pthread_cond_init(&sem->cond, NULL);
+	sem->count = val;
+}
+
+static inline void
+up(struct semaphore *sem)
+{
+	pthread_mutex_lock(&sem->lock);
+	++sem->count;
+	pthread_cond_signal(&sem->cond);
+	pthread_mutex_unlock(&sem->lock);
+}
+
+static inline int
+down_interruptible(struct semaphore *sem)
+{
+	pthread_mutex_lock(&sem->lock);
+	while (!sem->count)
+		pthread_cond_wait(&sem->cond, &sem->lock);
+	--sem->count;
+	pthread_mutex_unlock(&sem->lock);
+	return 0;
+}
+
+/* Error pointers */
+#define MAX_ERRNO	4095
+
+static inline void *ERR_PTR(long error) { return (void *)error; }
+static inline long PTR_ERR(const void *ptr) { return (long)ptr; }
+static inline bool IS_ERR(const void *ptr)
+{
+	return (unsigned long)ptr >= (unsigned long)-MAX_ERRNO;
+}
+
+/* Kernel threads on pthreads */
+struct task_struct {
+	pthread_t	thread;
+	int		(*fn)(void *data);
+	void		*data;
+	int		ret;
+};
+
+static inline void *
+__kthread_entry(void *arg)
+{
+	struct task_struct *task = arg;
+
+	task->ret = task->fn(task->data);
+	return NULL;
+}
+
+static inline struct task_struct *
+__kthread_run(int (*fn)(void *data), void *data)
+{
+	struct task_struct *task = calloc(1, sizeof(*task));
+
+	if (!task)
+		return ERR_PTR(-ENOMEM);
+
+	task->fn = fn;
+	task->data = data;
+	if (pthread_create(&task->thread, NULL, __kthread_entry, task)) {
+		free(task);
+		return ERR_PTR(-EAGAIN);
+	}
+	return task;
+}
+
+#define kthread_run(fn, data, namefmt, args...)	__kthread_run(fn, data)
+
+/* The thread function must observe its own stop flag, as in xrt_cu.c */
+static inline int
+kthread_stop(struct task_struct *task)
+{
+	int ret;
+
+	pthread_join(task->thread, NULL);
+	ret = task->ret;
+	free(task);
+	return ret;
+}
+
+/* Process identity, a client is identified by the process pid */
+struct pid;
+
+#define current				((struct task_struct *)NULL)
+#define task_pid(task)			((struct pid *)(uintptr_t)getpid())
+#define get_pid(pid)			(pid)
+#define put_pid(pid)			((void)(pid))
+#define pid_nr(pid)			((pid_t)(uintptr_t)(pid))
+#define task_nice(task)			((void)(task), 0)
+
+/* Client notification is done by the harness, not through these */
+typedef struct { int unused; } wait_queue_head_t;
+typedef struct { int counter; } atomic_t;
+struct work_struct { int unused; };
+struct resource { int unused; };
+
+#define init_waitqueue_head(wq)		((void)(wq))
+#define atomic_set(v, i)		__atomic_store_n(&(v)->counter, (i), __ATOMIC_SEQ_CST)
+#define atomic_read(v)			__atomic_load_n(&(v)->counter, __ATOMIC_SEQ_CST)
+#define atomic_add(i, v)		((void)__atomic_add_fetch(&(v)->counter, (i), __ATOMIC_SEQ_CST))
+#define atomic_sub(i, v)		((void)__atomic_sub_fetch(&(v)->counter, (i), __ATOMIC_SEQ_CST))
+#define atomic_inc(v)			atomic_add(1, v)
+#define atomic_dec(v)			atomic_sub(1, v)
+
+typedef struct { long long counter; } atomic64_t;
+
+#define atomic64_set(v, i)		__atomic_store_n(&(v)->counter, (i), __ATOMIC_SEQ_CST)
+#define atomic64_read(v)		__atomic_load_n(&(v)->counter, __ATOMIC_SEQ_CST)
+#define atomic64_inc(v)			((void)__atomic_add_fetch(&(v)->counter, 1, __ATOMIC_SEQ_CST))
+
+#define READ_ONCE(x)			__atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define WRITE_ONCE(x, val)		__atomic_store_n(&(x), (val), __ATOMIC_RELAXED)
+
+/* Bitmaps */
+#define BITS_PER_LONG			(8 * sizeof(unsigned long))
+#define BITS_TO_LONGS(nr)		(((nr) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+#define BIT_MASK(nr)			(1UL << ((nr) % BITS_PER_LONG))
+#define BIT_WORD(nr)			((nr) / BITS_PER_LONG)
+#define DECLARE_BITMAP(name, bits)	unsigned long name[BITS_TO_LONGS(bits)]
+
+static inline int
+test_bit(unsigned long nr, const unsigned long *addr)
+{
+	return (__atomic_load_n(&addr[BIT_WORD(nr)], __ATOMIC_RELAXED) & BIT_MASK(nr)) != 0;
+}
+
+static inline void
+set_bit(unsigned long nr, unsigned long *addr)
+{
+	__atomic_fetch_or(&addr[BIT_WORD(nr)], BIT_MASK(nr), __ATOMIC_SEQ_CST);
+}
+
+static inline void
+clear_bit(unsigned long nr, unsigned long *addr)
+{
+	__atomic_fetch_and(&addr[BIT_WORD(nr)], ~BIT_MASK(nr), __ATOMIC_SEQ_CST);
+}
+
+static inline int
+test_and_set_bit(unsigned long nr, unsigned long *addr)
+{
+	return (__atomic_fetch_or(&addr[BIT_WORD(nr)], BIT_MASK(nr), __ATOMIC_SEQ_CST) & BIT_MASK(nr)) != 0;
+}
+
+static inline int
+test_and_clear_bit(unsigned long nr, unsigned long *addr)
+{
+	return (__atomic_fetch_and(&addr[BIT_WORD(nr)], ~BIT_MASK(nr), __ATOMIC_SEQ_CST) & BIT_MASK(nr)) != 0;
+}
+
+static inline unsigned long
+find_next_bit(const unsigned long *addr, unsigned long size, unsigned long offset)
+{
+	for (; offset < size; ++offset)
+		if (test_bit(offset, addr))
+			return offset;
+	return size;
+}
+
+static inline unsigned long
+find_first_bit(const unsigned long *addr, unsigned long size)
+{
+	return find_next_bit(addr, size, 0);
+}
+
+static inline void
+bitmap_zero(unsigned long *dst, unsigned int nbits)
+{
+	memset(dst, 0, BITS_TO_LONGS(nbits) * sizeof(unsigned long));
+}
+
+#endif
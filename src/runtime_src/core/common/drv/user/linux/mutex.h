@@ -0,0 +1,3 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/* User space stand-in for <linux/mutex.h>, see kds_compat.h */
+#include "../kds_compat.h"
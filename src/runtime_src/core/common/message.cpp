@@ -20,9 +20,17 @@
 #include "gen/version.h"
 #include "config_reader.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
 #include <map>
+#include <memory>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <thread>
 #include <mutex>
 #include <climits>
@@ -87,6 +95,44 @@ get_exe_path()
 
 using severity_level = xrt_core::message::severity_level;
 
+static bool
+is_compact()
+{
+  static bool compact = xrt_core::config::get_logging_format() == "compact";
+  return compact;
+}
+
+// Seconds since first message, compact format timestamp
+static double
+compact_time(std::chrono::system_clock::time_point time)
+{
+  static auto zero = time;
+  return std::chrono::duration<double>(time - zero).count();
+}
+
+static const char*
+compact_level(severity_level l)
+{
+  static const char* levels[] = { "M", "A", "C", "E", "W", "N", "I", "D" };
+  auto idx = static_cast<size_t>(l);
+  return idx < sizeof(levels)/sizeof(levels[0]) ? levels[idx] : "?";
+}
+
+/**
+ * struct log_record - A message with its time and sending thread
+ *
+ * Messages are written by the sending thread, or from a log_ring
+ * by the async_dispatch flusher thread.
+ */
+struct log_record
+{
+  severity_level level;
+  std::chrono::system_clock::time_point time;
+  std::thread::id tid;
+  const char* tag;
+  const char* msg;
+};
+
 //--
 class message_dispatch
 {
@@ -96,6 +142,10 @@ public:
   static message_dispatch* make_dispatcher(const std::string& choice);
 public:
   virtual void send(severity_level l, const char* tag, const char* msg) = 0;
+
+  // Write a record, flush() is called after a batch of records
+  virtual void write(const log_record& r) { send(r.level, r.tag, r.msg); }
+  virtual void flush() {}
 };
 
 //--
@@ -114,6 +164,7 @@ public:
   console_dispatch();
   virtual ~console_dispatch() {}
   virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void write(const log_record& r) override;
 private:
   std::map<severity_level, const char*> severityMap = {
     { severity_level::XRT_EMERGENCY, "EMERGENCY: "},
@@ -163,6 +214,8 @@ public:
   file_dispatch(const std::string& file);
   virtual ~file_dispatch();
   virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void write(const log_record& r) override;
+  virtual void flush() override { handle.flush(); }
 private:
   std::ofstream handle;
   std::map<severity_level, const char*> severityMap = {
@@ -231,9 +284,22 @@ send(severity_level l, const char* tag, const char* msg)
 {
   static std::mutex mutex;
   std::lock_guard<std::mutex> lk(mutex);
-  handle << "[" << xrt_core::timestamp() <<"] [" << tag << "] Tid: "
-         << std::this_thread::get_id() << ", " << " " << severityMap[l]
-         << msg << std::endl;
+  write({l, std::chrono::system_clock::now(), std::this_thread::get_id(), tag, msg});
+  handle.flush();
+}
+
+// Caller serializes
+void
+file_dispatch::
+write(const log_record& r)
+{
+  if (is_compact())
+    handle << compact_time(r.time) << " " << r.tid << " " << compact_level(r.level)
+           << " [" << r.tag << "] " << r.msg << "\n";
+  else
+    handle << "[" << xrt_core::timestamp(r.time) <<"] [" << r.tag << "] Tid: "
+           << r.tid << ", " << " " << severityMap[r.level]
+           << r.msg << "\n";
 }
 
 //console ops
@@ -257,25 +323,360 @@ send(severity_level l, const char* tag, const char* msg)
 {
   static std::mutex mutex;
   std::lock_guard<std::mutex> lk(mutex);
+  if (is_compact()) {
+    write({l, std::chrono::system_clock::now(), std::this_thread::get_id(), tag, msg});
+    return;
+  }
   std::cerr << "[" << tag << "] " << severityMap[l]
             << msg << std::endl;
 }
 
+// Caller serializes.  One write per line, std::cerr is unbuffered
+void
+console_dispatch::
+write(const log_record& r)
+{
+  std::ostringstream line;
+  if (is_compact())
+    line << compact_time(r.time) << " " << r.tid << " " << compact_level(r.level)
+         << " [" << r.tag << "] " << r.msg << "\n";
+  else
+    line << "[" << r.tag << "] " << severityMap[r.level] << r.msg << "\n";
+  auto str = line.str();
+  std::cerr.write(str.data(), str.size());
+}
+
+/**
+ * class log_ring - Bounded lock-free multi producer ring of messages
+ *
+ * Producers claim a slot by advancing the tail and publish it by
+ * setting the slot sequence number, a single consumer drains
+ * published slots in order.  Producers never wait, push() fails
+ * when the ring is full or the message does not fit a slot.
+ */
+class log_ring
+{
+public:
+  static constexpr size_t tag_size = 32;
+  static constexpr size_t msg_size = 472;
+
+private:
+
+  struct slot
+  {
+    std::atomic<size_t> seq {0};
+    severity_level level = severity_level::XRT_DEBUG;
+    std::chrono::system_clock::time_point time;
+    std::thread::id tid;
+    char tag[tag_size];
+    char msg[msg_size];
+  };
+
+  std::unique_ptr<slot[]> m_slots;
+  size_t m_mask;
+  std::atomic<size_t> m_tail {0};
+  size_t m_head = 0;  // consumer only
+
+public:
+  // @size: power of 2
+  explicit
+  log_ring(size_t size)
+    : m_slots(new slot[size]), m_mask(size - 1)
+  {
+    for (size_t i = 0; i < size; ++i)
+      m_slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  size_t
+  size() const
+  {
+    return m_mask + 1;
+  }
+
+  // @return position of pushed message, or false
+  bool
+  push(severity_level l, const char* tag, const char* msg, size_t& pos)
+  {
+    auto msg_len = std::strlen(msg);
+    if (msg_len >= msg_size)
+      return false;
+
+    pos = m_tail.load(std::memory_order_relaxed);
+    slot* s = nullptr;
+    while (true) {
+      s = &m_slots[pos & m_mask];
+      auto seq = s->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+        return false; // full
+      else
+        pos = m_tail.load(std::memory_order_relaxed);
+    }
+
+    s->level = l;
+    s->time = std::chrono::system_clock::now();
+    s->tid = std::this_thread::get_id();
+    std::strncpy(s->tag, tag, tag_size - 1);
+    s->tag[tag_size - 1] = 0;
+    std::memcpy(s->msg, msg, msg_len + 1);
+    s->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consume all published messages, caller serializes
+  template <typename Function>
+  size_t
+  drain(Function fcn)
+  {
+    size_t count = 0;
+    while (true) {
+      auto& s = m_slots[m_head & m_mask];
+      if (s.seq.load(std::memory_order_acquire) != m_head + 1)
+        break;
+      fcn(log_record{s.level, s.time, s.tid, s.tag, s.msg});
+      s.seq.store(m_head + m_mask + 1, std::memory_order_release);
+      ++m_head;
+      ++count;
+    }
+    return count;
+  }
+};
+
+/**
+ * class async_dispatch - Write messages from a background thread
+ *
+ * Notice, info, and debug messages are queued in a log_ring and
+ * written in batches by a flusher thread, the sender only copies the
+ * message.  If the ring is full such messages are dropped and the
+ * number of dropped messages is reported.  Warnings and worse,
+ * messages too long for the ring, and messages sent after process
+ * exit has started are written by the sender after pending messages.
+ */
+class async_dispatch : public message_dispatch
+{
+  std::unique_ptr<message_dispatch> m_sink;
+  log_ring m_ring;
+  std::mutex m_drain_mutex;    // single consumer of ring and writer of sink
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  bool m_stop = false;
+  std::atomic<bool> m_sync {false};
+  std::atomic<unsigned long> m_dropped {0};
+  std::thread m_flusher;
+
+  // Caller holds m_drain_mutex
+  void
+  drain()
+  {
+    auto count = m_ring.drain([this](const log_record& r) { m_sink->write(r); });
+    if (auto dropped = m_dropped.exchange(0)) {
+      auto msg = std::to_string(dropped) + " messages dropped, runtime_log ring is full";
+      m_sink->write({severity_level::XRT_WARNING, std::chrono::system_clock::now(),
+                     std::this_thread::get_id(), "XRT", msg.c_str()});
+      ++count;
+    }
+    if (count)
+      m_sink->flush();
+  }
+
+  void
+  flusher()
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    while (!m_stop) {
+      m_work.wait_for(lk, std::chrono::milliseconds(20));
+      lk.unlock();
+      {
+        std::lock_guard<std::mutex> dlk(m_drain_mutex);
+        drain();
+      }
+      lk.lock();
+    }
+  }
+
+  void
+  send_sync(severity_level l, const char* tag, const char* msg)
+  {
+    std::lock_guard<std::mutex> lk(m_drain_mutex);
+    drain();
+    m_sink->write({l, std::chrono::system_clock::now(), std::this_thread::get_id(), tag, msg});
+    m_sink->flush();
+  }
+
+public:
+  explicit
+  async_dispatch(message_dispatch* sink)
+    : m_sink(sink), m_ring(4096)
+  {
+    m_flusher = std::thread([this] { flusher(); });
+  }
+
+  virtual ~async_dispatch()
+  {
+    shutdown();
+  }
+
+  // Stop flusher and write pending messages, later messages are
+  // written by the sender
+  void
+  shutdown()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      if (m_stop)
+        return;
+      m_stop = true;
+      m_sync = true;
+    }
+    m_work.notify_one();
+    if (m_flusher.joinable())
+      m_flusher.join();
+    std::lock_guard<std::mutex> dlk(m_drain_mutex);
+    drain();
+  }
+
+  virtual void
+  send(severity_level l, const char* tag, const char* msg) override
+  {
+    if (l <= severity_level::XRT_WARNING || m_sync) {
+      send_sync(l, tag, msg);
+      return;
+    }
+
+    size_t pos = 0;
+    if (!m_ring.push(l, tag, msg, pos)) {
+      if (std::strlen(msg) >= log_ring::msg_size)
+        send_sync(l, tag, msg);    // too long for ring
+      else
+        ++m_dropped;
+      return;
+    }
+
+    // Wake flusher early when a quarter of the ring is used
+    if ((pos & (m_ring.size() / 4 - 1)) == 0)
+      m_work.notify_one();
+  }
+};
+
+static async_dispatch* s_async = nullptr;
+
+static void
+shutdown_async()
+{
+  if (s_async)
+    s_async->shutdown();
+}
+
+/**
+ * class rate_limiter - Limit messages per second per tag
+ *
+ * Tags hash to a fixed number of buckets, each counting messages in
+ * the current second.  Tags sharing a bucket share the limit.
+ */
+class rate_limiter
+{
+  struct bucket
+  {
+    std::atomic<uint64_t> second {0};
+    std::atomic<unsigned int> count {0};
+    std::atomic<unsigned int> suppressed {0};
+  };
+
+  std::array<bucket, 64> m_buckets;
+  unsigned int m_limit;
+
+  static size_t
+  hash(const char* tag)
+  {
+    size_t h = 5381;
+    for (; *tag; ++tag)
+      h = h * 33 + static_cast<unsigned char>(*tag);
+    return h;
+  }
+
+public:
+  explicit
+  rate_limiter(unsigned int limit)
+    : m_limit(limit)
+  {}
+
+  /**
+   * allow() - Account a message
+   *
+   * @tag:        Message tag
+   * @suppressed: Set to number of messages suppressed in a previous
+   *              second of this bucket, when a new second starts
+   * Return:      true if message is within limit
+   */
+  bool
+  allow(const char* tag, unsigned int& suppressed)
+  {
+    auto& b = m_buckets[hash(tag) % m_buckets.size()];
+    auto now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>
+                                     (std::chrono::steady_clock::now().time_since_epoch()).count());
+    auto second = b.second.load(std::memory_order_relaxed);
+    suppressed = 0;
+    if (second != now && b.second.compare_exchange_strong(second, now)) {
+      b.count = 0;
+      suppressed = b.suppressed.exchange(0);
+    }
+
+    if (b.count.fetch_add(1, std::memory_order_relaxed) < m_limit)
+      return true;
+
+    ++b.suppressed;
+    return false;
+  }
+};
+
 } //end unnamed namespace
 
 namespace xrt_core { namespace message {
 
+static message_dispatch*
+get_dispatcher()
+{
+  static const std::string logger =  xrt_core::config::get_logging();
+  auto sink = message_dispatch::make_dispatcher(logger);
+
+#ifndef _WIN32
+  // Not on windows where exit handlers of a dll cannot join threads
+  if (xrt_core::config::get_logging_async() && !dynamic_cast<null_dispatch*>(sink)) {
+    s_async = new async_dispatch(sink);
+    std::atexit(shutdown_async);
+    return s_async;
+  }
+#endif
+
+  return sink;
+}
+
 void
 send(severity_level l, const char* tag, const char* msg)
 {
-  static const std::string logger =  xrt_core::config::get_logging();
-  int ver = xrt_core::config::get_verbosity();
-  int lev = static_cast<int>(l);
+  if (!enabled(l))
+    return;
 
-  if(ver >= lev) {
-    static message_dispatch* dispatcher = message_dispatch::make_dispatcher(logger);
-    dispatcher->send(l, tag, msg);
+  static message_dispatch* dispatcher = get_dispatcher();
+
+  static unsigned int limit = xrt_core::config::get_logging_rate_limit();
+  if (limit && l >= severity_level::XRT_NOTICE) {
+    static rate_limiter limiter(limit);
+    unsigned int suppressed = 0;
+    auto allow = limiter.allow(tag, suppressed);
+    if (suppressed) {
+      auto note = std::to_string(suppressed) + " messages suppressed by runtime_log_rate_limit";
+      dispatcher->send(l, tag, note.c_str());
+    }
+    if (!allow)
+      return;
   }
+
+  dispatcher->send(l, tag, msg);
 }
   
 }} // message,xrt
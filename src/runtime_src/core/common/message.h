@@ -38,6 +38,19 @@ enum class severity_level : unsigned short
 };
 
 
+/**
+ * enabled() - Check if a message of specified level would be logged
+ *
+ * Use before formatting a message that is expensive to construct.
+ */
+inline bool
+enabled(severity_level l)
+{
+  static const bool null_logger =
+    xrt_core::config::get_logging() == "null" || xrt_core::config::get_logging().empty();
+  return !null_logger && xrt_core::config::get_verbosity() >= static_cast<unsigned int>(l);
+}
+
 XRT_CORE_COMMON_EXPORT
 void
 send(severity_level l, const char* tag, const char* msg);
@@ -52,10 +65,7 @@ template <typename ...Args>
 void
 send(severity_level l, const char* tag, const char* format, Args ... args)
 {
-  int ver = xrt_core::config::get_verbosity();
-  int lev = static_cast<int>(l);
-
-  if (ver >= lev) {
+  if (enabled(l)) {
     auto sz = snprintf(nullptr, 0, format, args ...);
     if (sz < 0) {
       send(severity_level::XRT_ERROR, tag, "Illegal arguments in log format string");
@@ -63,7 +73,7 @@ send(severity_level l, const char* tag, const char* format, Args ... args)
     }
     
     std::vector<char> buf(sz+1);
-    snprintf(buf.data(), sz, format, args ...);
+    snprintf(buf.data(), sz+1, format, args ...);
     send(l, tag, buf.data());
   }
 }
@@ -117,6 +117,33 @@ create_data_bo(xclDeviceHandle handle, size_t sz, uint32_t flags)
   return buffer(ubo.release(), delBO);
 }
 
+/**
+ * get_cu_policy() - KDS CU selection policy for configure command
+ *
+ * Return: Policy index + 1 per enum kds_cu_policy, or 0 to keep
+ *  the driver setting
+ */
+static unsigned int
+get_cu_policy()
+{
+  // Order of enum kds_cu_policy in kds_core.h
+  static const char* names[] = {
+    "least_used", "least_outstanding", "power_of_two", "fair_share"
+  };
+
+  auto policy = xrt_core::config::get_kds_cu_policy();
+  if (policy.empty())
+    return 0;
+
+  for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+    if (policy == names[i])
+      return i + 1;
+
+  xrt_core::message::send(xrt_core::message::severity_level::XRT_WARNING, "XRT",
+                          "Ignoring unknown Runtime.kds_cu_policy '" + policy + "'");
+  return 0;
+}
+
 } // unnamed
 
 namespace xrt_core { namespace scheduler {
@@ -154,6 +181,7 @@ init(xclDeviceHandle handle, const axlf* top)
   ecmd->cq_int  = xrt_core::config::get_ert_cqint();
   ecmd->dataflow = xclbin::get_dataflow(top) || xrt_core::config::get_feature_toggle("Runtime.dataflow");
   ecmd->rw_shared = xrt_core::config::get_rw_shared();
+  ecmd->cu_policy = get_cu_policy();
 
   // cu addr map
   std::copy(cus.begin(), cus.end(), ecmd->data);
@@ -18,6 +18,7 @@
 #define xrtcore_util_time_h_
 
 #include "core/common/config.h"
+#include <chrono>
 #include <string>
 
 namespace xrt_core {
@@ -37,6 +38,13 @@ XRT_CORE_COMMON_EXPORT
 std::string
 timestamp();
 
+/**
+ * @return formatted timestamp of specified time
+ */
+XRT_CORE_COMMON_EXPORT
+std::string
+timestamp(std::chrono::system_clock::time_point time);
+
 /**
  * Simple time guard to accumulate scoped time
  */
@@ -51,9 +51,28 @@ kds_stat_show(struct device *dev, struct device_attribute *attr, char *buf)
 }
 static DEVICE_ATTR_RO(kds_stat);
 
+static ssize_t
+kds_policy_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	return show_kds_policy(&zdev->kds, buf);
+}
+
+static ssize_t
+kds_policy_store(struct device *dev, struct device_attribute *da,
+		 const char *buf, size_t count)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	return store_kds_policy(&zdev->kds, buf, count);
+}
+static DEVICE_ATTR(kds_policy, 0644, kds_policy_show, kds_policy_store);
+
 static struct attribute *kds_attrs[] = {
 	&dev_attr_kds_echo.attr,
 	&dev_attr_kds_stat.attr,
+	&dev_attr_kds_policy.attr,
 	NULL,
 };
 
@@ -15,6 +15,8 @@
  */
 #include "device_swemu.h"
 #include "core/common/query_requests.h"
+#include "core/common/uuid.h"
+#include "shim.h"
 
 #include <string>
 #include <map>
@@ -28,9 +30,41 @@ using qtype = std::underlying_type<query::key_type>::type;
 
 static std::map<query::key_type, std::unique_ptr<query::request>> query_tbl;
 
+// uuid of the xclbin run by the device process, null uuid if none
+struct xclbinUuid
+{
+  static std::string
+    get(const xrt_core::device* device, key_type)
+  {
+    xclcpuemhal2::CpuemShim *drv = xclcpuemhal2::CpuemShim::handleCheck(device->get_device_handle());
+    auto uuid = drv ? drv->getXclbinUuid() : std::string();
+    return uuid.empty() ? xrt_core::uuid().to_string() : uuid;
+  }
+};
+
+template <typename QueryRequestType, typename Getter>
+struct function0_get : virtual QueryRequestType
+{
+  boost::any
+    get(const xrt_core::device* device) const
+  {
+    auto k = QueryRequestType::key;
+    return Getter::get(device, k);
+  }
+};
+
+template <typename QueryRequestType, typename Getter>
+static void
+emplace_func0_request()
+{
+  auto k = QueryRequestType::key;
+  query_tbl.emplace(k, std::make_unique<function0_get<QueryRequestType, Getter>>());
+}
+
 static void
 initialize_query_table()
 {
+  emplace_func0_request<query::xclbin_uuid, xclbinUuid>();
 }
 
 struct X { X() { initialize_query_table(); }};
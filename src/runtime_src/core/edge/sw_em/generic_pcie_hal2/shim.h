@@ -165,9 +165,14 @@ namespace xclcpuemhal2 {
       }
       struct exec_core* getExecCore() { return mCore; }
       SWScheduler* getScheduler() { return mSWSch; }
+
+      // uuid of the xclbin run by the device process, null uuid if none
+      std::string getXclbinUuid() const { return mXclbinUuid; }
+      void setXclbinUuid(const std::string& uuid) { mXclbinUuid = uuid; }
     private:
       std::shared_ptr<xrt_core::device> mCoreDevice;
       std::mutex mMemManagerMutex;
+      std::string mXclbinUuid;
 
       // Performance monitoring helper functions
       bool isDSAVersion(double checkVersion, bool onlyThisVersion);
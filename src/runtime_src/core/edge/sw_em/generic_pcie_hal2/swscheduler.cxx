@@ -742,18 +742,32 @@ namespace xclcpuemhal2 {
   void SWScheduler::mark_cmd_complete(xocl_cmd *xcmd)
   {
     PRINTSTARTFUNC
+    xcmd->complete_time = std::chrono::steady_clock::now();
+    auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(xcmd->complete_time - xcmd->submit_time);
+    {
+      std::lock_guard<std::mutex> lk(cmd_latency_mutex);
+      cmd_latency.count++;
+      cmd_latency.total += latency;
+      cmd_latency.max = std::max(cmd_latency.max, latency);
+    }
     xcmd->exec->submitted_cmds[xcmd->slot_idx] = nullptr;
     set_cmd_state(xcmd,ERT_CMD_STATE_COMPLETED);
     if (xcmd->exec->polling_mode)
       mScheduler->poll--;
     release_slot_idx(xcmd->exec,xcmd->slot_idx);
 #ifdef EM_DEBUG_KDS
-    std::cout<<"Marking command Complete XCMD: " <<xcmd<<" PACKET: "<<xcmd->packet<< " BO: "<< xcmd->bo << std::endl;
+    std::cout<<"Marking command Complete XCMD: " <<xcmd<<" PACKET: "<<xcmd->packet<< " BO: "<< xcmd->bo << " LATENCY: "<< latency.count() << "ns" << std::endl;
     std::cout<<"Releasing slot " << xcmd->slot_idx << std::endl<<std::endl;
 #endif
     notify_host(xcmd);
   }
 
+  cmd_latency_stats SWScheduler::get_cmd_latency()
+  {
+    std::lock_guard<std::mutex> lk(cmd_latency_mutex);
+    return cmd_latency;
+  }
+
   void SWScheduler::mark_mask_complete(exec_core *exec, uint32_t mask, unsigned int mask_idx)
   {
     PRINTSTARTFUNC
@@ -919,6 +933,7 @@ namespace xclcpuemhal2 {
     xcmd->exec=exec;
     xcmd->cu_idx=-1;
     xcmd->slot_idx=-1;
+    xcmd->submit_time = std::chrono::steady_clock::now();
     int ret = convert_execbuf(exec, bo , xcmd);
 #ifdef EM_DEBUG_KDS
     std::cout<<"adding a command CMD: " <<xcmd<<" PACKET: "<<xcmd->packet<< " BO: "<< xcmd->bo <<" BASE: "<<xcmd->bo->base<< std::endl;
@@ -1030,7 +1045,6 @@ namespace xclcpuemhal2 {
   {
     //PRINTSTARTFUNC
     SWScheduler* pSch = xs->pSch;
-    std::lock_guard<std::mutex> lk(pSch->pending_cmds_mutex);
 
     if (xs->error) { return; }
 
@@ -1045,10 +1059,21 @@ namespace xclcpuemhal2 {
   {
     PRINTSTARTFUNC
     xocl_sched *xs = (xocl_sched *)data;
+    SWScheduler* pSch = xs->pSch;
+    auto wakeup = [xs, pSch] { return pSch->num_pending > 0 || xs->stop || xs->error; };
+
+    std::unique_lock<std::mutex> lk(pSch->pending_cmds_mutex);
     while (!xs->stop && !xs->error)
     {
       scheduler_loop(xs);
-      usleep(10);
+
+      /* Sleep until a command is submitted when no command is in flight.
+       * Completion of running commands is found by reading CU status, so
+       * keep polling those, but wake up at once on a new submit. */
+      if (xs->command_queue.empty())
+        xs->state_cond.wait(lk, wakeup);
+      else
+        xs->state_cond.wait_for(lk, std::chrono::microseconds(10), wakeup);
     }
     return nullptr;
   }
@@ -1087,8 +1112,11 @@ namespace xclcpuemhal2 {
     std::cout<<"SWScheduler Thread ended "<< std::endl;
 #endif
 
-    mScheduler->stop= true;
-    scheduler_wait_condition();
+    {
+      std::lock_guard<std::mutex> lk(pending_cmds_mutex);
+      mScheduler->stop= true;
+      scheduler_wait_condition();
+    }
     mScheduler->bThreadCreated = false;
     
     //int retval = pthread_join(mScheduler->scheduler_thread,nullptr);
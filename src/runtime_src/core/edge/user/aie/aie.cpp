@@ -17,6 +17,7 @@
  */
 
 #include "aie.h"
+#include "core/common/config_reader.h"
 #include "core/common/error.h"
 #ifndef __AIESIM__
 #include "core/common/message.h"
@@ -29,11 +30,59 @@
 #include <iostream>
 #include <cerrno>
 
+namespace {
+
+/*
+ * Status access through libxaiengine, polled by the waiters in aie_wait.h
+ */
+class xaie_tile_status : public zynqaie::tile_status
+{
+  zynqaie::Aie* aie;
+
+public:
+  explicit
+  xaie_tile_status(zynqaie::Aie* array)
+    : aie(array)
+  {}
+
+  bool
+  core_done(uint16_t col, uint16_t row) override
+  {
+    uint8_t done = 0;
+    XAie_CoreReadDoneBit(aie->getDevInst(), XAie_TileLoc(col, row), &done);
+    return done;
+  }
+
+  uint8_t
+  dma_pending(uint16_t col, uint32_t chan, bool s2mm) override
+  {
+    uint8_t npend = 0;
+    XAie_DmaGetPendingBdCount(aie->getDevInst(), XAie_TileLoc(col, 0),
+                              CONVERT_LCHANL_TO_PCHANL(chan), s2mm ? DMA_S2MM : DMA_MM2S, &npend);
+    return npend;
+  }
+};
+
+}
+
 namespace zynqaie {
 
+backoff_policy
+get_backoff_policy()
+{
+  if (xrt_core::config::get_aie_wait_mode() == "spin")
+    return backoff_policy::busy();
+
+  backoff_policy policy;
+  policy.max_sleep = std::chrono::microseconds(xrt_core::config::get_aie_wait_max_sleep_us());
+  policy.min_sleep = std::min(policy.min_sleep, policy.max_sleep);
+  return policy;
+}
+
 XAie_InstDeclare(DevInst, &ConfigPtr);   // Declare global device instance
 
 Aie::Aie(const std::shared_ptr<xrt_core::device>& device)
+  : status(new xaie_tile_status(this)), wait_policy(get_backoff_policy())
 {
     XAie_SetupConfig(ConfigPtr, HW_GEN, XAIE_BASE_ADDR, XAIE_COL_SHIFT,
         XAIE_ROW_SHIFT, XAIE_NUM_COLS, XAIE_NUM_ROWS,
@@ -123,6 +172,20 @@ XAie_DevInst* Aie::getDevInst()
   return devInst;
 }
 
+tile_status&
+Aie::
+get_tile_status()
+{
+  return *status;
+}
+
+const backoff_policy&
+Aie::
+get_wait_policy() const
+{
+  return wait_policy;
+}
+
 void
 Aie::
 sync_bo(xrtBufferHandle bo, const char *gmioName, enum xclBOSyncDirection dir, size_t size, size_t offset)
@@ -143,7 +206,7 @@ sync_bo(xrtBufferHandle bo, const char *gmioName, enum xclBOSyncDirection dir, s
   auto shim_tile = XAie_TileLoc(gmio->shim_col, 0);
   XAie_DmaDirection gmdir = gmio->type == 0 ? DMA_MM2S : DMA_S2MM;
 
-  wait_sync_bo(dmap, chan, shim_tile, gmdir, 0);
+  wait_sync_bo(dmap, chan, shim_tile, gmdir);
 }
 
 void
@@ -180,7 +243,7 @@ wait_gmio(const std::string& gmioName)
   auto shim_tile = XAie_TileLoc(gmio->shim_col, 0);
   XAie_DmaDirection gmdir = gmio->type == 0 ? DMA_MM2S : DMA_S2MM;
 
-  wait_sync_bo(dmap, chan, shim_tile, gmdir, 0);
+  wait_sync_bo(dmap, chan, shim_tile, gmdir);
 }
 
 void
@@ -209,20 +272,13 @@ submit_sync_bo(xrtBufferHandle bo, std::vector<gmio_type>::iterator& gmio, enum
   XAie_DmaDirection gmdir = gmio->type == 0 ? DMA_MM2S : DMA_S2MM;
   uint32_t pchan = CONVERT_LCHANL_TO_PCHANL(chan);
 
-  /* Find a free BD. Busy wait until we get one. */
-  while (dmap->dma_chan[chan].idle_bds.empty()) {
-    uint8_t npend;
-    XAie_DmaGetPendingBdCount(devInst, shim_tile, pchan, gmdir, &npend);
-
-    int num_comp = dmap->maxqSize - npend;
+  /* Find a free BD. Wait with backoff until we get one. */
+  if (dmap->dma_chan[chan].idle_bds.empty()) {
+    wait_until([&] { return status->dma_pending(gmio->shim_col, chan, gmdir == DMA_S2MM) < dmap->maxqSize; },
+               -1, wait_policy);
 
     /* Pending BD is completed by order per Shim DMA spec. */
-    for (int i = 0; i < num_comp; ++i) {
-      BD bd = dmap->dma_chan[chan].pend_bds.front();
-      clear_bd(bd);
-      dmap->dma_chan[chan].pend_bds.pop();
-      dmap->dma_chan[chan].idle_bds.push(bd);
-    }
+    reclaim_bds(dmap, chan, dmap->maxqSize - status->dma_pending(gmio->shim_col, chan, gmdir == DMA_S2MM));
   }
 
   BD bd = dmap->dma_chan[chan].idle_bds.front();
@@ -251,11 +307,25 @@ submit_sync_bo(xrtBufferHandle bo, std::vector<gmio_type>::iterator& gmio, enum
 
 void
 Aie::
-wait_sync_bo(ShimDMA *dmap, uint32_t chan, XAie_LocType& tile, XAie_DmaDirection gmdir, uint32_t timeout)
+wait_sync_bo(ShimDMA *dmap, uint32_t chan, XAie_LocType& tile, XAie_DmaDirection gmdir)
 {
-  while (XAie_DmaWaitForDone(devInst, tile, CONVERT_LCHANL_TO_PCHANL(chan), gmdir, timeout) != XAIE_OK);
+  /*
+   * The channel is done when no BD is queued or in flight. Polling the
+   * pending count is one register read, XAie_DmaWaitForDone would spin
+   * on the status register for its full default timeout per call.
+   */
+  bool s2mm = (gmdir == DMA_S2MM);
+  wait_until([&] { return status->dma_pending(tile.Col, chan, s2mm) == 0; },
+             -1, wait_policy);
+
+  reclaim_bds(dmap, chan, dmap->dma_chan[chan].pend_bds.size());
+}
 
-  while (!dmap->dma_chan[chan].pend_bds.empty()) {
+void
+Aie::
+reclaim_bds(ShimDMA *dmap, uint32_t chan, int num_comp)
+{
+  for (int i = 0; i < num_comp && !dmap->dma_chan[chan].pend_bds.empty(); ++i) {
     BD bd = dmap->dma_chan[chan].pend_bds.front();
     clear_bd(bd);
     dmap->dma_chan[chan].pend_bds.pop();
@@ -23,6 +23,7 @@
 #include <queue>
 #include <memory>
 
+#include "aie_wait.h"
 #include "core/common/device.h"
 #include "core/edge/common/aie_parser.h"
 #include "experimental/xrt_bo.h"
@@ -96,18 +97,33 @@ public:
     void
     reset(const xrt_core::device* device);
 
+    /* Status register access used to wait for cores and shim DMA */
+    tile_status&
+    get_tile_status();
+
+    /* Backoff between status polls, per xrt.ini Runtime.aie_wait_mode */
+    const backoff_policy&
+    get_wait_policy() const;
+
 private:
     int numCols;
     int fd;
 
     XAie_DevInst* devInst;         // AIE Device Instance
 
+    std::unique_ptr<tile_status> status;
+    backoff_policy wait_policy;
+
     void
     submit_sync_bo(xrtBufferHandle bo, std::vector<gmio_type>::iterator& gmio, enum xclBOSyncDirection dir, size_t size, size_t offset);
 
     /* Wait for all the BD transfers for a given channel */
     void
-    wait_sync_bo(ShimDMA *dmap, uint32_t chan, XAie_LocType& tile, XAie_DmaDirection gmdir, uint32_t timeout);
+    wait_sync_bo(ShimDMA *dmap, uint32_t chan, XAie_LocType& tile, XAie_DmaDirection gmdir);
+
+    /* Move completed BDs of a channel from pending to idle */
+    void
+    reclaim_bds(ShimDMA *dmap, uint32_t chan, int num_comp);
 
     void
     prepare_bd(BD& bd, xrtBufferHandle& bo);
@@ -0,0 +1,192 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xrt_core_edge_user_aie_wait_h
+#define xrt_core_edge_user_aie_wait_h
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+/*
+ * Waiting for AIE completion.
+ *
+ * Graph and GMIO waits poll AIE status registers until cores are done
+ * or shim DMA channels are drained.  Rather than spinning a CPU for the
+ * duration of the graph, the waiters poll with a backoff: a few polls
+ * back to back, then polls separated by a yield, then polls separated
+ * by an exponentially growing sleep.
+ *
+ * Register access goes through tile_status so the waiters have no
+ * libxaiengine dependency and can be exercised with a mock.  The zocl
+ * AIE partition does not deliver core done or DMA done interrupts to
+ * user space, so polling with backoff is the only wait mode.
+ */
+
+namespace zynqaie {
+
+/**
+ * struct backoff_policy - How to pause between polls
+ *
+ * @spin:      Number of polls without pausing
+ * @yield:     Number of following polls separated by a yield
+ * @min_sleep: First sleep once spin and yield polls are exhausted
+ * @max_sleep: Sleep doubles from min_sleep up to max_sleep.  Zero
+ *             never sleeps and keeps yielding.
+ */
+struct backoff_policy
+{
+  uint64_t spin = 64;
+  uint64_t yield = 64;
+  std::chrono::microseconds min_sleep {1};
+  std::chrono::microseconds max_sleep {500};
+
+  /* Busy polling, the behavior before backoff was introduced */
+  static backoff_policy
+  busy()
+  {
+    backoff_policy policy;
+    policy.spin = std::numeric_limits<uint64_t>::max();
+    return policy;
+  }
+};
+
+/**
+ * get_backoff_policy() - Policy from xrt.ini Runtime.aie_wait_mode
+ */
+backoff_policy
+get_backoff_policy();
+
+/**
+ * class backoff - Pause between consecutive polls per policy
+ */
+class backoff
+{
+  const backoff_policy& m_policy;
+  uint64_t m_polls = 0;
+  std::chrono::microseconds m_sleep;
+
+public:
+  explicit
+  backoff(const backoff_policy& policy)
+    : m_policy(policy), m_sleep(policy.min_sleep)
+  {}
+
+  void
+  pause()
+  {
+    if (++m_polls <= m_policy.spin)
+      return;
+
+    if (m_polls - m_policy.spin <= m_policy.yield || m_policy.max_sleep.count() == 0) {
+      std::this_thread::yield();
+      return;
+    }
+
+    std::this_thread::sleep_for(m_sleep);
+    m_sleep = std::min(m_sleep * 2, m_policy.max_sleep);
+  }
+
+  uint64_t
+  polls() const
+  {
+    return m_polls;
+  }
+};
+
+/**
+ * class tile_status - AIE status register access used by the waiters
+ */
+class tile_status
+{
+public:
+  virtual
+  ~tile_status()
+  {}
+
+  /* Core done bit of core tile */
+  virtual bool
+  core_done(uint16_t col, uint16_t row) = 0;
+
+  /* BDs queued or in flight on shim DMA channel (logical channel number) */
+  virtual uint8_t
+  dma_pending(uint16_t col, uint32_t chan, bool s2mm) = 0;
+};
+
+/**
+ * wait_until() - Wait until predicate is true
+ *
+ * @done:       Predicate to poll
+ * @timeout_ms: Timeout in milliseconds, negative waits forever
+ * @policy:     Backoff between polls
+ * Return:      true when predicate became true, false on timeout
+ */
+template <typename Predicate>
+bool
+wait_until(Predicate done, int timeout_ms, const backoff_policy& policy)
+{
+  using clock = std::chrono::steady_clock;
+  auto begin = clock::now();
+  backoff bo(policy);
+
+  while (!done()) {
+    if (timeout_ms >= 0 && clock::now() - begin > std::chrono::milliseconds(timeout_ms))
+      return false;
+
+    bo.pause();
+  }
+
+  return true;
+}
+
+/**
+ * wait_cores_done() - Wait for all cores of a graph to be done
+ *
+ * @tiles:      Graph tiles, each with col, row, and is_trigger
+ * @timeout_ms: Timeout in milliseconds, negative waits forever
+ * @status:     Status access
+ * @policy:     Backoff between polls
+ * Return:      true when all cores are done, false on timeout
+ *
+ * Multi-rate (trigger) cores are skipped.  A core that has reported
+ * done is not read again; the done bit stays set until the core is
+ * re-enabled.
+ */
+template <typename Tiles>
+bool
+wait_cores_done(const Tiles& tiles, int timeout_ms, tile_status& status, const backoff_policy& policy)
+{
+  std::vector<const typename Tiles::value_type*> pending;
+  for (auto& tile : tiles)
+    if (!tile.is_trigger)
+      pending.push_back(&tile);
+
+  return wait_until
+    ([&] {
+       pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                    [&](auto tile) { return status.core_done(tile->col, tile->row); }),
+                     pending.end());
+       return pending.empty();
+     },
+     timeout_ms, policy);
+}
+
+} // zynqaie
+
+#endif
@@ -192,46 +192,21 @@ wait_done(int timeout_ms)
     if (state != graph_state::running)
       throw xrt_core::error(-EINVAL, "Graph '" + name + "' is not running, cannot wait");
 
-    auto begin = std::chrono::high_resolution_clock::now();
-
     /*
-     * We are using busy waiting here. Until every tile in the graph
-     * is done, we keep polling each tile.
-     *
-     * TODO Will register AIE event for tile done.
+     * Poll core done bits with backoff until every tile in the graph
+     * is done. The zocl AIE partition does not raise core done events
+     * to user space yet; tile_status falls back to polling.
      */
-    while (1) {
-        uint8_t done;
-        for (auto& tile : tiles) {
-            /* Skip multi-rate core */
-            if (tile.is_trigger) {
-                done = 1;
-                continue;
-            }
-
-            XAie_LocType coreTile = XAie_TileLoc(tile.col, tile.row);
-            XAie_CoreReadDoneBit(aieArray->getDevInst(), coreTile, &done);
-            if (!done)
-                break;
-        }
-
-        if (done) {
-            state = graph_state::stop;
-            for (auto& tile : tiles) {
-                if (tile.is_trigger)
-                    continue;
-
-                XAie_LocType coreTile = XAie_TileLoc(tile.col, tile.row);
-                XAie_CoreDisable(aieArray->getDevInst(), coreTile);
-            }
-            return;
-        }
-
-        auto current = std::chrono::high_resolution_clock::now();
-        auto dur = current - begin;
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(dur).count();
-        if (timeout_ms >= 0 && timeout_ms < ms)
-          throw xrt_core::error(-ETIME, "Wait graph '" + name + "' timeout.");
+    if (!wait_cores_done(tiles, timeout_ms, aieArray->get_tile_status(), aieArray->get_wait_policy()))
+        throw xrt_core::error(-ETIME, "Wait graph '" + name + "' timeout.");
+
+    state = graph_state::stop;
+    for (auto& tile : tiles) {
+        if (tile.is_trigger)
+            continue;
+
+        XAie_LocType coreTile = XAie_TileLoc(tile.col, tile.row);
+        XAie_CoreDisable(aieArray->getDevInst(), coreTile);
     }
 }
 
@@ -242,16 +217,13 @@ wait()
     if (state != graph_state::running)
         throw xrt_core::error(-EINVAL, "Graph '" + name + "' is not running, cannot wait");
 
+    wait_cores_done(tiles, -1, aieArray->get_tile_status(), aieArray->get_wait_policy());
+
     for (auto& tile : tiles) {
         if (tile.is_trigger)
             continue;
 
         XAie_LocType coreTile = XAie_TileLoc(tile.col, tile.row);
-        while (1) {
-            if (XAie_CoreWaitForDone(aieArray->getDevInst(), coreTile, 0) == XAIE_OK)
-                break;
-        }
-
         XAie_CoreDisable(aieArray->getDevInst(), coreTile);
     }
 
@@ -322,9 +294,7 @@ resume()
          * We only resume the core that is not in done status.
          * XAIE_ENABLE will clear Core_Done status bit.
          */
-        uint8_t done;
-        XAie_CoreReadDoneBit(aieArray->getDevInst(), coreTile, &done);
-        if (!done)
+        if (!aieArray->get_tile_status().core_done(tile.col, tile.row))
             XAie_CoreEnable(aieArray->getDevInst(), coreTile);
     }
 
@@ -353,10 +323,9 @@ end()
         XAie_LocType coreTile = XAie_TileLoc(tile.col, tile.row);
         XAie_CoreEnable(aieArray->getDevInst(), coreTile);
 
-        while (1) {
-            if (XAie_CoreWaitForDone(aieArray->getDevInst(), coreTile, 0) == XAIE_OK)
-                break;
-        }
+        auto& status = aieArray->get_tile_status();
+        wait_until([&] { return status.core_done(tile.col, tile.row); },
+                   -1, aieArray->get_wait_policy());
 
         XAie_CoreDisable(aieArray->getDevInst(), coreTile);
     }
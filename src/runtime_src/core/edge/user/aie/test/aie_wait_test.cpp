@@ -0,0 +1,154 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Host test of the AIE waiters against a mock tile_status
+//
+// % aie_wait_test
+
+#include "../aie_wait.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <utility>
+
+namespace {
+
+struct tile_type
+{
+  uint16_t col;
+  uint16_t row;
+  bool is_trigger;
+};
+
+// Cores report done after a number of reads, DMA channels drain one
+// BD per read.  Reads are counted so tests can check what the
+// waiters touch.
+class mock_tile_status : public zynqaie::tile_status
+{
+public:
+  using tile = std::pair<uint16_t, uint16_t>;
+
+  std::map<tile, int> reads_until_done;
+  std::map<tile, int> core_reads;
+  std::map<uint32_t, uint8_t> pending;
+  int dma_reads = 0;
+
+  bool
+  core_done(uint16_t col, uint16_t row) override
+  {
+    auto t = tile{col, row};
+    ++core_reads[t];
+    auto it = reads_until_done.find(t);
+    if (it == reads_until_done.end())
+      return false;
+    return --it->second <= 0;
+  }
+
+  uint8_t
+  dma_pending(uint16_t, uint32_t chan, bool) override
+  {
+    ++dma_reads;
+    auto& count = pending[chan];
+    auto value = count;
+    if (count)
+      --count;
+    return value;
+  }
+};
+
+using tile = mock_tile_status::tile;
+
+zynqaie::backoff_policy
+fast_policy()
+{
+  zynqaie::backoff_policy policy;
+  policy.spin = 4;
+  policy.yield = 4;
+  policy.min_sleep = std::chrono::microseconds(10);
+  policy.max_sleep = std::chrono::microseconds(100);
+  return policy;
+}
+
+TEST(AieWait, CoresDone)
+{
+  mock_tile_status status;
+  std::vector<tile_type> tiles = {{1, 1, false}, {2, 1, false}, {3, 1, true}};
+  status.reads_until_done[{1, 1}] = 1;
+  status.reads_until_done[{2, 1}] = 5;
+
+  EXPECT_TRUE(zynqaie::wait_cores_done(tiles, -1, status, fast_policy()));
+
+  // Done core is not read again, trigger core is never read
+  EXPECT_EQ(status.core_reads[tile(1, 1)], 1);
+  EXPECT_EQ(status.core_reads[tile(2, 1)], 5);
+  EXPECT_EQ(status.core_reads.count(tile(3, 1)), 0u);
+}
+
+TEST(AieWait, CoresTimeout)
+{
+  mock_tile_status status;
+  std::vector<tile_type> tiles = {{1, 1, false}, {2, 1, false}};
+  status.reads_until_done[{1, 1}] = 1;
+
+  auto begin = std::chrono::steady_clock::now();
+  EXPECT_FALSE(zynqaie::wait_cores_done(tiles, 20, status, fast_policy()));
+  auto elapsed = std::chrono::steady_clock::now() - begin;
+
+  EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+  EXPECT_LT(elapsed, std::chrono::seconds(2));
+  EXPECT_EQ(status.core_reads[tile(1, 1)], 1);
+  EXPECT_GT(status.core_reads[tile(2, 1)], 1);
+}
+
+TEST(AieWait, DmaDrain)
+{
+  mock_tile_status status;
+  status.pending[3] = 4;
+
+  EXPECT_TRUE(zynqaie::wait_until([&] { return status.dma_pending(0, 3, true) == 0; },
+                                  -1, fast_policy()));
+  EXPECT_EQ(status.dma_reads, 5);
+  EXPECT_EQ(status.pending[3], 0);
+}
+
+TEST(AieWait, Backoff)
+{
+  auto policy = fast_policy();
+  zynqaie::backoff bo(policy);
+
+  // Spin and yield polls never sleep
+  for (uint64_t i = 0; i < policy.spin + policy.yield; ++i)
+    bo.pause();
+  EXPECT_EQ(bo.polls(), policy.spin + policy.yield);
+
+  // Sleeps double from min_sleep: 10 + 20 + 40 + 80 + 100 + 100 us
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 6; ++i)
+    bo.pause();
+  EXPECT_GE(std::chrono::steady_clock::now() - begin, std::chrono::microseconds(350));
+
+  // Busy policy never leaves the spin phase
+  auto busy = zynqaie::backoff_policy::busy();
+  zynqaie::backoff spin(busy);
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100000; ++i)
+    spin.pause();
+  EXPECT_EQ(spin.polls(), 100000u);
+  EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(1));
+}
+
+} // namespace
@@ -214,7 +214,11 @@ struct ert_start_copybo_cmd {
  * @cu_isr:1         enable CUISR custom module for HW scheduler
  * @cq_int:1         enable interrupt from host to HW scheduler
  * @cdma:1           enable CDMA kernel
- * @unused:25
+ * @dataflow:1       enable dataflow support
+ * @rw_shared:1      allow xclRegWrite/xclRegRead access shared CU
+ * @kds_30:1         enable new KDS
+ * @cu_policy:3      KDS CU selection policy + 1, 0 keeps the driver setting
+ * @unusedf:19
  * @dsa52:1          reserved for internal use
  *
  * @data:            addresses of @num_cus CUs
@@ -248,7 +252,8 @@ struct ert_configure_cmd {
   /* WORKAROUND: allow xclRegWrite/xclRegRead access shared CU */
   uint32_t rw_shared:1;
   uint32_t kds_30:1;
-  uint32_t unusedf:22;
+  uint32_t cu_policy:3;
+  uint32_t unusedf:19;
   uint32_t dsa52:1;
 
   /* cu address map size is num_cus */
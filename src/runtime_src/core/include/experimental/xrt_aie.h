@@ -208,4 +208,31 @@ xrtSyncBOAIE(xrtDeviceHandle handle, xrtBufferHandle bohdl, const char *gmioName
  */
 int
 xrtResetAIEArray(xrtDeviceHandle handle);
+
+#ifdef __cplusplus
+#include <future>
+
+namespace xrt { namespace aie {
+
+/**
+ * wait_graph_done_async() - Wait for graph to be done without blocking
+ *
+ * @gh:              Handle to graph previously opened with xrtGraphOpen.
+ * @timeoutMilliSec: Timeout value to wait for graph done.
+ *
+ * Return:          Future with the xrtGraphWaitDone return value.
+ *
+ * The wait runs on a separate thread and polls the graph cores with
+ * the backoff selected by xrt.ini Runtime.aie_wait_mode, leaving the
+ * calling thread free to overlap host work or to enqueue the future
+ * on an xrt::event_queue.  No other operation may be issued on the
+ * graph until the future is ready.  Throws if the graph handle is
+ * invalid.
+ */
+std::future<int>
+wait_graph_done_async(xrtGraphHandle gh, int timeoutMilliSec);
+
+}} // aie, xrt
+#endif
+
 #endif
@@ -254,9 +254,56 @@ public:
   }
 
 private:
+  friend class bo_arena;
+
+  explicit
+  bo(std::shared_ptr<bo_impl> impl)
+    : handle(std::move(impl))
+  {}
+
   std::shared_ptr<bo_impl> handle;
 };
 
+class bo_arena_impl;
+class bo_arena
+{
+public:
+  /**
+   * bo_arena() - Constructor for arena of small buffers
+   *
+   * @dhdl:       Device handle
+   * @flags:      Specify special flags per ``xrt_mem.h`` for all buffers
+   * @chunk_size: Size of parent buffers, 0 for default (4MB)
+   *
+   * The arena reserves large parent buffers per memory group and
+   * carves small buffers out of them as sub-buffers.  Buffer sizes
+   * are rounded up to a power of two size class of at least 64
+   * bytes, a released buffer is returned to the free list of its
+   * size class and reused by a later allocation.  Parent buffers
+   * are held until the arena and all buffers allocated from it are
+   * destroyed.
+   */
+  XCL_DRIVER_DLLESPEC
+  bo_arena(xclDeviceHandle dhdl, buffer_flags flags, size_t chunk_size=0);
+
+  /**
+   * alloc() - Allocate a buffer from the arena
+   *
+   * @size:     Size of buffer
+   * @grp:      Device memory group to allocate buffer in
+   * Return:    Buffer object, a sub-buffer of an arena parent buffer
+   *
+   * The buffer is aligned to its size class.  Buffers larger than
+   * 1/64 of the chunk size are allocated as regular buffers.
+   */
+  XCL_DRIVER_DLLESPEC
+  bo
+  alloc(size_t size, memory_group grp);
+
+private:
+  std::shared_ptr<bo_arena_impl> handle;
+};
+
 } // namespace xrt
 
 extern "C" {
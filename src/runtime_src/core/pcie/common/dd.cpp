@@ -21,7 +21,7 @@
 #include <iostream>
 
 namespace dd {
-const char *ddOptString = "i:o:b:c:p:e:";
+const char *ddOptString = "i:o:b:c:p:e:t:x";
 
 static const struct option longOpts[] = {
     { "if",    required_argument, NULL, 'i' },
@@ -29,7 +29,10 @@ static const struct option longOpts[] = {
     { "bs",    required_argument, 0,    'b' },
     { "count", required_argument, 0,    'c' },
     { "skip",  required_argument, 0,    'p' },
-    { "seek",  required_argument, 0,    'e' }
+    { "seek",  required_argument, 0,    'e' },
+    { "threads", required_argument, 0,  't' },
+    { "direct", no_argument,       0,    'x' },
+    { 0,       0,                 0,    0 }
 };
 
 
@@ -85,6 +88,16 @@ ddArgs_t parse_dd_options( int argc, char *argv[] )
                 std::hex << args.seek << std::dec << std::endl;
             break;
 
+        case 't':
+            args.threads = atoi( optarg );
+            std::cout << "threads found: " << args.threads << std::endl;
+            break;
+
+        case 'x':
+            args.direct = true;
+            std::cout << "direct found" << std::endl;
+            break;
+
         default:
             break;
         }
@@ -41,6 +41,8 @@ struct ddArgs_t {
     int count = -1;
     uint64_t skip = ULLONG_MAX;
     uint64_t seek = ULLONG_MAX;
+    unsigned int threads = 0;
+    bool direct = false;
 };
 /*
  * parse_dd_options
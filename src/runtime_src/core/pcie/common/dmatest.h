@@ -22,6 +22,9 @@
 #include <chrono>
 #include <future>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 
@@ -31,6 +34,8 @@
 #include "core/common/error.h"
 
 #include <boost/format.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
 
 namespace xcldev {
     class Timer {
@@ -183,6 +188,217 @@ namespace xcldev {
             return validate();
         }
     };
+
+    /*
+     * DMABench
+     *
+     * Benchmark mode of the DMA test.  Every combination of block size,
+     * thread count, queue depth and direction mix is run against one
+     * memory bank, reporting bandwidth and per operation latency.  Only
+     * the generic shim API is used so results can be compared across
+     * shims and releases, including emulation.
+     *
+     * Buffer sync is blocking, so queue depth N is modeled as N
+     * submitters per thread, each with one request in flight.
+     */
+    class DMABench {
+    public:
+        enum class mix { write, read, bidir };
+
+        struct config {
+            std::vector<size_t> blockSizes = {0x1000, 0x10000, 0x100000, 0x1000000};
+            std::vector<unsigned> threads = {1, 2, 4};
+            std::vector<unsigned> queueDepths = {1, 4};
+            std::vector<mix> mixes = {mix::write, mix::read, mix::bidir};
+            size_t bytesPerPoint = 0x10000000; // data moved per sweep point
+            unsigned minOps = 16;              // min operations per submitter
+        };
+
+        struct result {
+            size_t blockSize;
+            unsigned threads;
+            unsigned queueDepth;
+            mix dir;
+            uint64_t ops;
+            double seconds;
+            double bandwidth;                  // MB/s
+            double min, mean, p50, p99, p999, max; // latency in us
+            std::vector<uint64_t> histogram;   // [i] counts latencies < 2^i us
+        };
+
+    private:
+        xclDeviceHandle mHandle;
+        unsigned mFlags;
+        config mConfig;
+
+        static const char* name(mix dir) {
+            switch (dir) {
+            case mix::write: return "write";
+            case mix::read:  return "read";
+            default:         return "bidir";
+            }
+        }
+
+        static double percentile(const std::vector<uint64_t>& sorted, double p) {
+            size_t idx = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+            return sorted[idx] / 1000.0;
+        }
+
+        result runPoint(size_t blockSize, unsigned threads, unsigned queueDepth, mix dir) const {
+            unsigned submitters = threads * queueDepth;
+            uint64_t opsPer = std::max<uint64_t>(mConfig.minOps, mConfig.bytesPerPoint / (blockSize * submitters));
+
+            std::vector<xrt_core::aligned_ptr_type> bufs;
+            std::vector<xclBufferHandle> bos;
+            for (unsigned i = 0; i < submitters; ++i) {
+                bufs.push_back(xrt_core::aligned_alloc(xrt_core::getpagesize(), blockSize));
+                xclBufferHandle bo = XRT_NULL_BO;
+                if (bufs.back()) {
+                    std::memset(bufs.back().get(), 'x', blockSize);
+                    bo = xclAllocUserPtrBO(mHandle, bufs.back().get(), blockSize, mFlags);
+                }
+                if (bo == XRT_NULL_BO) {
+                    std::for_each(bos.begin(), bos.end(), [this](xclBufferHandle b) {xclFreeBO(mHandle, b);});
+                    throw xrt_core::error(-ENOMEM, "No DMA buffers could be allocated.");
+                }
+                bos.push_back(bo);
+            }
+
+            std::vector<std::vector<uint64_t>> latencies(submitters);
+            std::atomic<bool> go(false);
+            std::atomic<int> error(0);
+            auto submitter = [&](unsigned idx) {
+                auto& lat = latencies[idx];
+                lat.reserve(opsPer);
+                while (!go)
+                    std::this_thread::yield();
+                for (uint64_t op = 0; op < opsPer && !error; ++op) {
+                    auto syncDir = XCL_BO_SYNC_BO_TO_DEVICE;
+                    if (dir == mix::read || (dir == mix::bidir && ((idx + op) & 1)))
+                        syncDir = XCL_BO_SYNC_BO_FROM_DEVICE;
+                    auto start = std::chrono::high_resolution_clock::now();
+                    int rc = xclSyncBO(mHandle, bos[idx], syncDir, blockSize, 0);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    if (rc) {
+                        error = rc;
+                        break;
+                    }
+                    lat.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned i = 0; i < submitters; ++i)
+                workers.emplace_back(submitter, i);
+            Timer timer;
+            go = true;
+            for (auto& w : workers)
+                w.join();
+            auto elapsed = timer.stop();
+
+            std::for_each(bos.begin(), bos.end(), [this](xclBufferHandle b) {xclFreeBO(mHandle, b);});
+            if (error)
+                throw xrt_core::error(error, "DMA failed");
+
+            std::vector<uint64_t> all;
+            for (const auto& lat : latencies)
+                all.insert(all.end(), lat.begin(), lat.end());
+            std::sort(all.begin(), all.end());
+
+            result r;
+            r.blockSize = blockSize;
+            r.threads = threads;
+            r.queueDepth = queueDepth;
+            r.dir = dir;
+            r.ops = all.size();
+            r.seconds = elapsed / 1000000.0;
+            r.bandwidth = (static_cast<double>(r.ops) * blockSize / 0x100000) / (elapsed ? r.seconds : 1e-6);
+            r.min = percentile(all, 0);
+            r.p50 = percentile(all, 0.5);
+            r.p99 = percentile(all, 0.99);
+            r.p999 = percentile(all, 0.999);
+            r.max = all.back() / 1000.0;
+            r.mean = 0;
+            for (auto ns : all) {
+                r.mean += ns;
+                size_t bucket = 0;
+                for (auto us = ns / 1000; us; us >>= 1)
+                    ++bucket;
+                if (bucket >= r.histogram.size())
+                    r.histogram.resize(bucket + 1, 0);
+                ++r.histogram[bucket];
+            }
+            r.mean /= (all.size() * 1000.0);
+            return r;
+        }
+
+    public:
+        DMABench(xclDeviceHandle handle, unsigned flags, config cfg) :
+                mHandle(handle),
+                mFlags(flags),
+                mConfig(std::move(cfg)) {}
+
+        DMABench(xclDeviceHandle handle, unsigned flags = 0) :
+                DMABench(handle, flags, config()) {}
+
+        /*
+         * run() - Run all sweep points
+         *
+         * A point that fails to allocate its buffers or to sync throws
+         * xrt_core::error.
+         */
+        std::vector<result> run() const {
+            std::vector<result> results;
+            for (auto dir : mConfig.mixes)
+                for (auto blockSize : mConfig.blockSizes)
+                    for (auto threads : mConfig.threads)
+                        for (auto queueDepth : mConfig.queueDepths)
+                            results.push_back(runPoint(blockSize, threads, queueDepth, dir));
+            return results;
+        }
+
+        // Direction mix by name, as reported in results
+        static bool parse_mix(const std::string& str, mix& dir) {
+            for (auto m : {mix::write, mix::read, mix::bidir}) {
+                if (str == name(m)) {
+                    dir = m;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static boost::property_tree::ptree
+        to_ptree(const std::vector<result>& results) {
+            boost::property_tree::ptree pt_results;
+            for (const auto& r : results) {
+                boost::property_tree::ptree pt;
+                pt.put("mix", name(r.dir));
+                pt.put("block_size", r.blockSize);
+                pt.put("threads", r.threads);
+                pt.put("queue_depth", r.queueDepth);
+                pt.put("ops", r.ops);
+                pt.put("seconds", r.seconds);
+                pt.put("bandwidth_mbps", r.bandwidth);
+                pt.put("latency_us.min", r.min);
+                pt.put("latency_us.mean", r.mean);
+                pt.put("latency_us.p50", r.p50);
+                pt.put("latency_us.p99", r.p99);
+                pt.put("latency_us.p999", r.p999);
+                pt.put("latency_us.max", r.max);
+                boost::property_tree::ptree pt_hist;
+                for (size_t i = 0; i < r.histogram.size(); ++i) {
+                    boost::property_tree::ptree pt_bucket;
+                    pt_bucket.put("below_us", uint64_t(1) << i);
+                    pt_bucket.put("count", r.histogram[i]);
+                    pt_hist.push_back(std::make_pair("", pt_bucket));
+                }
+                pt.add_child("latency_histogram", pt_hist);
+                pt_results.push_back(std::make_pair("", pt));
+            }
+            return pt_results;
+        }
+    };
 }
 
 #endif /* DMATEST_H */
@@ -26,6 +26,10 @@
 #include <sstream>
 #include <vector>
 #include <numeric>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
 
 #include <cstring>
 #include <cstddef>
@@ -34,6 +38,7 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 
 #include "core/common/memalign.h"
 #include "core/common/utils.h"
@@ -93,10 +98,148 @@ namespace xcldev {
     xclDeviceHandle mHandle;
     size_t mDDRSize, mDataAlignment;
     std::string mDevUserName;
+
+    // Transfer engine settings, see transfer()
+    size_t mChunkSize = 0x400000; //4MB
+    unsigned int mWorkers = 4;
+    bool mDirectIO = false;
+
   public:
+    /*
+     * hostFile
+     *
+     * File for bulk transfers.  With O_DIRECT a second descriptor is
+     * opened, it is used for page aligned file ranges only.
+     */
+    struct hostFile {
+      int fd = -1;
+      int directFd = -1;
+
+      ~hostFile() {
+        if (fd >= 0)
+          close(fd);
+        if (directFd >= 0)
+          close(directFd);
+      }
+
+      int open(const std::string& aFilename, bool aWrite, bool aDirectIO) {
+        int flags = aWrite ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY;
+        fd = ::open(aFilename.c_str(), flags, 0644);
+        if (fd < 0)
+          return -1;
+#ifdef O_DIRECT
+        if (aDirectIO)
+          directFd = ::open(aFilename.c_str(), (flags & ~(O_CREAT | O_TRUNC)) | O_DIRECT);
+#endif
+        return 0;
+      }
+
+      int get(uint64_t aOffset, size_t aSize) const {
+        size_t align = getpagesize();
+        return (directFd >= 0 && !(aOffset % align) && !(aSize % align)) ? directFd : fd;
+      }
+
+      // Positional read or write of all of aSize bytes
+      int io(bool aWrite, char *aBuf, size_t aSize, uint64_t aOffset) const {
+        int d = get(aOffset, aSize);
+        while (aSize) {
+          ssize_t n = aWrite ? pwrite(d, aBuf, aSize, aOffset) : pread(d, aBuf, aSize, aOffset);
+          if (n < 0 && errno == EINTR)
+            continue;
+          if (n <= 0)
+            return -1;
+          aBuf += n;
+          aSize -= n;
+          aOffset += n;
+        }
+        return 0;
+      }
+    };
+
     memaccess(xclDeviceHandle aHandle, size_t aDDRSize, size_t aDataAlignment, std::string& aDevUserName) :
               mHandle(aHandle), mDDRSize(aDDRSize), mDataAlignment (aDataAlignment), mDevUserName(aDevUserName) {}
 
+    /*
+     * setTransferOptions()
+     *
+     * Chunk size and number of worker threads of bulk transfers, and
+     * whether file I/O bypasses the page cache (O_DIRECT).  A chunk size
+     * of 0 or a worker count of 0 keeps the current value.
+     */
+    void setTransferOptions(size_t aChunkSize, unsigned int aWorkers, bool aDirectIO) {
+      size_t align = getpagesize();
+      if (aChunkSize)
+        mChunkSize = (aChunkSize + align - 1) / align * align;
+      if (aWorkers)
+        mWorkers = aWorkers;
+      mDirectIO = aDirectIO;
+    }
+
+    /*
+     * transfer()
+     *
+     * Move aSize bytes between device address aDevAddr and the host in
+     * chunks.  Chunks are handed out to worker threads, each with its own
+     * staging buffer, so the DMA of one chunk overlaps the host side
+     * (e.g. file I/O) of the others.  aHost is called per chunk with the
+     * staging buffer, chunk size and offset of the chunk in the transfer.
+     * When writing to the device it fills the buffer before the DMA,
+     * when reading it consumes the buffer after the DMA.  aHost returns
+     * 0 on success and reports its own errors.
+     * Returns 0 on success, -1 on error.
+     */
+    int transfer(uint64_t aDevAddr, uint64_t aSize, bool aToDevice,
+                 const std::function<int(char*, size_t, uint64_t)>& aHost) {
+      if (!aSize)
+        return 0;
+
+      uint64_t chunks = (aSize + mChunkSize - 1) / mChunkSize;
+      unsigned int workers = static_cast<unsigned int>(std::min<uint64_t>(mWorkers, chunks));
+      std::atomic<uint64_t> next(0);
+      std::atomic<bool> failed(false);
+
+      auto worker = [&] {
+        auto buf = xrt_core::aligned_alloc(getpagesize(), mChunkSize);
+        if (!buf) {
+          failed = true;
+          return;
+        }
+        auto cbuf = static_cast<char*>(buf.get());
+        for (uint64_t idx = next++; idx < chunks && !failed; idx = next++) {
+          uint64_t offset = idx * mChunkSize;
+          size_t incr = static_cast<size_t>(std::min<uint64_t>(mChunkSize, aSize - offset));
+          uint64_t phy = aDevAddr + offset;
+          if (aToDevice) {
+            if (aHost(cbuf, incr, offset)) {
+              failed = true;
+            }
+            else if (xclUnmgdPwrite(mHandle, 0, cbuf, incr, phy) < 0) {
+              std::cout << "Error (" << strerror (errno) << ") writing 0x" << std::hex << incr << " bytes to DDR/HBM/PLRAM at offset 0x" << phy << std::dec << "\n";
+              failed = true;
+            }
+          }
+          else {
+            if (xclUnmgdPread(mHandle, 0, cbuf, incr, phy) < 0) {
+              std::cout << "Error (" << strerror (errno) << ") reading 0x" << std::hex << incr << " bytes from DDR/HBM/PLRAM at offset 0x" << phy << std::dec << "\n";
+              failed = true;
+            }
+            else if (aHost(cbuf, incr, offset)) {
+              failed = true;
+            }
+          }
+        }
+      };
+
+      std::vector<std::thread> threads;
+      for (unsigned int i = 1; i < workers; ++i)
+        threads.emplace_back(worker);
+      worker();
+      for (auto& t : threads)
+        t.join();
+
+      return failed ? -1 : 0;
+    }
+
     struct mem_bank_t {
       uint64_t m_base_address;
       uint64_t m_size;
@@ -161,42 +304,23 @@ namespace xcldev {
     /*
      * readBank()
      *
-     * Read from specified address, specified size within a bank
+     * Read from specified address, specified size within a bank into
+     * aOutFile at aFileOffset.
      * Caller's responsibility to do sanity checks. No sanity checks done here
      */
-    int readBank(std::ofstream& aOutFile, unsigned long long aStartAddr, unsigned long long aSize) {
-      unsigned long long blockSize = 0x20000;
-      auto buf = xrt_core::aligned_alloc(getpagesize(), blockSize);
-      if (!buf)
-        return -1;
-      std::memset(buf.get(), 0, blockSize);
-
-      size_t count = aSize;
-      uint64_t incr;
+    int readBank(const hostFile& aOutFile, uint64_t aFileOffset, unsigned long long aStartAddr, unsigned long long aSize) {
       auto guard = xrt_core::utils::ios_restore(std::cout);
-      for (uint64_t phy = aStartAddr; phy < aStartAddr+aSize; phy += incr) {
-        incr = (count >= blockSize) ? blockSize : count;
-        //std::cout << "Reading from addr " << std::hex << phy << " aSize = " << std::hex << incr << std::dec << std::endl;
-        if (xclUnmgdPread(mHandle, 0, buf.get(), incr, phy) < 0) {
-          //error
-          std::cout << "Error (" << strerror (errno) << ") reading 0x" << std::hex << incr << " bytes from DDR/HBM/PLRAM at offset 0x" << std::hex << phy << std::dec << "\n";
+      auto sink = [&aOutFile, aFileOffset](char* buf, size_t incr, uint64_t offset) {
+        if (aOutFile.io(true, buf, incr, aFileOffset + offset)) {
+          std::cout << "Error (" << strerror (errno) << ") writing to file at offset " << std::dec << aFileOffset + offset << "\n";
           return -1;
         }
-        count -= incr;
-        if (incr) {
-          aOutFile.write(reinterpret_cast<const char*>(buf.get()), incr);
-          if ((aOutFile.rdstate() & std::ifstream::failbit) != 0) {
-            std::cout << "Error writing to file at offset " << aSize-count << "\n";
-          }
-        }
-        std::cout << "INFO: Read size 0x" << std::hex << incr << " B from addr 0x" << phy
-                  << ". Total Read so far 0x" << aSize-count << std::endl;
-      }
-      if (count != 0) {
-        std::cout << "Error! Read " << std::dec << aSize-count << " bytes, requested " << aSize << std::endl;
+        return 0;
+      };
+      if (transfer(aStartAddr, aSize, false, sink))
         return -1;
-      }
-      return count;
+      std::cout << "INFO: Read size 0x" << std::hex << aSize << " B from addr 0x" << aStartAddr << std::endl;
+      return 0;
     }
 
     int runDMATest(size_t blocksize, unsigned int aPattern)
@@ -339,7 +463,11 @@ namespace xcldev {
         std::cout << "INFO: Reading from single bank, " << std::dec << size << " bytes from DDR/HBM/PLRAM address 0x"  << std::hex << startAddr
                                     << std::dec << std::endl;
       }
-      std::ofstream outFile(aFilename, std::ofstream::out | std::ofstream::binary);
+      hostFile outFile;
+      if (outFile.open(aFilename, true, mDirectIO)) {
+        std::cout << "Error (" << strerror (errno) << ") opening file " << aFilename << std::endl;
+        return -1;
+      }
 
       size_t count = size;
       for(auto it = startbank; it!=vec_banks.end(); ++it) {
@@ -354,7 +482,7 @@ namespace xcldev {
         }
         if (size != 0) {
           unsigned long long readsize = (size > available_bank_size) ? (unsigned long long) available_bank_size : size;
-          if( readBank(outFile, startAddr, readsize) == -1) {
+          if( readBank(outFile, count-size, startAddr, readsize) == -1) {
             return -1;
           }
           size -= readsize;
@@ -364,7 +492,6 @@ namespace xcldev {
         }
       }
 
-      outFile.close();
       std::cout << "INFO: Read data saved in file: " << aFilename << "; Num of bytes: " << std::dec << count-size << " bytes " << std::endl;
       return size;
     }
@@ -451,42 +578,14 @@ namespace xcldev {
      * Caller's responsibility to do sanity checks. No sanity checks done here
      */
     int writeBank(unsigned long long aStartAddr, unsigned long long aSize, unsigned int aPattern) {
-      char *buf = 0;
-      unsigned long long endAddr;
-      unsigned long long size;
-      unsigned long long blockSize = 0x20000;//128KB
-      if (xrt_core::posix_memalign((void**)&buf, getpagesize(), blockSize))
-        return -1;
-
-      endAddr = aStartAddr + aSize;
-      size = endAddr-aStartAddr;
-
-      // Use plain POSIX open/pwrite/close.
-
-      std::cout << "INFO: Writing DDR/HBM/PLRAM with " << std::dec << size << " bytes of pattern: 0x"
+      std::cout << "INFO: Writing DDR/HBM/PLRAM with " << std::dec << aSize << " bytes of pattern: 0x"
          << std::hex << aPattern << " from address 0x" <<std::hex << aStartAddr << std::endl;
 
-      unsigned long long count = size;
-      uint64_t incr = 0;
-      std::memset(buf, aPattern, blockSize);
-      for(uint64_t phy=aStartAddr; phy<endAddr; phy+=incr) {
-        incr = (count >= blockSize) ? blockSize : count;
-        //std::cout << "Writing to addr " << std::hex << phy << " size = " << std::hex << incr << std::dec << std::endl;
-        if (xclUnmgdPwrite(mHandle, 0, buf, incr, phy) < 0) {
-          //error
-          std::cout << "Error (" << strerror (errno) << ") writing 0x" << std::hex << incr << " bytes to DDR/HBM/PLRAM at offset 0x" << std::hex << phy << std::dec << "\n";
-          free(buf);
-          return -1;
-        }
-        count -= incr;
-      }
-
-      free(buf);
-      if (count != 0) {
-        std::cout << "Error! Written " << std::dec << size-count << " bytes, requested " << size << std::endl;
-        return -1;
-      }
-      return count;
+      auto fill = [aPattern](char* buf, size_t incr, uint64_t) {
+        std::memset(buf, aPattern, incr);
+        return 0;
+      };
+      return transfer(aStartAddr, aSize, true, fill);
     }
 
     /*
@@ -536,6 +635,67 @@ namespace xcldev {
       return size;
     }
 
+    /*
+     * writeFile()
+     *
+     * Write aSize bytes of file aFilename to the device, the size is
+     * the file size if 0.
+     */
+    int writeFile(std::string aFilename, unsigned long long aStartAddr = 0, unsigned long long aSize = 0) {
+      hostFile inFile;
+      struct stat sb;
+      if (inFile.open(aFilename, false, mDirectIO) || fstat(inFile.fd, &sb) < 0) {
+        std::cout << "Error (" << strerror (errno) << ") opening file " << aFilename << std::endl;
+        return -1;
+      }
+      if (aSize == 0)
+        aSize = sb.st_size;
+      if (aSize > static_cast<unsigned long long>(sb.st_size)) {
+        std::cout << "ERROR: File " << aFilename << " has less than " << aSize << " bytes" << std::endl;
+        return -1;
+      }
+      if (aSize == 0)
+        return 0;
+
+      std::vector<mem_bank_t> vec_banks;
+      unsigned long long startAddr = aStartAddr;
+      unsigned long long size = aSize;
+      std::vector<mem_bank_t>::iterator startbank;
+
+      //Sanity check the address and size against the mem topology
+      if (readWriteHelper(startAddr, size, vec_banks, startbank) == -1) {
+        return -1;
+      }
+
+      std::cout << "INFO: Writing DDR/HBM/PLRAM with " << std::dec << size << " bytes from file " << aFilename
+                << " from address 0x" << std::hex << startAddr << std::dec << std::endl;
+
+      uint64_t fileOffset = 0;
+      for(auto it = startbank; it!=vec_banks.end() && size != 0; ++it) {
+        unsigned long long available_bank_size;
+        if (it != startbank) {
+          startAddr = it->m_base_address;
+          available_bank_size = it->m_size;
+        }
+        else {
+          available_bank_size = it->m_size - (startAddr - it->m_base_address);
+        }
+        unsigned long long writesize = (size > available_bank_size) ? (unsigned long long) available_bank_size : size;
+        auto source = [&inFile, fileOffset](char* buf, size_t incr, uint64_t offset) {
+          if (inFile.io(false, buf, incr, fileOffset + offset)) {
+            std::cout << "Error (" << strerror (errno) << ") reading from file at offset " << std::dec << fileOffset + offset << "\n";
+            return -1;
+          }
+          return 0;
+        };
+        if (transfer(startAddr, writesize, true, source))
+          return -1;
+        fileOffset += writesize;
+        size -= writesize;
+      }
+      return size;
+    }
+
     /*
      * write()
      */
@@ -0,0 +1,256 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Host test of the DMA benchmark sweep used by xbutil dmatest --bench.
+// Buffers and syncs go to stand-ins for xclAllocUserPtrBO, xclSyncBO
+// and xclFreeBO that count what the sweep does.
+//
+// % dmabench_test
+
+#include "core/pcie/common/dmatest.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+// Stub shim state
+struct shim
+{
+  std::mutex mutex;
+  std::map<xclBufferHandle, size_t> bos;
+  xclBufferHandle next = 1;
+  uint64_t to_device = 0;
+  uint64_t from_device = 0;
+  int in_flight = 0;
+  int max_in_flight = 0;
+
+  int alloc_fail_after = -1;  // allocs that succeed before failing
+  int sync_fail_after = -1;   // syncs that succeed before failing
+  std::chrono::microseconds sync_delay {0};
+
+  void
+  reset()
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    bos.clear();
+    to_device = from_device = 0;
+    in_flight = max_in_flight = 0;
+    alloc_fail_after = sync_fail_after = -1;
+    sync_delay = std::chrono::microseconds(0);
+  }
+};
+
+shim stub;
+
+using bench = xcldev::DMABench;
+
+bench::config
+small_config()
+{
+  bench::config cfg;
+  cfg.blockSizes = {0x1000, 0x4000};
+  cfg.threads = {1, 2};
+  cfg.queueDepths = {1, 3};
+  cfg.bytesPerPoint = 0x40000;
+  cfg.minOps = 4;
+  return cfg;
+}
+
+class DMABench : public ::testing::Test
+{
+protected:
+  void
+  SetUp() override
+  {
+    stub.reset();
+  }
+};
+
+// Every combination is run, each submitter does at least minOps and
+// all buffers are freed
+TEST_F(DMABench, Sweep)
+{
+  auto cfg = small_config();
+  auto results = bench(nullptr, 0, cfg).run();
+
+  ASSERT_EQ(results.size(), cfg.mixes.size() * cfg.blockSizes.size()
+            * cfg.threads.size() * cfg.queueDepths.size());
+  for (const auto& r : results) {
+    SCOPED_TRACE(r.blockSize);
+    EXPECT_GE(r.ops, uint64_t(cfg.minOps) * r.threads * r.queueDepth);
+    EXPECT_GE(r.ops * r.blockSize, cfg.bytesPerPoint / 2);
+    EXPECT_GT(r.bandwidth, 0);
+    EXPECT_LE(r.min, r.p50);
+    EXPECT_LE(r.p50, r.p99);
+    EXPECT_LE(r.p99, r.p999);
+    EXPECT_LE(r.p999, r.max);
+    EXPECT_LE(r.min, r.mean);
+    EXPECT_LE(r.mean, r.max);
+    EXPECT_EQ(std::accumulate(r.histogram.begin(), r.histogram.end(), uint64_t(0)), r.ops);
+  }
+  EXPECT_TRUE(stub.bos.empty());
+}
+
+// Direction mix selects the sync direction
+TEST_F(DMABench, Mix)
+{
+  auto cfg = small_config();
+  cfg.blockSizes = {0x1000};
+  cfg.threads = {2};
+  cfg.queueDepths = {1};
+
+  cfg.mixes = {bench::mix::write};
+  auto ops = bench(nullptr, 0, cfg).run().front().ops;
+  EXPECT_EQ(stub.to_device, ops);
+  EXPECT_EQ(stub.from_device, 0u);
+
+  stub.reset();
+  cfg.mixes = {bench::mix::read};
+  ops = bench(nullptr, 0, cfg).run().front().ops;
+  EXPECT_EQ(stub.to_device, 0u);
+  EXPECT_EQ(stub.from_device, ops);
+
+  stub.reset();
+  cfg.mixes = {bench::mix::bidir};
+  ops = bench(nullptr, 0, cfg).run().front().ops;
+  EXPECT_EQ(stub.to_device + stub.from_device, ops);
+  EXPECT_GE(stub.to_device, ops / 2 - 2);
+  EXPECT_GE(stub.from_device, ops / 2 - 2);
+
+  bench::mix dir;
+  EXPECT_TRUE(bench::parse_mix("read", dir));
+  EXPECT_EQ(dir, bench::mix::read);
+  EXPECT_TRUE(bench::parse_mix("bidir", dir));
+  EXPECT_EQ(dir, bench::mix::bidir);
+  EXPECT_FALSE(bench::parse_mix("both", dir));
+}
+
+// Queue depth adds submitters: threads * depth syncs are in flight
+TEST_F(DMABench, QueueDepth)
+{
+  auto cfg = small_config();
+  cfg.blockSizes = {0x1000};
+  cfg.threads = {2};
+  cfg.queueDepths = {3};
+  cfg.mixes = {bench::mix::write};
+  stub.sync_delay = std::chrono::microseconds(2000);
+
+  auto r = bench(nullptr, 0, cfg).run().front();
+  EXPECT_EQ(r.threads, 2u);
+  EXPECT_EQ(r.queueDepth, 3u);
+  EXPECT_GT(stub.max_in_flight, 1);
+  EXPECT_LE(stub.max_in_flight, 6);
+  EXPECT_GE(r.min, 2000.0);
+}
+
+// Failed allocation or sync throws and frees the buffers
+TEST_F(DMABench, Errors)
+{
+  auto cfg = small_config();
+  cfg.threads = {2};
+  cfg.queueDepths = {2};
+
+  stub.alloc_fail_after = 3;
+  EXPECT_THROW(bench(nullptr, 0, cfg).run(), xrt_core::error);
+  EXPECT_TRUE(stub.bos.empty());
+
+  stub.reset();
+  stub.sync_fail_after = 10;
+  try {
+    bench(nullptr, 0, cfg).run();
+    FAIL() << "sync failure not reported";
+  }
+  catch (const xrt_core::error& ex) {
+    EXPECT_EQ(ex.get(), -EIO);
+  }
+  EXPECT_TRUE(stub.bos.empty());
+}
+
+// JSON output has one entry per point with latency and histogram
+TEST_F(DMABench, Json)
+{
+  auto cfg = small_config();
+  cfg.blockSizes = {0x1000};
+  cfg.threads = {1};
+  cfg.queueDepths = {1};
+  cfg.mixes = {bench::mix::read, bench::mix::bidir};
+
+  auto pt = bench::to_ptree(bench(nullptr, 0, cfg).run());
+  std::stringstream ss;
+  boost::property_tree::write_json(ss, pt);
+  boost::property_tree::ptree in;
+  boost::property_tree::read_json(ss, in);
+
+  ASSERT_EQ(in.size(), 2u);
+  auto& first = in.front().second;
+  EXPECT_EQ(first.get<std::string>("mix"), "read");
+  EXPECT_EQ(first.get<size_t>("block_size"), 0x1000u);
+  EXPECT_GT(first.get<uint64_t>("ops"), 0u);
+  EXPECT_GE(first.get<double>("latency_us.max"), first.get<double>("latency_us.p50"));
+  EXPECT_FALSE(first.get_child("latency_histogram").empty());
+  EXPECT_EQ(in.back().second.get<std::string>("mix"), "bidir");
+}
+
+} // namespace
+
+xclBufferHandle
+xclAllocUserPtrBO(xclDeviceHandle, void*, size_t size, unsigned int)
+{
+  std::lock_guard<std::mutex> lk(stub.mutex);
+  if (stub.alloc_fail_after == 0)
+    return XRT_NULL_BO;
+  if (stub.alloc_fail_after > 0)
+    --stub.alloc_fail_after;
+  auto handle = stub.next++;
+  stub.bos.emplace(handle, size);
+  return handle;
+}
+
+void
+xclFreeBO(xclDeviceHandle, xclBufferHandle bo)
+{
+  std::lock_guard<std::mutex> lk(stub.mutex);
+  stub.bos.erase(bo);
+}
+
+int
+xclSyncBO(xclDeviceHandle, xclBufferHandle bo, enum xclBOSyncDirection dir, size_t size, size_t)
+{
+  {
+    std::lock_guard<std::mutex> lk(stub.mutex);
+    auto it = stub.bos.find(bo);
+    if (it == stub.bos.end() || size > it->second)
+      return -EINVAL;
+    if (stub.sync_fail_after == 0)
+      return -EIO;
+    if (stub.sync_fail_after > 0)
+      --stub.sync_fail_after;
+    if (dir == XCL_BO_SYNC_BO_TO_DEVICE)
+      ++stub.to_device;
+    else
+      ++stub.from_device;
+    stub.max_in_flight = std::max(stub.max_in_flight, ++stub.in_flight);
+  }
+  std::this_thread::sleep_for(stub.sync_delay);
+  std::lock_guard<std::mutex> lk(stub.mutex);
+  --stub.in_flight;
+  return 0;
+}
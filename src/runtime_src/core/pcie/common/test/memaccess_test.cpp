@@ -0,0 +1,279 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Host test of the memaccess chunked transfer engine used by xbutil
+// mem --read, mem --write and dd.  Device memory is a host buffer
+// behind stand-ins for xclUnmgdPread and xclUnmgdPwrite.
+//
+// % memaccess_test
+
+#include "core/pcie/common/memaccess.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <set>
+
+namespace {
+
+const size_t ddr_size = 16 * 1024 * 1024;
+std::vector<char> ddr(ddr_size);
+
+// DMA of a chunk that touches fail_addr returns an error
+uint64_t fail_addr = UINT64_MAX;
+
+std::mutex threads_mutex;
+std::set<std::thread::id> threads;
+
+ssize_t
+dma(bool write, void* buf, size_t size, uint64_t offset)
+{
+  {
+    std::lock_guard<std::mutex> lk(threads_mutex);
+    threads.insert(std::this_thread::get_id());
+  }
+  if (offset + size > ddr.size() || (fail_addr >= offset && fail_addr < offset + size)) {
+    errno = EIO;
+    return -1;
+  }
+  if (write)
+    std::memcpy(&ddr[offset], buf, size);
+  else
+    std::memcpy(buf, &ddr[offset], size);
+  return size;
+}
+
+char
+pattern(uint64_t offset)
+{
+  return static_cast<char>((offset * 131) ^ (offset >> 12));
+}
+
+std::string
+temp_file()
+{
+  char name[] = "/tmp/memaccess_testXXXXXX";
+  int fd = mkstemp(name);
+  if (fd < 0)
+    throw std::runtime_error("mkstemp failed");
+  close(fd);
+  return name;
+}
+
+// Options are chunk size, workers, O_DIRECT
+struct config
+{
+  size_t chunk;
+  unsigned int workers;
+  bool direct;
+};
+
+const config configs[] = {
+  {0x1000, 1, false},
+  {0x1000, 4, false},
+  {0x3000, 3, false},
+  {0x10000, 8, true},
+  {0x400000, 4, true}
+};
+
+// Sizes exercise empty, sub-chunk, unaligned and multi-chunk transfers
+const uint64_t sizes[] = {0, 1, 0xfff, 0x1000, 0x1001, 0x12345, 0x200000 + 17};
+
+// Engine over the memory backed DMA, its per transfer INFO lines are
+// kept off the test output
+class MemAccess : public ::testing::Test
+{
+protected:
+  std::string name;
+  std::unique_ptr<xcldev::memaccess> mem;
+  std::ostringstream quiet;
+  std::streambuf* cout_buf = nullptr;
+
+  void
+  SetUp() override
+  {
+    mem.reset(new xcldev::memaccess(nullptr, ddr_size, getpagesize(), name));
+    fail_addr = UINT64_MAX;
+    cout_buf = std::cout.rdbuf(quiet.rdbuf());
+  }
+
+  void
+  TearDown() override
+  {
+    std::cout.rdbuf(cout_buf);
+  }
+};
+
+class MemAccessConfig : public MemAccess,
+                        public ::testing::WithParamInterface<config>
+{
+protected:
+  void
+  SetUp() override
+  {
+    MemAccess::SetUp();
+    auto& cfg = GetParam();
+    mem->setTransferOptions(cfg.chunk, cfg.workers, cfg.direct);
+  }
+};
+
+// Device to host through the engine into a sink, host to device from
+// a source, each chunk placed at its offset
+TEST_P(MemAccessConfig, Transfer)
+{
+  for (auto size : sizes) {
+    SCOPED_TRACE(size);
+    uint64_t addr = 0x100 + size % 0x1000;
+    std::fill(ddr.begin(), ddr.end(), 0);
+
+    auto source = [addr](char* buf, size_t incr, uint64_t offset) {
+      for (size_t i = 0; i < incr; ++i)
+        buf[i] = pattern(addr + offset + i);
+      return 0;
+    };
+    EXPECT_EQ(mem->transfer(addr, size, true, source), 0);
+
+    bool match = true;
+    for (uint64_t i = 0; i < ddr.size(); ++i)
+      match = match && ddr[i] == ((i >= addr && i < addr + size) ? pattern(i) : 0);
+    EXPECT_TRUE(match);
+
+    std::vector<char> host(size);
+    std::atomic<uint64_t> bytes(0);
+    auto sink = [&](char* buf, size_t incr, uint64_t offset) {
+      std::memcpy(&host[offset], buf, incr);
+      bytes += incr;
+      return 0;
+    };
+    EXPECT_EQ(mem->transfer(addr, size, false, sink), 0);
+    EXPECT_EQ(bytes, size);
+    EXPECT_TRUE(std::equal(host.begin(), host.end(), ddr.begin() + addr));
+  }
+}
+
+// Pattern write (memwrite), bank read into a file (memread, dd to
+// file) and file to device (dd from file) round trip
+TEST_P(MemAccessConfig, File)
+{
+  auto& cfg = GetParam();
+  uint64_t addr = 0x2000;
+  uint64_t size = 0x180000 + 0x123;
+
+  std::fill(ddr.begin(), ddr.end(), 0);
+  EXPECT_EQ(mem->writeBank(addr, size, 'J'), 0);
+  EXPECT_EQ(std::count(ddr.begin(), ddr.end(), 'J'), static_cast<std::ptrdiff_t>(size));
+  EXPECT_EQ(ddr[addr - 1], 0);
+  EXPECT_EQ(ddr[addr], 'J');
+  EXPECT_EQ(ddr[addr + size - 1], 'J');
+  EXPECT_EQ(ddr[addr + size], 0);
+
+  for (uint64_t i = 0; i < size; ++i)
+    ddr[addr + i] = pattern(i);
+
+  // Two banks read back to back into one file, as memread does
+  auto name = temp_file();
+  {
+    xcldev::memaccess::hostFile out;
+    ASSERT_EQ(out.open(name, true, cfg.direct), 0);
+    uint64_t first = 0x100000;
+    EXPECT_EQ(mem->readBank(out, 0, addr, first), 0);
+    EXPECT_EQ(mem->readBank(out, first, addr + first, size - first), 0);
+  }
+
+  std::ifstream ifs(name, std::ios::binary);
+  std::vector<char> file((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(file.size(), size);
+  EXPECT_TRUE(std::equal(file.begin(), file.end(), ddr.begin() + addr));
+
+  // Load the file back to another address
+  uint64_t dst = 0x800000;
+  {
+    xcldev::memaccess::hostFile in;
+    ASSERT_EQ(in.open(name, false, cfg.direct), 0);
+    auto source = [&in](char* buf, size_t incr, uint64_t offset) {
+      return in.io(false, buf, incr, offset);
+    };
+    EXPECT_EQ(mem->transfer(dst, size, true, source), 0);
+  }
+  EXPECT_TRUE(std::equal(ddr.begin() + dst, ddr.begin() + dst + size, ddr.begin() + addr));
+
+  std::remove(name.c_str());
+}
+
+INSTANTIATE_TEST_CASE_P(Configs, MemAccessConfig, ::testing::ValuesIn(configs));
+
+// A failed DMA or host callback fails the transfer and stops the
+// workers from taking more chunks
+TEST_F(MemAccess, Errors)
+{
+  mem->setTransferOptions(0x1000, 4, false);
+  auto fill = [](char* buf, size_t incr, uint64_t) {
+    std::memset(buf, 'x', incr);
+    return 0;
+  };
+
+  fail_addr = 0x5000;
+  EXPECT_EQ(mem->transfer(0, 0x10000, true, fill), -1);
+  EXPECT_EQ(mem->transfer(0, 0x10000, false, fill), -1);
+  fail_addr = UINT64_MAX;
+
+  std::atomic<int> calls(0);
+  auto fail = [&](char*, size_t, uint64_t offset) {
+    ++calls;
+    return offset == 0x3000 ? -1 : 0;
+  };
+  EXPECT_EQ(mem->transfer(0, 0x1000000, true, fail), -1);
+  EXPECT_LT(calls, 0x1000000 / 0x1000);
+
+  // Out of range
+  EXPECT_EQ(mem->transfer(ddr_size - 0x1000, 0x2000, true, fill), -1);
+}
+
+TEST_F(MemAccess, Workers)
+{
+  auto noop = [](char*, size_t, uint64_t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return 0;
+  };
+
+  // One chunk never starts extra workers
+  mem->setTransferOptions(0x10000, 8, false);
+  threads.clear();
+  EXPECT_EQ(mem->transfer(0, 0x10000, false, noop), 0);
+  EXPECT_EQ(threads.size(), 1u);
+
+  // Chunks are spread over workers
+  threads.clear();
+  EXPECT_EQ(mem->transfer(0, 0x10000 * 64, false, noop), 0);
+  EXPECT_GT(threads.size(), 1u);
+  EXPECT_LE(threads.size(), 8u);
+}
+
+} // namespace
+
+ssize_t
+xclUnmgdPread(xclDeviceHandle, unsigned int, void *buf, size_t size, uint64_t offset)
+{
+  return dma(false, buf, size, offset);
+}
+
+ssize_t
+xclUnmgdPwrite(xclDeviceHandle, unsigned int, const void *buf, size_t size, uint64_t offset)
+{
+  return dma(true, const_cast<void*>(buf), size, offset);
+}
@@ -241,6 +241,24 @@ kds_custat_raw_show(struct device *dev, struct device_attribute *attr, char *buf
 }
 static DEVICE_ATTR_RO(kds_custat_raw);
 
+static ssize_t
+kds_policy_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return show_kds_policy(&XDEV(xdev)->kds, buf);
+}
+
+static ssize_t
+kds_policy_store(struct device *dev, struct device_attribute *da,
+	const char *buf, size_t count)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return store_kds_policy(&XDEV(xdev)->kds, buf, count);
+}
+static DEVICE_ATTR(kds_policy, 0644, kds_policy_show, kds_policy_store);
+
 static ssize_t
 kds_interrupt_show(struct device *dev, struct device_attribute *attr, char *buf)
 {
@@ -639,6 +657,7 @@ static struct attribute *xocl_attrs[] = {
 	&dev_attr_kds_numcdma.attr,
 	&dev_attr_kds_stat.attr,
 	&dev_attr_kds_custat_raw.attr,
+	&dev_attr_kds_policy.attr,
 	&dev_attr_kds_interrupt.attr,
 	&dev_attr_ert_disable.attr,
 	&dev_attr_dev_offline.attr,
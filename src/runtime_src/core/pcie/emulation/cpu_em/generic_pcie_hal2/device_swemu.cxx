@@ -15,6 +15,7 @@
  */
 #include "device_swemu.h"
 #include "core/common/query_requests.h"
+#include "core/common/uuid.h"
 #include "shim.h"
 
 #include <string>
@@ -41,6 +42,18 @@ struct deviceQuery
   }
 };
 
+// uuid of the xclbin run by the device process, null uuid if none
+struct xclbinUuid
+{
+  static std::string
+    get(const xrt_core::device* device, key_type)
+  {
+    xclcpuemhal2::CpuemShim *drv = xclcpuemhal2::CpuemShim::handleCheck(device->get_device_handle());
+    auto uuid = drv ? drv->getXclbinUuid() : std::string();
+    return uuid.empty() ? xrt_core::uuid().to_string() : uuid;
+  }
+};
+
 template <typename QueryRequestType, typename Getter>
 struct function0_get : virtual QueryRequestType
 {
@@ -65,6 +78,7 @@ initialize_query_table()
 {
   emplace_func0_request<query::m2m, deviceQuery>();
   emplace_func0_request<query::nodma, deviceQuery>();
+  emplace_func0_request<query::xclbin_uuid, xclbinUuid>();
 }
 
 struct X { X() { initialize_query_table(); }};
@@ -21,6 +21,7 @@
 #include "shim.h"
 #include "core/common/system.h"
 #include "core/common/device.h"
+#include "core/common/message.h"
 
 xclDeviceHandle xclOpen(unsigned deviceIndex, const char *logfileName, xclVerbosityLevel level)
 {
@@ -101,9 +102,17 @@ int xclLoadXclBin(xclDeviceHandle handle, const xclBin *buffer)
   xclcpuemhal2::CpuemShim *drv = xclcpuemhal2::CpuemShim::handleCheck(handle);
   if (!drv)
     return -1;
-  auto ret = drv->xclLoadXclBin(buffer);
+  // The device process keeps running the xclbin it was launched with,
+  // skip relaunching it to load the same xclbin again
+  auto device = xrt_core::get_userpf_device(drv);
+  auto skip = device->is_xclbin_loaded(buffer);
+  if (skip)
+    xrt_core::message::send(xrt_core::message::severity_level::XRT_INFO, "XRT",
+                            "xclLoadXclBin: xclbin already loaded, skipping download");
+  auto ret = skip ? 0 : drv->xclLoadXclBin(buffer);
   if (!ret) {
-    auto device = xrt_core::get_userpf_device(drv);
+    auto top = reinterpret_cast<const axlf*>(buffer);
+    drv->setXclbinUuid(xrt_core::uuid(top->m_header.uuid).to_string());
     device->register_axlf(buffer);
     if (xclemulation::is_sw_emulation() && xrt_core::config::get_flag_kds_sw_emu())
       ret = xrt_core::scheduler::init(handle, buffer);
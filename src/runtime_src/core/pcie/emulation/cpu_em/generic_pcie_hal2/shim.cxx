@@ -1081,6 +1081,7 @@ namespace xclcpuemhal2 {
     systemUtil::makeSystemCall(socketName, systemUtil::systemOperation::REMOVE);
     delete sock;
     sock = nullptr;
+    mXclbinUuid.clear();
     PRINTENDFUNC;
     if (mIsKdsSwEmu && mSWSch && mCore)
     {
@@ -172,6 +172,10 @@ namespace xclcpuemhal2 {
       // New API's for m2m and no-dma
       void constructQueryTable();
       int deviceQuery(key_type queryKey);
+
+      // uuid of the xclbin run by the device process, null uuid if none
+      std::string getXclbinUuid() const { return mXclbinUuid; }
+      void setXclbinUuid(const std::string& uuid) { mXclbinUuid = uuid; }
     private:
       std::shared_ptr<xrt_core::device> mCoreDevice;
       std::mutex mMemManagerMutex;
@@ -248,6 +252,7 @@ namespace xclcpuemhal2 {
       FeatureRomHeader mFeatureRom;
       boost::property_tree::ptree mPlatformData;
       std::map<key_type, std::string> mQueryTable;
+      std::string mXclbinUuid;
 
       std::set<unsigned int > mImportedBOs;
       exec_core* mCore;
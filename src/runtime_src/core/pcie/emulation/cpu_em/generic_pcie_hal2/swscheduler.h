@@ -5,6 +5,7 @@
 #include <mutex>
 #include <cmath>
 #include <cstdint>
+#include <chrono>
 #include <queue>
 #include <thread>
 #include <condition_variable>
@@ -74,10 +75,20 @@ namespace xclcpuemhal2 {
       int slot_idx;
       /* The actual cmd object representation */
       struct ert_packet *packet;
+      std::chrono::steady_clock::time_point submit_time;   /* add_cmd */
+      std::chrono::steady_clock::time_point complete_time; /* mark_cmd_complete */
       xocl_cmd();
       ~xocl_cmd();
   };
 
+  /* Submit to completion latency of commands completed by the scheduler */
+  struct cmd_latency_stats
+  {
+    uint64_t count = 0;
+    std::chrono::nanoseconds total {0};
+    std::chrono::nanoseconds max {0};
+  };
+
   class exec_core 
   {
     public:
@@ -159,6 +170,7 @@ namespace xclcpuemhal2 {
     void release_slot_idx(exec_core *exec, unsigned int slot_idx);
     void notify_host(xocl_cmd *xcmd);
     void mark_cmd_complete(xocl_cmd *xcmd);
+    cmd_latency_stats get_cmd_latency();
     void mark_mask_complete(exec_core *exec, uint32_t mask, unsigned int mask_idx);
     int queued_to_running(xocl_cmd *xcmd) ;
     void running_to_complete(xocl_cmd *xcmd) ;
@@ -204,6 +216,9 @@ namespace xclcpuemhal2 {
 
     std::mutex m_add_cmd_mutex;
     int num_pending;
+
+    std::mutex cmd_latency_mutex;
+    cmd_latency_stats cmd_latency;
   };
 }
 
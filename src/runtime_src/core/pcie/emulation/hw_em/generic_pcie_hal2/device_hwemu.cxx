@@ -17,6 +17,7 @@
 
 #include "device_hwemu.h"
 #include "core/common/query_requests.h"
+#include "core/common/uuid.h"
 #include "shim.h"
 
 #include <string>
@@ -43,6 +44,18 @@ namespace {
     }
   };
 
+  // uuid of the xclbin run by the device process, null uuid if none
+  struct xclbinUuid
+  {
+    static std::string
+      get(const xrt_core::device* device, key_type)
+    {
+      xclhwemhal2::HwEmShim *drv = xclhwemhal2::HwEmShim::handleCheck(device->get_device_handle());
+      auto uuid = drv ? drv->getXclbinUuid() : std::string();
+      return uuid.empty() ? xrt_core::uuid().to_string() : uuid;
+    }
+  };
+
   template <typename QueryRequestType, typename Getter>
   struct function0_get : virtual QueryRequestType
   {
@@ -67,6 +80,7 @@ namespace {
   {
     emplace_func0_request<query::m2m, deviceQuery>();
     emplace_func0_request<query::nodma, deviceQuery>();
+    emplace_func0_request<query::xclbin_uuid, xclbinUuid>();
   }
 
   struct X { X() { initialize_query_table(); } };
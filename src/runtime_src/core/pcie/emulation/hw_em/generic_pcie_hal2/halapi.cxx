@@ -21,6 +21,7 @@
 #include "shim.h"
 #include "core/common/system.h"
 #include "core/common/device.h"
+#include "core/common/message.h"
 
 int xclExportBO(xclDeviceHandle handle, unsigned int boHandle)
 {
@@ -305,15 +306,23 @@ int xclLoadXclBin(xclDeviceHandle handle, const xclBin *buffer)
   xclhwemhal2::HwEmShim *drv = xclhwemhal2::HwEmShim::handleCheck(handle);
   if (!drv)
     return -1;
+  auto device = xrt_core::get_userpf_device(drv);
 #ifdef DISABLE_DOWNLOAD_XCLBIN
   int ret = 0;
 #else
-  auto ret = drv->xclLoadXclBin(buffer);
+  // The device process keeps running the xclbin it was launched with,
+  // skip relaunching it to load the same xclbin again
+  auto skip = device->is_xclbin_loaded(buffer);
+  if (skip)
+    xrt_core::message::send(xrt_core::message::severity_level::XRT_INFO, "XRT",
+                            "xclLoadXclBin: xclbin already loaded, skipping download");
+  auto ret = skip ? 0 : drv->xclLoadXclBin(buffer);
 #endif
   if (!ret) {
-    auto device = xrt_core::get_userpf_device(drv);
     device->register_axlf(buffer);
 #ifndef DISABLE_DOWNLOAD_XCLBIN
+    auto top = reinterpret_cast<const axlf*>(buffer);
+    drv->setXclbinUuid(xrt_core::uuid(top->m_header.uuid).to_string());
     ret = xrt_core::scheduler::init(handle, buffer);
 #endif
   }
@@ -30,8 +30,6 @@ namespace xclhwemhal2 {
     poll = 0;
     stop = false;
     pSch = _sch ;
-    pthread_mutex_init(&state_lock,NULL);
-    pthread_cond_init(&state_cond,NULL);
     scheduler_thread = 0;
   }
 
@@ -43,8 +41,6 @@ namespace xclhwemhal2 {
     poll = 0;
     stop = false;
     pSch = NULL ;
-    pthread_mutex_init(&state_lock,NULL);
-    pthread_cond_init(&state_cond,NULL);
   }
 
   exec_core::exec_core()
@@ -777,18 +773,32 @@ namespace xclhwemhal2 {
 
   void MBScheduler::mark_cmd_complete(xocl_cmd *xcmd)
   {
+    xcmd->complete_time = std::chrono::steady_clock::now();
+    auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(xcmd->complete_time - xcmd->submit_time);
+    {
+      std::lock_guard<std::mutex> lk(cmd_latency_mutex);
+      cmd_latency.count++;
+      cmd_latency.total += latency;
+      cmd_latency.max = std::max(cmd_latency.max, latency);
+    }
     xcmd->exec->submitted_cmds[xcmd->slot_idx] = NULL;
     set_cmd_state(xcmd,ERT_CMD_STATE_COMPLETED);
     if (xcmd->exec->polling_mode)
       mScheduler->poll--;
     release_slot_idx(xcmd->exec,xcmd->slot_idx);
 #ifdef EM_DEBUG_KDS
-    std::cout<<"Marking command Complete XCMD: " <<xcmd<<" PACKET: "<<xcmd->packet<< " BO: "<< xcmd->bo << std::endl;
+    std::cout<<"Marking command Complete XCMD: " <<xcmd<<" PACKET: "<<xcmd->packet<< " BO: "<< xcmd->bo << " LATENCY: "<< latency.count() << "ns" << std::endl;
     std::cout<<"Releasing slot " << xcmd->slot_idx << std::endl<<std::endl;
 #endif
     notify_host(xcmd);
   }
 
+  cmd_latency_stats MBScheduler::get_cmd_latency()
+  {
+    std::lock_guard<std::mutex> lk(cmd_latency_mutex);
+    return cmd_latency;
+  }
+
   void MBScheduler::mark_mask_complete(exec_core *exec, uint32_t mask, unsigned int mask_idx)
   {
 #ifdef EM_DEBUG_KDS
@@ -948,6 +958,7 @@ namespace xclhwemhal2 {
     xcmd->exec=exec;
     xcmd->cu_idx=-1;
     xcmd->slot_idx=-1;
+    xcmd->submit_time = std::chrono::steady_clock::now();
     int ret = convert_execbuf(exec, bo , xcmd);
 #ifdef EM_DEBUG_KDS
     std::cout<<"adding a command CMD: " <<xcmd<<" PACKET: "<<xcmd->packet<< " BO: "<< xcmd->bo <<" BASE: "<<xcmd->bo->base<< std::endl;
@@ -983,7 +994,7 @@ namespace xclhwemhal2 {
     }
     if(bSchComeOutOfCond)
     {
-      pthread_cond_signal(&mScheduler->state_cond);
+      mScheduler->state_cond.notify_one();
       return 0;
     }
     return 1;
@@ -1056,7 +1067,6 @@ namespace xclhwemhal2 {
   void scheduler_loop(xocl_sched *xs)
   {
     MBScheduler* pSch = xs->pSch;
-    std::lock_guard<std::mutex> lk(pSch->pending_cmds_mutex);
 
     if (xs->error) { return; }
 
@@ -1070,10 +1080,21 @@ namespace xclhwemhal2 {
   void* scheduler(void* data)
   {
     xocl_sched *xs = (xocl_sched *)data;
+    MBScheduler* pSch = xs->pSch;
+    auto wakeup = [xs, pSch] { return pSch->num_pending > 0 || xs->stop || xs->error; };
+
+    std::unique_lock<std::mutex> lk(pSch->pending_cmds_mutex);
     while (!xs->stop && !xs->error)
     {
       scheduler_loop(xs);
-      usleep(10);
+
+      /* Sleep until a command is submitted when no command is in flight.
+       * Completion of running commands is found by reading CU status, so
+       * keep polling those, but wake up at once on a new submit. */
+      if (xs->command_queue.empty())
+        xs->state_cond.wait(lk, wakeup);
+      else
+        xs->state_cond.wait_for(lk, std::chrono::microseconds(10), wakeup);
     }
     return NULL;
   }
@@ -1109,8 +1130,11 @@ namespace xclhwemhal2 {
     std::cout<<"Scheduler Thread ended "<< std::endl;
 #endif
 
-    mScheduler->stop= true;
-    scheduler_wait_condition();
+    {
+      std::lock_guard<std::mutex> lk(pending_cmds_mutex);
+      mScheduler->stop= true;
+      scheduler_wait_condition();
+    }
     mScheduler->bThreadCreated = false;
 
     int retval = pthread_join(mScheduler->scheduler_thread,NULL);
@@ -5,7 +5,9 @@
 #include <mutex>
 #include <cmath>
 #include <cstdint>
+#include <chrono>
 #include <queue>
+#include <condition_variable>
 #include "ert.h"
 
 #define XOCL_U32_MASK 0xFFFFFFFF
@@ -31,8 +33,7 @@ namespace xclhwemhal2 {
   {
     public:
       pthread_t                   scheduler_thread;
-      pthread_mutex_t             state_lock;
-      pthread_cond_t              state_cond;
+      std::condition_variable_any    state_cond;
       std::list<xocl_cmd*>        command_queue;
       bool                        bThreadCreated;
       unsigned int                error;
@@ -71,10 +72,20 @@ namespace xclhwemhal2 {
       int slot_idx;
       /* The actual cmd object representation */
       struct ert_packet *packet;
+      std::chrono::steady_clock::time_point submit_time;   /* add_cmd */
+      std::chrono::steady_clock::time_point complete_time; /* mark_cmd_complete */
       xocl_cmd();
       ~xocl_cmd();
   };
 
+  /* Submit to completion latency of commands completed by the scheduler */
+  struct cmd_latency_stats
+  {
+    uint64_t count = 0;
+    std::chrono::nanoseconds total {0};
+    std::chrono::nanoseconds max {0};
+  };
+
   class exec_core
   {
     public:
@@ -159,6 +170,7 @@ namespace xclhwemhal2 {
     void release_slot_idx(exec_core *exec, unsigned int slot_idx);
     void notify_host(xocl_cmd *xcmd);
     void mark_cmd_complete(xocl_cmd *xcmd);
+    cmd_latency_stats get_cmd_latency();
     void mark_mask_complete(exec_core *exec, uint32_t mask, unsigned int mask_idx);
     int queued_to_running(xocl_cmd *xcmd) ;
     void running_to_complete(xocl_cmd *xcmd) ;
@@ -204,6 +216,9 @@ namespace xclhwemhal2 {
 
     std::mutex m_add_cmd_mutex;
     int num_pending;
+
+    std::mutex cmd_latency_mutex;
+    cmd_latency_stats cmd_latency;
     int ert_version ;
     uint64_t _CMDQ_BASE_ADDR;
     uint64_t _CSA_BASE_ADDR;
@@ -1701,6 +1701,7 @@ uint32_t HwEmShim::getAddressSpace (uint32_t topology)
     //ProfilerStop();
     delete sock;
     sock = NULL;
+    mXclbinUuid.clear();
     PRINTENDFUNC;
     if(mMBSch && mCore)
     {
@@ -219,6 +219,10 @@ using addr_type = uint64_t;
       uint64_t getErtBaseAddress();
       int deviceQuery(key_type queryKey);
 
+      // uuid of the xclbin run by the device process, null uuid if none
+      std::string getXclbinUuid() const { return mXclbinUuid; }
+      void setXclbinUuid(const std::string& uuid) { mXclbinUuid = uuid; }
+
       std::string getERTVersion();
       bool isLegacyErt();
       unsigned int getDsaVersion();
@@ -352,6 +356,7 @@ using addr_type = uint64_t;
       FeatureRomHeader mFeatureRom;
       boost::property_tree::ptree mPlatformData;
       std::map<key_type, std::string> mQueryTable;
+      std::string mXclbinUuid;
       std::set<unsigned int > mImportedBOs;
       uint64_t mCuBaseAddress;
       bool     mVersalPlatform;
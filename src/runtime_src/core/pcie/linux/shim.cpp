@@ -22,6 +22,7 @@
 #include "shim.h"
 #include "scan.h"
 #include "system_linux.h"
+#include "uring.h"
 #include "core/common/message.h"
 #include "core/common/xclbin_parser.h"
 #include "core/common/scheduler.h"
@@ -77,6 +78,7 @@
 #define ARRAY_SIZE(x)   (sizeof (x) / sizeof (x[0]))
 
 #define SHIM_QDMA_AIO_EVT_MAX   1024 * 64
+#define SHIM_QDMA_URING_EVT_MAX 4096
 
 // Profiling
 #define AXI_FIFO_RDFD_AXI_FULL          0x1000
@@ -126,6 +128,9 @@ namespace xocl {
  * Configuration:
  * - qAioEn:		per queue aio context enabled or not
  * - qAioCtx:		per queue aio context, valid only if qAioEn = true
+ * - qUringEn:		per queue context uses io_uring instead of aio, set
+ * 			when the context is created if Runtime.stream_io_uring
+ * 			is enabled and the kernel supports io_uring
  * - set_option():	optional configurations for aio context and batching
  *
  * i/o data path:
@@ -146,7 +151,14 @@ private:
        struct xocl_qdma_req_header header;	/* used for io_submit */
     };
 
+    struct uring_io {	/* io_uring: i/o kept until its completion */
+       unsigned long priv_data;		/* priv_data from the original wr */
+       struct iovec iov[2];
+       struct xocl_qdma_req_header header;
+    };
+
     bool qAioEn;		/* per queue aio is enabled */
+    bool qUringEn;		/* per queue context is io_uring */
     bool qAioBatchEn;		/* per queue aio req. batching is enabled */
     bool qExit;			/* queue is being stopped/released */
     bool h2c; 			/* queue is for H2C direction */
@@ -166,6 +178,12 @@ private:
 
     aio_context_t qAioCtx;	/* per queue aio context */
 
+    uring qUring;		/* per queue io_uring, valid if qUringEn */
+    std::vector<struct uring_io> uringIo;	/* i/o of each slot */
+    uring_slots uringSlots;	/* i/o slots, by user data */
+    std::vector<uring::completion> uringComps;
+    std::mutex pollLock;	/* serializes io_uring completion polling */
+
     std::thread qWorker;	/* aio batching thread */
     std::mutex reqLock;		/* lock to protect i/o related info. */
     std::list<struct queued_io> reqList; /* queued up i/o request */
@@ -265,6 +283,68 @@ private:
         }
     }
 
+    /* prepare one i/o in a free io_uring slot, calling function should
+     * hold the lock */
+    bool queue_prep_uring_io(unsigned long flags, unsigned long buf_va,
+                             unsigned long len, unsigned long priv_data)
+    {
+        unsigned int slot;
+        if (!uringSlots.next(slot))
+            return false;
+
+        struct uring_io &io = uringIo[slot];
+        io.priv_data = priv_data;
+        io.header.flags = flags;
+        prepare_io(nullptr, io.iov, &io.header, buf_va, len, 0);
+        if (!qUring.prep_rw(h2c, (int)qhndl, io.iov, 2, slot))
+            return false;
+
+        uringSlots.prepared();
+        return true;
+    }
+
+    /* submit prepared io_uring i/o with one system call, slots of i/o the
+     * kernel did not take are released. Calling function should hold the
+     * lock. Returns the # of i/o submitted or error */
+    int queue_submit_uring_io(void)
+    {
+        int submitted = qUring.submit();
+        uringSlots.submitted(submitted);
+        return submitted;
+    }
+
+    /* io_uring version of queue_flush_aio_request() */
+    int queue_flush_uring_request(void)
+    {
+        unsigned int cb_cnt = 0;
+        for (auto &qio : reqList) {
+            if (!queue_prep_uring_io(qio.flags, qio.buf_va, qio.len,
+                                     qio.priv_data))
+                break;
+            cb_cnt++;
+        }
+
+        /* all slots are in flight, wait for completions */
+        if (!cb_cnt)
+            return -EAGAIN;
+
+        int submitted = queue_submit_uring_io();
+        if (submitted < 0) {
+            if (submitted != -EAGAIN && submitted != -EBUSY) {
+                cbErrCnt = reqList.size();
+                cbErrCode = submitted;
+            }
+            return submitted;
+        }
+
+        if (submitted > 0) {
+            release_request(submitted);
+            cbSubmitCnt += submitted;
+        }
+
+        return 0;
+    }
+
     /* submit all of the queued i/o, calling function should hold the lock */
     int queue_flush_aio_request(void)
     {
@@ -272,6 +352,9 @@ private:
         if (cbErrCnt)
             return -EAGAIN;
 
+        if (qUringEn)
+            return queue_flush_uring_request();
+
         /* submit all queued requests */
         unsigned int cb_max = bufCnt;
         unsigned int cb_cnt = 0;
@@ -315,7 +398,9 @@ private:
             std::unique_lock<std::mutex> lck(reqLock);
 	    while (reqList.empty() && !qExit)
                 cv.wait(lck);
-            queue_flush_aio_request();
+            /* wait for polled completions to free io_uring slots */
+            if (queue_flush_aio_request() == -EAGAIN && qUringEn && !qExit)
+                cv.wait(lck);
         } while(!qExit);
 
         qAioBatchEn = false;
@@ -354,7 +439,7 @@ private:
 
 public:
     queue_cb(struct xocl_qdma_ioc_create_queue *qinfo)
-        : qAioEn{false}, qAioBatchEn{false}, qExit{false},
+        : qAioEn{false}, qUringEn{false}, qAioBatchEn{false}, qExit{false},
           h2c{qinfo->write ? true : false}, qhndl{qinfo->handle},
           aio_max_evts{0}, byteThresh{0}, pktThresh{0}, byteCnt{0}, bufCnt{0},
           cbSubmitCnt{0}, cbPollCnt{0}, cbErrCnt{0}, cbErrCode{0}
@@ -368,6 +453,18 @@ public:
            return;
 
         stop_aio_worker();
+        if (qUringEn) {
+            /* i/o slots must outlive the i/o, wait for what is in flight */
+            std::lock_guard<std::mutex> lk(pollLock);
+            while (!uringSlots.idle()) {
+                int rc = qUring.reap(1, uringComps.size(), uringComps.data(), 1000);
+                if (rc <= 0)
+                    break;
+                for (int i = 0; i < rc; i++)
+                    uringSlots.completed(uringComps[i].data);
+            }
+            return;
+        }
         io_destroy(qAioCtx);
     }
 
@@ -383,6 +480,18 @@ public:
 	    if (!qAioEn) {
                 if (!val)
                     val = SHIM_QDMA_AIO_EVT_MAX;
+                if (xrt_core::config::get_stream_io_uring() &&
+                    !qUring.setup(std::min(val, (uint32_t)SHIM_QDMA_URING_EVT_MAX))) {
+                    /* queued i/o is bounded by the i/o slots */
+                    val = qUring.capacity();
+                    uringIo.resize(val);
+                    uringComps.resize(val);
+                    uringSlots.reset(val);
+                    qUringEn = true;
+                    qAioEn = true;
+                    aio_max_evts = val;
+                    return 0;
+                }
 		auto rc = io_setup(val, &qAioCtx);
 		if (!rc) {
 		     qAioEn = true;
@@ -421,6 +530,10 @@ public:
 
         *actual = 0;
 
+        if (qUringEn)
+            return queue_poll_uring_completion(min_compl, max_compl, comps,
+                                               actual, timeout);
+
         if (timeout > 0) {
             memset(&time, 0, sizeof(time));
             time.tv_sec = timeout / 1000;
@@ -457,6 +570,51 @@ public:
         return 0;
     }
 
+    // io_uring version of queue_poll_completion()
+    int queue_poll_uring_completion(int min_compl, int max_compl,
+                                    struct xclReqCompletion *comps,
+                                    int* actual, int timeout /*ms*/)
+    {
+        std::lock_guard<std::mutex> plk(pollLock);
+
+        if (max_compl > (int)uringComps.size())
+            max_compl = uringComps.size();
+        if (min_compl > max_compl)
+            min_compl = max_compl;
+
+        int rc = qUring.reap(min_compl, max_compl, uringComps.data(), timeout);
+        if (rc < 0)
+            return rc;
+
+        int num_evt = rc;
+        {
+            std::lock_guard<std::mutex> lk(reqLock);
+            for (int i = 0; i < num_evt; i++) {
+                unsigned int slot = uringComps[i].data;
+                int res = uringComps[i].res;
+
+                comps[i].priv_data = (void *)uringIo[slot].priv_data;
+                comps[i].nbytes = (res < 0) ? 0 : res;
+                comps[i].err_code = (res < 0) ? res : 0;
+                uringSlots.completed(slot);
+            }
+            cbPollCnt += num_evt;
+        }
+
+        /* the batching thread may be waiting for free slots */
+        if (num_evt && qAioBatchEn)
+            cv.notify_one();
+
+        if (num_evt < min_compl && qAioBatchEn) {
+             /* timeout happened, check if there is any io submission errors */
+             rc = check_io_submission_error(max_compl - num_evt, comps + num_evt);
+             num_evt += rc;
+        }
+
+        *actual = num_evt;
+        return 0;
+    }
+
     // submit the read/write i/o to the queue
     ssize_t queue_submit_io(xclQueueRequest *wr, aio_context_t *mAioCtx)
     {
@@ -487,7 +645,26 @@ public:
          * i/o right away */
         struct xocl_qdma_req_header header;
         header.flags = wr->flag;
-        if (aio) {
+        if (aio && qUringEn) {
+            /* all buffers of the request are submitted with one call */
+            std::lock_guard<std::mutex> lk(reqLock);
+            unsigned int i = 0;
+            for (; i < wr->buf_num; i++) {
+                if (!queue_prep_uring_io(wr->flag, wr->bufs[i].va,
+                                         wr->bufs[i].len,
+                                         (uint64_t)wr->priv_data))
+                    break;
+            }
+            if (!i)
+                return -EAGAIN;
+
+            int submitted = queue_submit_uring_io();
+            if (submitted <= 0)
+                return submitted ? submitted : -EAGAIN;
+            for (i = 0; i < (unsigned int)submitted; i++)
+                rc += wr->bufs[i].len;
+            cbSubmitCnt += submitted;
+        } else if (aio) {
             aio_context_t *aio_ctx = qAioEn ? &qAioCtx : mAioCtx;
             for (unsigned int i = 0; i < wr->buf_num; i++) {
                 struct iovec iov[2];
@@ -592,8 +769,7 @@ int shim::dev_init()
 
 int shim::xrt_logmsg(xrtLogMsgLevel level, const char* format, ...)
 {
-    static auto verbosity = xrt_core::config::get_verbosity();
-    if (level <= verbosity) {
+    if (xrt_core::message::enabled(static_cast<xrt_core::message::severity_level>(level))) {
         va_list args;
         va_start(args, format);
         int ret = xclLogMsg(level, "XRT", format, args);
@@ -718,9 +894,11 @@ size_t shim::xclWrite(xclAddressSpace space, uint64_t offset, const void *hostBu
             size_t regSize = size / 4;
             if (regSize > 32)
             regSize = 32;
-            for (unsigned i = 0; i < regSize; i++) {
-                xrt_logmsg(XRT_INFO, "%s: space: %d, offset:0x%x, reg:%d",
-                        __func__, space, offset+i, reg[i]);
+            if (xrt_core::message::enabled(xrt_core::message::severity_level::XRT_INFO)) {
+                for (unsigned i = 0; i < regSize; i++) {
+                    xrt_logmsg(XRT_INFO, "%s: space: %d, offset:0x%llx, reg:%u",
+                            __func__, space, (unsigned long long)offset+i, reg[i]);
+                }
             }
             if (mDev->pcieBarWrite(offset, hostBuf, size) == 0) {
                 return size;
@@ -740,8 +918,8 @@ size_t shim::xclWrite(xclAddressSpace space, uint64_t offset, const void *hostBu
  */
 size_t shim::xclRead(xclAddressSpace space, uint64_t offset, void *hostBuf, size_t size)
 {
-    xrt_logmsg(XRT_INFO, "%s, space: %d, offset: %d, hostBuf: %s, size: %d",
-            __func__, space, offset, hostBuf, size);
+    xrt_logmsg(XRT_INFO, "%s, space: %d, offset: 0x%llx, hostBuf: %p, size: %zu",
+            __func__, space, (unsigned long long)offset, hostBuf, size);
 
     switch (space) {
         case XCL_ADDR_SPACE_DEVICE_PERFMON:
@@ -760,9 +938,11 @@ size_t shim::xclRead(xclAddressSpace space, uint64_t offset, void *hostBuf, size
             size_t regSize = size / 4;
             if (regSize > 4)
             regSize = 4;
-            for (unsigned i = 0; i < regSize; i++) {
-                xrt_logmsg(XRT_INFO, "%s: space: %d, offset:0x%x, reg:%d",
-                    __func__, space, offset+i, reg[i]);
+            if (xrt_core::message::enabled(xrt_core::message::severity_level::XRT_INFO)) {
+                for (unsigned i = 0; i < regSize; i++) {
+                    xrt_logmsg(XRT_INFO, "%s: space: %d, offset:0x%llx, reg:%u",
+                        __func__, space, (unsigned long long)offset+i, reg[i]);
+                }
             }
             return !result ? size : 0;
         }
@@ -943,7 +1123,7 @@ int shim::xclCopyBO(unsigned int dst_bo_handle,
     unsigned int src_bo_handle, size_t size, size_t dst_offset,
     size_t src_offset)
 {
-    return (!mDev->get_sysfs_path("m2m", "").empty()) ?
+    return mCoreDevice->get_capabilities().m2m ?
         m2mCopyBO(dst_bo_handle, src_bo_handle, size, dst_offset, src_offset) :
         execbufCopyBO(dst_bo_handle, src_bo_handle, size, dst_offset, src_offset);
 }
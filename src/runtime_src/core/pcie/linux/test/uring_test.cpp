@@ -0,0 +1,315 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Host test of the io_uring ring used by streaming queues, run
+// against a pipe and a regular file instead of a QDMA queue, and of
+// the i/o slot accounting of the queues.
+//
+// % uring_test
+//
+// Ring tests are skipped when the kernel or build headers lack io_uring.
+
+#include "../uring.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Header plus payload, as a streaming queue request is sent
+struct request
+{
+  uint64_t header;
+  std::string payload;
+  struct iovec iov[2];
+
+  request(uint64_t h, size_t size)
+    : header(h), payload(size, static_cast<char>('a' + h % 26))
+  {
+    iov[0] = { &header, sizeof(header) };
+    iov[1] = { &payload[0], payload.size() };
+  }
+
+  size_t
+  size() const
+  {
+    return sizeof(header) + payload.size();
+  }
+};
+
+class Uring : public ::testing::Test
+{
+protected:
+  void
+  SetUp() override
+  {
+    xocl::uring probe;
+    int rc = probe.setup(1);
+    if (rc)
+      GTEST_SKIP() << "io_uring not supported: " << strerror(-rc);
+  }
+};
+
+// Prepare a request in a free slot, as the queue does
+bool
+prep(xocl::uring& ring, xocl::uring_slots& slots, bool write, int fd,
+     const struct iovec* iov, unsigned nr)
+{
+  unsigned slot;
+  if (!slots.next(slot))
+    return false;
+  if (!ring.prep_rw(write, fd, iov, nr, slot))
+    return false;
+  slots.prepared();
+  return true;
+}
+
+// Writes go through the ring into a pipe and are read back through the
+// ring, user data comes back with each completion
+TEST_F(Uring, Pipe)
+{
+  xocl::uring ring;
+  ASSERT_EQ(ring.setup(8), 0);
+  EXPECT_TRUE(ring.enabled());
+  EXPECT_GE(ring.capacity(), 8u);
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  request req(7, 1000);
+  EXPECT_TRUE(ring.prep_rw(true, fds[1], req.iov, 2, 0x1234));
+  EXPECT_EQ(ring.submit(), 1);
+
+  xocl::uring::completion comp[4];
+  ASSERT_EQ(ring.reap(1, 4, comp, 0), 1);
+  EXPECT_EQ(comp[0].data, 0x1234u);
+  EXPECT_EQ(comp[0].res, static_cast<int>(req.size()));
+
+  uint64_t header = 0;
+  std::string payload(req.payload.size(), '\0');
+  struct iovec iov[2] = {{ &header, sizeof(header) }, { &payload[0], payload.size() }};
+  EXPECT_TRUE(ring.prep_rw(false, fds[0], iov, 2, 0x5678));
+  EXPECT_EQ(ring.submit(), 1);
+  ASSERT_EQ(ring.reap(1, 4, comp, 0), 1);
+  EXPECT_EQ(comp[0].data, 0x5678u);
+  EXPECT_EQ(comp[0].res, static_cast<int>(req.size()));
+  EXPECT_EQ(header, req.header);
+  EXPECT_EQ(payload, req.payload);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// A read of an empty pipe stays in flight: reap with a timeout returns
+// nothing, and completes once data is written
+TEST_F(Uring, Timeout)
+{
+  xocl::uring ring;
+  ASSERT_EQ(ring.setup(4), 0);
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  char buf[16];
+  struct iovec iov = { buf, sizeof(buf) };
+  EXPECT_TRUE(ring.prep_rw(false, fds[0], &iov, 1, 1));
+  EXPECT_EQ(ring.submit(), 1);
+
+  xocl::uring::completion comp;
+  auto begin = std::chrono::steady_clock::now();
+  EXPECT_EQ(ring.reap(1, 1, &comp, 20), 0);
+  EXPECT_GE(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(20));
+
+  ASSERT_EQ(write(fds[1], "hello", 5), 5);
+  ASSERT_EQ(ring.reap(1, 1, &comp, 0), 1);
+  EXPECT_EQ(comp.data, 1u);
+  EXPECT_EQ(comp.res, 5);
+  EXPECT_EQ(std::string(buf, 5), "hello");
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// Batched requests against a regular file go out with one submit; the
+// ring takes no more than its entries until they are submitted
+TEST_F(Uring, File)
+{
+  char name[] = "/tmp/uring_testXXXXXX";
+  int fd = mkstemp(name);
+  ASSERT_GE(fd, 0);
+  unlink(name);
+
+  xocl::uring ring;
+  ASSERT_EQ(ring.setup(16), 0);
+
+  // prep_rw targets offset 0, every write lands on the same range
+  std::vector<request> reqs;
+  for (uint64_t i = 0; i < 16; ++i)
+    reqs.emplace_back(i, 4096);
+  for (uint64_t i = 0; i < 16; ++i)
+    EXPECT_TRUE(ring.prep_rw(true, fd, reqs[i].iov, 2, i));
+  request extra(99, 4096);
+  EXPECT_FALSE(ring.prep_rw(true, fd, extra.iov, 2, 99));
+  EXPECT_EQ(ring.submit(), 16);
+
+  std::vector<xocl::uring::completion> comps(32);
+  int n = 0;
+  while (n < 16) {
+    int rc = ring.reap(16 - n, comps.size() - n, comps.data() + n, 0);
+    ASSERT_GT(rc, 0);
+    n += rc;
+  }
+  EXPECT_EQ(n, 16);
+
+  uint64_t seen = 0;
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(comps[i].res, static_cast<int>(reqs[comps[i].data].size()));
+    seen |= 1ULL << comps[i].data;
+  }
+  EXPECT_EQ(seen, 0xFFFFu);
+
+  struct stat sb;
+  ASSERT_EQ(fstat(fd, &sb), 0);
+  EXPECT_EQ(static_cast<size_t>(sb.st_size), extra.size());
+
+  // Read back with the ring, the content is one of the writes
+  uint64_t header = 0;
+  std::string payload(4096, '\0');
+  struct iovec iov[2] = {{ &header, sizeof(header) }, { &payload[0], payload.size() }};
+  EXPECT_TRUE(ring.prep_rw(false, fd, iov, 2, 100));
+  EXPECT_EQ(ring.submit(), 1);
+  ASSERT_EQ(ring.reap(1, 1, comps.data(), 0), 1);
+  EXPECT_EQ(comps[0].data, 100u);
+  EXPECT_EQ(comps[0].res, static_cast<int>(extra.size()));
+  ASSERT_LT(header, 16u);
+  EXPECT_EQ(payload, reqs[header].payload);
+
+  // Errors come back as -errno in the completion
+  int wronly = open("/dev/null", O_WRONLY);
+  EXPECT_TRUE(ring.prep_rw(false, wronly, iov, 2, 101));
+  EXPECT_EQ(ring.submit(), 1);
+  ASSERT_EQ(ring.reap(1, 1, comps.data(), 0), 1);
+  EXPECT_EQ(comps[0].data, 101u);
+  EXPECT_EQ(comps[0].res, -EBADF);
+  close(wronly);
+
+  close(fd);
+}
+
+// Slots of requests the kernel did not take are free again, slots in
+// flight come back with their completion
+TEST(UringSlots, Accounting)
+{
+  xocl::uring_slots slots;
+  slots.reset(4);
+  EXPECT_EQ(slots.size(), 4u);
+  EXPECT_TRUE(slots.idle());
+
+  std::vector<unsigned> taken;
+  unsigned slot;
+  while (slots.next(slot)) {
+    taken.push_back(slot);
+    slots.prepared();
+  }
+  ASSERT_EQ(taken.size(), 4u);
+  EXPECT_EQ(slots.available(), 0u);
+  std::vector<unsigned> sorted(taken);
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(sorted, (std::vector<unsigned>{0, 1, 2, 3}));
+
+  // Kernel took the first two, the last two are free
+  slots.submitted(2);
+  EXPECT_EQ(slots.available(), 2u);
+  EXPECT_FALSE(slots.idle());
+  ASSERT_TRUE(slots.next(slot));
+  EXPECT_TRUE(slot == taken[2] || slot == taken[3]);
+
+  slots.completed(taken[1]);
+  slots.completed(taken[0]);
+  EXPECT_TRUE(slots.idle());
+
+  // Failed submission frees every prepared slot
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(slots.next(slot));
+    slots.prepared();
+  }
+  slots.submitted(-EAGAIN);
+  EXPECT_TRUE(slots.idle());
+
+  // Nothing submitted frees them too
+  ASSERT_TRUE(slots.next(slot));
+  slots.prepared();
+  slots.submitted(0);
+  EXPECT_TRUE(slots.idle());
+}
+
+// Queue path: a full submission ring leaves the slot free, completions
+// through the ring free the slots of submitted requests
+TEST_F(Uring, Slots)
+{
+  xocl::uring ring;
+  ASSERT_EQ(ring.setup(2), 0);
+  xocl::uring_slots slots;
+  slots.reset(ring.capacity());
+  ASSERT_GT(slots.size(), 2u);
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  std::vector<request> reqs;
+  for (uint64_t i = 0; i < 3; ++i)
+    reqs.emplace_back(i, 100);
+  EXPECT_TRUE(prep(ring, slots, true, fds[1], reqs[0].iov, 2));
+  EXPECT_TRUE(prep(ring, slots, true, fds[1], reqs[1].iov, 2));
+  EXPECT_FALSE(prep(ring, slots, true, fds[1], reqs[2].iov, 2));
+  EXPECT_EQ(slots.available(), slots.size() - 2);
+
+  int submitted = ring.submit();
+  EXPECT_EQ(submitted, 2);
+  slots.submitted(submitted);
+  EXPECT_EQ(slots.available(), slots.size() - 2);
+
+  // The ring has room again
+  EXPECT_TRUE(prep(ring, slots, true, fds[1], reqs[2].iov, 2));
+  submitted = ring.submit();
+  EXPECT_EQ(submitted, 1);
+  slots.submitted(submitted);
+  EXPECT_EQ(slots.available(), slots.size() - 3);
+
+  std::vector<xocl::uring::completion> comps(slots.size());
+  int n = 0;
+  while (n < 3) {
+    int rc = ring.reap(3 - n, comps.size(), comps.data(), 0);
+    ASSERT_GT(rc, 0);
+    for (int i = 0; i < rc; ++i) {
+      EXPECT_LT(comps[i].data, slots.size());
+      EXPECT_EQ(comps[i].res, static_cast<int>(reqs[0].size()));
+      slots.completed(comps[i].data);
+    }
+    n += rc;
+  }
+  EXPECT_TRUE(slots.idle());
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+} // namespace
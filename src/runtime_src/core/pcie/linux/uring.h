@@ -0,0 +1,390 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XOCL_URING_H_
+#define _XOCL_URING_H_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#if defined(__has_include)
+# if __has_include(<linux/io_uring.h>)
+#  include <linux/io_uring.h>
+#  define XOCL_HAVE_URING 1
+# endif
+#endif
+
+#ifdef XOCL_HAVE_URING
+# ifndef __NR_io_uring_setup
+#  define __NR_io_uring_setup 425
+# endif
+# ifndef __NR_io_uring_enter
+#  define __NR_io_uring_enter 426
+# endif
+#endif
+
+namespace xocl {
+
+/*
+ * uring: minimal io_uring submission/completion ring for stream queues.
+ *
+ * Requests are prepared into the submission ring with prep_rw() and
+ * handed to the kernel with one io_uring_enter() by submit(), rather
+ * than one io_submit() per request with Linux AIO. Completions are read
+ * from the shared completion ring without a system call when available.
+ *
+ * Submission (prep_rw, submit) and completion (reap) may be called from
+ * different threads, but each side must be serialized by the caller.
+ * The iovec and the buffers it points to must stay valid until the
+ * request completes.
+ *
+ * If the kernel or the build headers do not support io_uring, setup()
+ * fails and the caller is expected to fall back to Linux AIO.
+ */
+class uring {
+public:
+    struct completion {
+        uint64_t data;	/* user data of the request */
+        int res;	/* bytes transferred or -errno */
+    };
+
+#ifdef XOCL_HAVE_URING
+private:
+    int ringFd;
+    unsigned sqEntries;
+    unsigned cqEntries;
+
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+
+    unsigned sqLocalTail;	/* prepared, not yet submitted */
+
+    static int enter(int fd, unsigned to_submit, unsigned min_complete,
+                     unsigned flags)
+    {
+        return syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                       flags, nullptr, 0);
+    }
+
+    template <typename T>
+    static T *ring_ptr(void *ring, unsigned offset)
+    {
+        return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+    }
+
+    void release(void)
+    {
+        if (sqes)
+            munmap(sqes, sqesSize);
+        if (cqRing && cqRing != sqRing)
+            munmap(cqRing, cqRingSize);
+        if (sqRing)
+            munmap(sqRing, sqRingSize);
+        if (ringFd >= 0)
+            close(ringFd);
+        ringFd = -1;
+        sqRing = cqRing = nullptr;
+        sqes = nullptr;
+    }
+
+    /* copy available completions, returns number copied */
+    unsigned harvest(completion *comps, unsigned max)
+    {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        unsigned n = 0;
+
+        while (head != tail && n < max) {
+            struct io_uring_cqe *cqe = &cqes[head & *cqMask];
+            comps[n].data = cqe->user_data;
+            comps[n].res = cqe->res;
+            head++;
+            n++;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        return n;
+    }
+
+public:
+    uring()
+        : ringFd{-1}, sqEntries{0}, cqEntries{0},
+          sqRing{nullptr}, sqRingSize{0}, cqRing{nullptr}, cqRingSize{0},
+          sqes{nullptr}, sqesSize{0}, sqHead{nullptr}, sqTail{nullptr},
+          sqMask{nullptr}, sqArray{nullptr}, cqHead{nullptr}, cqTail{nullptr},
+          cqMask{nullptr}, cqes{nullptr}, sqLocalTail{0}
+    {}
+
+    ~uring()
+    {
+        release();
+    }
+
+    uring(const uring&) = delete;
+    uring& operator=(const uring&) = delete;
+
+    // Create the ring, returns 0 or -errno
+    int setup(unsigned entries)
+    {
+        struct io_uring_params p;
+        memset(&p, 0, sizeof(p));
+
+        int fd = syscall(__NR_io_uring_setup, entries, &p);
+        if (fd < 0)
+            return -errno;
+        ringFd = fd;
+
+        sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+        bool single = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+            single = true;
+            if (cqRingSize > sqRingSize)
+                sqRingSize = cqRingSize;
+            cqRingSize = sqRingSize;
+        }
+#endif
+
+        void *ring = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (ring == MAP_FAILED) {
+            int err = -errno;
+            release();
+            return err;
+        }
+        sqRing = ring;
+
+        if (single) {
+            cqRing = sqRing;
+        } else {
+            ring = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (ring == MAP_FAILED) {
+                int err = -errno;
+                release();
+                return err;
+            }
+            cqRing = ring;
+        }
+
+        sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+        ring = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (ring == MAP_FAILED) {
+            int err = -errno;
+            release();
+            return err;
+        }
+        sqes = static_cast<struct io_uring_sqe *>(ring);
+
+        sqHead = ring_ptr<unsigned>(sqRing, p.sq_off.head);
+        sqTail = ring_ptr<unsigned>(sqRing, p.sq_off.tail);
+        sqMask = ring_ptr<unsigned>(sqRing, p.sq_off.ring_mask);
+        sqArray = ring_ptr<unsigned>(sqRing, p.sq_off.array);
+        cqHead = ring_ptr<unsigned>(cqRing, p.cq_off.head);
+        cqTail = ring_ptr<unsigned>(cqRing, p.cq_off.tail);
+        cqMask = ring_ptr<unsigned>(cqRing, p.cq_off.ring_mask);
+        cqes = ring_ptr<struct io_uring_cqe>(cqRing, p.cq_off.cqes);
+
+        sqEntries = p.sq_entries;
+        cqEntries = p.cq_entries;
+        sqLocalTail = *sqTail;
+        return 0;
+    }
+
+    bool enabled(void) const { return ringFd >= 0; }
+
+    // Max requests in flight without overflowing the completion ring
+    unsigned capacity(void) const { return cqEntries; }
+
+    // Prepare a readv/writev at offset 0, returns false if the
+    // submission ring is full
+    bool prep_rw(bool write, int fd, const struct iovec *iov, unsigned nr,
+                 uint64_t data)
+    {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqLocalTail - head >= sqEntries)
+            return false;
+
+        unsigned idx = sqLocalTail & *sqMask;
+        struct io_uring_sqe *sqe = &sqes[idx];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(iov);
+        sqe->len = nr;
+        sqe->off = 0;
+        sqe->user_data = data;
+        sqArray[idx] = idx;
+        sqLocalTail++;
+        return true;
+    }
+
+    // Submit all prepared requests with one system call. Returns the
+    // number submitted, the first ones prepared, or -errno. Requests
+    // the kernel did not take are dropped.
+    int submit(void)
+    {
+        unsigned tail = *sqTail;
+        unsigned count = sqLocalTail - tail;
+        if (!count)
+            return 0;
+
+        __atomic_store_n(sqTail, sqLocalTail, __ATOMIC_RELEASE);
+        int rc = enter(ringFd, count, 0, 0);
+        int err = (rc < 0) ? -errno : 0;
+
+        /* withdraw what the kernel did not consume */
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (head != sqLocalTail) {
+            sqLocalTail = head;
+            __atomic_store_n(sqTail, head, __ATOMIC_RELEASE);
+        }
+
+        if (err)
+            return err;
+        return rc;
+    }
+
+    // Wait for at least min_compl completions and copy up to max_compl.
+    // A timeout <= 0 waits until min_compl are available. Returns the
+    // number copied, which is less than min_compl on timeout, or -errno.
+    int reap(unsigned min_compl, unsigned max_compl, completion *comps,
+             int timeout /*ms*/)
+    {
+        using clock = std::chrono::steady_clock;
+        auto deadline = clock::now() + std::chrono::milliseconds(timeout);
+        unsigned n = harvest(comps, max_compl);
+
+        while (n < min_compl) {
+            if (timeout > 0) {
+                auto left = std::chrono::duration_cast<std::chrono::microseconds>
+                    (deadline - clock::now()).count();
+                if (left <= 0)
+                    break;
+                /* round up, poll() must not return before the deadline */
+                struct pollfd pfd = { ringFd, POLLIN, 0 };
+                if (poll(&pfd, 1, static_cast<int>((left + 999) / 1000)) < 0 && errno != EINTR)
+                    return -errno;
+            } else if (enter(ringFd, 0, min_compl - n,
+                             IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                return -errno;
+            }
+            n += harvest(comps + n, max_compl - n);
+        }
+        return n;
+    }
+#else
+public:
+    int setup(unsigned) { return -ENOSYS; }
+    bool enabled(void) const { return false; }
+    unsigned capacity(void) const { return 0; }
+    bool prep_rw(bool, int, const struct iovec *, unsigned, uint64_t)
+    { return false; }
+    int submit(void) { return -ENOSYS; }
+    int reap(unsigned, unsigned, completion *, int) { return -ENOSYS; }
+#endif
+};
+
+/*
+ * uring_slots: i/o slots of a queue using uring.
+ *
+ * Every request in flight owns a slot, its index is the user data of the
+ * request so that the completion finds the slot again. A slot is taken
+ * with next() and prepared(), given back by submitted() if the kernel
+ * did not take its request and by completed() once the request is done.
+ * Calling functions serialize access.
+ */
+class uring_slots {
+private:
+    std::vector<unsigned> freeSlots;	/* free slots */
+    std::vector<unsigned> prepSlots;	/* prepared, not submitted */
+    unsigned total;
+
+public:
+    uring_slots() : total{0} {}
+
+    void reset(unsigned count)
+    {
+        total = count;
+        freeSlots.clear();
+        freeSlots.reserve(count);
+        for (unsigned i = count; i > 0; i--)
+            freeSlots.push_back(i - 1);
+        prepSlots.clear();
+        prepSlots.reserve(count);
+    }
+
+    unsigned size(void) const { return total; }
+    unsigned available(void) const { return freeSlots.size(); }
+    bool idle(void) const { return freeSlots.size() == total; }
+
+    // Slot for the next request, false if all slots are in use
+    bool next(unsigned &slot) const
+    {
+        if (freeSlots.empty())
+            return false;
+        slot = freeSlots.back();
+        return true;
+    }
+
+    // The request of the slot from next() is in the submission ring
+    void prepared(void)
+    {
+        prepSlots.push_back(freeSlots.back());
+        freeSlots.pop_back();
+    }
+
+    // The first count prepared requests were submitted, or -errno
+    void submitted(int count)
+    {
+        unsigned done = (count > 0) ? count : 0;
+        for (unsigned i = done; i < prepSlots.size(); i++)
+            freeSlots.push_back(prepSlots[i]);
+        prepSlots.clear();
+    }
+
+    void completed(unsigned slot)
+    {
+        freeSlots.push_back(slot);
+    }
+};
+
+} // namespace xocl
+
+#endif
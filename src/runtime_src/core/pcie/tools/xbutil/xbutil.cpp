@@ -170,6 +170,27 @@ inline bool getenv_or_null(const char* env)
     return getenv(env) ? true : false;
 }
 
+/* comma separated list of non zero values, e.g. 1,2,4 */
+static bool parseBenchList(const std::string& str, std::vector<unsigned>& values)
+{
+    values.clear();
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t idx = 0;
+        unsigned long value = 0;
+        try {
+            value = std::stoul(item, &idx, 0);
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (idx < item.size() || value == 0 || value > 1024)
+            return false;
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
 int main(int argc, char *argv[])
 {
     unsigned index = 0xffffffff;
@@ -181,6 +202,9 @@ int main(int argc, char *argv[])
     unsigned int pattern_byte = 'J';//Rather than zero; writing char 'J' by default
     size_t sizeInBytes = 0;
     std::string outMemReadFile = "memread.out";
+    std::string benchOutFile;
+    xcldev::DMABench::config benchConfig;
+    bool benchOptions = false;
     std::string flashType = ""; // unset and empty by default
     std::string mcsFile1, mcsFile2;
     std::string xclbin;
@@ -293,6 +317,10 @@ int main(int argc, char *argv[])
         {"monitorfifofull", no_argument, 0, xcldev::STATUS_UNSUPPORTED},
         {"accelmonitor", no_argument, 0, xcldev::STATUS_AM},
         {"stream", no_argument, 0, xcldev::STREAM},
+        {"bench", no_argument, 0, xcldev::DMATEST_BENCH},
+        {"threads", required_argument, 0, xcldev::DMATEST_BENCH_THREADS},
+        {"queue-depth", required_argument, 0, xcldev::DMATEST_BENCH_QUEUE_DEPTH},
+        {"mix", required_argument, 0, xcldev::DMATEST_BENCH_MIX},
         {0, 0, 0, 0}
     };
 
@@ -325,6 +353,54 @@ int main(int argc, char *argv[])
             subcmd = xcldev::MEM_WRITE;
             break;
         }
+        case xcldev::DMATEST_BENCH : {
+            //--bench
+            if (cmd != xcldev::DMATEST) {
+                std::cout << "ERROR: Option '" << long_options[long_index].name << "' cannot be used with command " << cmdname << "\n";
+                return -1;
+            }
+            subcmd = xcldev::DMATEST_BENCH;
+            break;
+        }
+        case xcldev::DMATEST_BENCH_THREADS :
+        case xcldev::DMATEST_BENCH_QUEUE_DEPTH : {
+            //--threads, --queue-depth
+            if (cmd != xcldev::DMATEST) {
+                std::cout << "ERROR: Option '" << long_options[long_index].name << "' cannot be used with command " << cmdname << "\n";
+                return -1;
+            }
+            auto& values = (c == xcldev::DMATEST_BENCH_THREADS) ? benchConfig.threads : benchConfig.queueDepths;
+            if (!parseBenchList(optarg, values)) {
+                std::cout << "ERROR: Value supplied to --" << long_options[long_index].name << " option is invalid\n";
+                return -1;
+            }
+            benchOptions = true;
+            break;
+        }
+        case xcldev::DMATEST_BENCH_MIX : {
+            //--mix
+            if (cmd != xcldev::DMATEST) {
+                std::cout << "ERROR: Option '" << long_options[long_index].name << "' cannot be used with command " << cmdname << "\n";
+                return -1;
+            }
+            benchConfig.mixes.clear();
+            std::stringstream ss(optarg);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                xcldev::DMABench::mix dir;
+                if (!xcldev::DMABench::parse_mix(item, dir)) {
+                    std::cout << "ERROR: Value supplied to --mix option is invalid, use write, read or bidir\n";
+                    return -1;
+                }
+                benchConfig.mixes.push_back(dir);
+            }
+            if (benchConfig.mixes.empty()) {
+                std::cout << "ERROR: Value supplied to --mix option is invalid, use write, read or bidir\n";
+                return -1;
+            }
+            benchOptions = true;
+            break;
+        }
         case xcldev::STATUS_LAPC : {
             //--lapc
             if (cmd != xcldev::STATUS) {
@@ -405,11 +481,15 @@ int main(int argc, char *argv[])
             break;
         }
         case 'o': {
-            if (cmd != xcldev::MEM || subcmd != xcldev::MEM_READ) {
+            if ((cmd != xcldev::MEM || subcmd != xcldev::MEM_READ) &&
+                (cmd != xcldev::DMATEST || subcmd != xcldev::DMATEST_BENCH)) {
                 std::cout << "ERROR: '-o' not applicable for this command\n";
                 return -1;
             }
-            outMemReadFile = optarg;
+            if (cmd == xcldev::DMATEST)
+                benchOutFile = optarg;
+            else
+                outMemReadFile = optarg;
             break;
         }
         case 'e': {
@@ -551,6 +631,11 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    if (benchOptions && subcmd != xcldev::DMATEST_BENCH) {
+        std::cout << "ERROR: '--threads', '--queue-depth' and '--mix' require '--bench'\n";
+        return -1;
+    }
+
     if (index == 0xffffffff) index = 0;
 
     if (regionIndex == 0xffffffff) regionIndex = 0;
@@ -673,7 +758,30 @@ int main(int argc, char *argv[])
         result = deviceVec[index]->run(regionIndex, computeIndex);
         break;
     case xcldev::DMATEST:
-        result = deviceVec[index]->dmatest(blockSize, true);
+        if (subcmd == xcldev::DMATEST_BENCH) {
+            if (blockSize)
+                benchConfig.blockSizes = {blockSize};
+            if (benchOutFile.empty()) {
+                result = deviceVec[index]->dmabench(benchConfig, std::cout);
+            }
+            else {
+                std::ofstream ofs(benchOutFile);
+                if (!ofs.is_open()) {
+                    std::cerr << "ERROR: Unable to open " << benchOutFile << " for writing: " << strerror(errno) << std::endl;
+                    result = -EINVAL;
+                    break;
+                }
+                result = deviceVec[index]->dmabench(benchConfig, ofs);
+                ofs.close();
+                if (!result && ofs.fail()) {
+                    std::cerr << "ERROR: Failed to write " << benchOutFile << std::endl;
+                    result = -EIO;
+                }
+            }
+        }
+        else {
+            result = deviceVec[index]->dmatest(blockSize, true);
+        }
         break;
     case xcldev::MEM:
         if (subcmd == xcldev::MEM_READ) {
@@ -732,6 +840,8 @@ void xcldev::printHelp(const std::string& exe)
     std::cout << "Command and option summary:\n";
     std::cout << "  clock   [-d card] [-r region] [-f clock1_freq_MHz] [-g clock2_freq_MHz] [-h clock3_freq_MHz]\n";
     std::cout << "  dmatest [-d card] [-b [0x]block_size_KB]\n";
+    std::cout << "  dmatest --bench [-d card] [-b [0x]block_size_KB] [--threads n[,n..]] [--queue-depth n[,n..]]\n";
+    std::cout << "                  [--mix write|read|bidir[,..]] [-o output json file]\n";
     std::cout << "  dump\n";
     std::cout << "  help\n";
     std::cout << "  m2mtest [-d card]\n";
@@ -771,6 +881,8 @@ void xcldev::printHelp(const std::string& exe)
     std::cout << "  " << exe << " program -d 2 -p a.xclbin\n";
     std::cout << "Run DMA test on card 1 with 32 KB blocks of buffer\n";
     std::cout << "  " << exe << " dmatest -d 1 -b 0x20\n";
+    std::cout << "Run DMA benchmark on card 0 with 1 and 4 threads, queue depth 2, reads only, into bench.json\n";
+    std::cout << "  " << exe << " dmatest --bench --threads 1,4 --queue-depth 2 --mix read -o bench.json\n";
     std::cout << "Read 256 bytes from DDR/HBM/PLRAM starting at 0x1000 into file read.out\n";
     std::cout << "  " << exe << " mem --read -a 0x1000 -i 256 -o read.out\n";
     std::cout << "  " << "Default values for address is 0x0, size is DDR size and file is memread.out\n";
@@ -105,6 +105,10 @@ enum subcommand {
     STREAM,
     STATUS_UNSUPPORTED,
     STATUS_AM,
+    DMATEST_BENCH,
+    DMATEST_BENCH_THREADS,
+    DMATEST_BENCH_QUEUE_DEPTH,
+    DMATEST_BENCH_MIX,
 };
 enum statusmask {
     STATUS_NONE_MASK = 0x0,
@@ -1702,12 +1706,75 @@ public:
         return result;
     }
 
-    int memread(std::string aFilename, unsigned long long aStartAddr = 0, unsigned long long aSize = 0)
+    /*
+     * dmabench
+     *
+     * Run the DMA benchmark sweep on every used memory bank and write
+     * the results as JSON.  Errors go to stderr so they do not mix
+     * with the JSON output.
+     */
+    int dmabench(const DMABench::config& cfg, std::ostream& ostr) {
+        xclbin_lock xclbin_lock(m_handle, m_idx);
+
+        std::vector<char> buf;
+        std::string errmsg;
+        pcidev::get_dev(m_idx)->sysfs_get("icap", "mem_topology", errmsg, buf);
+        if (!errmsg.empty()) {
+            std::cerr << errmsg << std::endl;
+            return -EINVAL;
+        }
+        const mem_topology *map = (mem_topology *)buf.data();
+        if(buf.empty() || map->m_count == 0) {
+            std::cerr << "WARNING: 'mem_topology' invalid, "
+                << "unable to perform DMA benchmark. Has the bitstream been loaded?" << std::endl;
+            return -EINVAL;
+        }
+
+        boost::property_tree::ptree pt_banks;
+        for(int32_t i = 0; i < map->m_count; i++) {
+            if(!map->m_mem_data[i].m_used || map->m_mem_data[i].m_type == MEM_STREAMING)
+                continue;
+            if(!strncmp((const char*)map->m_mem_data[i].m_tag, "HOST", 4))
+                continue;
+
+            try {
+                DMABench bench(m_handle, i, cfg);
+                boost::property_tree::ptree pt_bank;
+                pt_bank.put("tag", (const char*)map->m_mem_data[i].m_tag);
+                pt_bank.put("index", i);
+                pt_bank.add_child("results", DMABench::to_ptree(bench.run()));
+                pt_banks.push_back(std::make_pair("", pt_bank));
+            } catch (const xrt_core::error &ex) {
+                std::cerr << "ERROR: " << ex.what() << std::endl;
+                return ex.get();
+            }
+        }
+
+        boost::property_tree::ptree pt;
+        pt.put("device", name());
+        pt.add_child("banks", pt_banks);
+        boost::property_tree::write_json(ostr, pt);
+        return 0;
+    }
+
+    int memread(std::string aFilename, unsigned long long aStartAddr = 0, unsigned long long aSize = 0,
+                size_t aChunkSize = 0, unsigned int aWorkers = 0, bool aDirectIO = false)
     {
         xclbin_lock xclbin_lock(m_handle, m_idx);
-        return memaccess(m_handle, get_ddr_mem_size(), getpagesize(),
-            pcidev::get_dev(m_idx)->sysfs_name).read(
-            aFilename, aStartAddr, aSize);
+        memaccess mem(m_handle, get_ddr_mem_size(), getpagesize(),
+            pcidev::get_dev(m_idx)->sysfs_name);
+        mem.setTransferOptions(aChunkSize, aWorkers, aDirectIO);
+        return mem.read(aFilename, aStartAddr, aSize);
+    }
+
+    int memwriteFile(std::string aFilename, unsigned long long aStartAddr = 0, unsigned long long aSize = 0,
+                     size_t aChunkSize = 0, unsigned int aWorkers = 0, bool aDirectIO = false)
+    {
+        xclbin_lock xclbin_lock(m_handle, m_idx);
+        memaccess mem(m_handle, get_ddr_mem_size(), getpagesize(),
+            pcidev::get_dev(m_idx)->sysfs_name);
+        mem.setTransferOptions(aChunkSize, aWorkers, aDirectIO);
+        return mem.writeFile(aFilename, aStartAddr, aSize);
     }
 
 
@@ -1789,6 +1856,11 @@ public:
      *           REQUIRED for deviceToFile
      * --skip : specify the source offset (in block counts)
      * --seek : specify the destination offset (in block counts)
+     * --threads : OPTIONAL number of threads moving blocks in parallel
+     * --direct : OPTIONAL bypass the page cache for file I/O (O_DIRECT)
+     *
+     * The copy is done as one transfer, a specified block size is used as
+     * transfer chunk size.
      */
     int do_dd(dd::ddArgs_t args )
     {
@@ -1797,55 +1869,30 @@ public:
         }
         if( args.dir == dd::unset ) {
             return -1; // direction invalid
-        } else if( args.dir == dd::deviceToFile ) {
-            unsigned long long addr = args.skip; // ddr read offset
-            while( args.count-- > 0 ) { // writes all full blocks
-                memread( args.file, addr, args.blockSize ); // returns 0 on complete read.
-                // how to check for partial reads when device is empty?
-                addr += args.blockSize;
-            }
-        } else if( args.dir == dd::fileToDevice ) {
-            // write entire contents of file to device DDR at seek offset.
-            unsigned long long addr = args.seek; // ddr write offset
-            std::ifstream iStream( args.file.c_str(), std::ifstream::binary );
-            if( !iStream ) {
-                perror( "open input file" );
-                return errno;
-            }
-            // If unspecified count, calculate the count from the full file size.
-            if( args.count <= 0 ) {
-                iStream.seekg( 0, iStream.end );
-                int length = iStream.tellg();
-                args.count = length / args.blockSize + 1; // round up
-                iStream.seekg( 0, iStream.beg );
-            }
-            iStream.seekg( 0, iStream.beg );
-
-            char *buf;
-            static char *inBuf;
-            size_t inSize;
+        }
 
-            inBuf = (char*)malloc( args.blockSize );
-            if( !inBuf ) {
-                perror( "malloc block size" );
-                return errno;
-            }
+        size_t blockSize = (args.blockSize > 0) ? args.blockSize : dd::defaultBS;
+        size_t chunkSize = (args.blockSize > 0) ? args.blockSize : 0; // 0 is transfer default
+        if( args.dir == dd::deviceToFile ) {
+            unsigned long long addr = (args.skip == ULLONG_MAX) ? 0 : args.skip; // ddr read offset
+            unsigned long long size = (unsigned long long)args.count * blockSize;
+            if( size == 0 )
+                return 0;
+            return (memread( args.file, addr, size, chunkSize, args.threads, args.direct ) < 0) ? -1 : 0;
+        }
 
-            while( args.count-- > 0 ) { // writes all full blocks
-                buf = inBuf;
-                inSize = iStream.read( inBuf, args.blockSize ).gcount();
-                if( (int)inSize == args.blockSize ) {
-                    // full read
-                } else {
-                    // Partial read--write size specified greater than read size. Writing remainder of input file.
-                    args.count = 0; // force break
-                }
-                memwrite( addr, inSize, buf );
-                addr += inSize;
-            }
-            iStream.close();
+        // write contents of file to device DDR at seek offset.
+        unsigned long long addr = (args.seek == ULLONG_MAX) ? 0 : args.seek; // ddr write offset
+        struct stat sb;
+        if( stat( args.file.c_str(), &sb ) < 0 ) {
+            perror( "open input file" );
+            return errno;
         }
-        return 0;
+        // If unspecified count, write the full file.
+        unsigned long long size = sb.st_size;
+        if( args.count > 0 )
+            size = std::min( size, (unsigned long long)args.count * blockSize );
+        return (memwriteFile( args.file, addr, size, chunkSize, args.threads, args.direct ) < 0) ? -1 : 0;
     }
 
     int usageInfo(xclDeviceUsage& devstat) const {
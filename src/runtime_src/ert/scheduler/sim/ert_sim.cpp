@@ -0,0 +1,792 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "ert_sim.h"
+#include "core/include/ert.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+// Firmware entry points, ERT_HW_EMU builds of scheduler.cpp and
+// scheduler_v30.cpp
+extern "C" {
+void scheduler_loop();
+void cu_interrupt_handler();
+void scheduler_v30_loop();
+void cu_interrupt_handler_v30();
+}
+
+namespace {
+
+using addr_type = uint32_t;
+using value_type = uint32_t;
+
+// HLS AXI-lite control bits
+const value_type AP_START = 0x1;
+const value_type AP_DONE  = 0x2;
+const value_type AP_IDLE  = 0x4;
+
+// CSR and INTC register offsets are the same for all firmware
+// variants, only the base addresses differ.
+const addr_type csr_status        = ERT_STATUS_REGISTER_ADDR0 - ERT_CSR_ADDR;
+const addr_type csr_cu_dma        = ERT_CU_DMA_REGISTER_ADDR0 - ERT_CSR_ADDR;
+const addr_type csr_cu_isr_enable = ERT_CU_ISR_HANDLER_ENABLE_ADDR - ERT_CSR_ADDR;
+const addr_type csr_cu_status     = ERT_CU_STATUS_REGISTER_ADDR0 - ERT_CSR_ADDR;
+const addr_type csr_cq_status     = ERT_CQ_STATUS_REGISTER_ADDR0 - ERT_CSR_ADDR;
+const addr_type csr_cudma_state   = ERT_CUDMA_STATE - ERT_CSR_ADDR;
+const addr_type csr_cuisr_state   = ERT_CUISR_STATE - ERT_CSR_ADDR;
+const addr_type csr_size          = 0x1000;
+
+const addr_type intc_isr = 0x0;
+const addr_type intc_ipr = ERT_INTC_IPR_ADDR - ERT_INTC_ADDR;
+const addr_type intc_ier = ERT_INTC_IER_ADDR - ERT_INTC_ADDR;
+const addr_type intc_iar = ERT_INTC_IAR_ADDR - ERT_INTC_ADDR;
+const addr_type intc_mer = ERT_INTC_MER_ADDR - ERT_INTC_ADDR;
+const addr_type intc_size = 0x20;
+
+// Base addresses per firmware variant, see core/include/ert.h.  The
+// v30 firmware reads ert_base_addr from ERT_BASE_ADDR, which reads as
+// 0 in the simulation.
+struct layout
+{
+  addr_type cq;
+  addr_type csr;
+  addr_type intc;
+  addr_type intc_cu;   // v30 per CU interrupt controllers
+};
+
+const layout legacy_layout = { ERT_CQ_BASE_ADDR, ERT_CSR_ADDR, ERT_INTC_ADDR, 0 };
+const layout v30_layout    = { 0x1F60000, 0x010000, 0x01F20000, 0x0000 };
+
+// Simulated CUs are placed at cu_base + (cu_idx << cu_offset)
+const addr_type cu_base = 0x01000000;
+const uint32_t cu_offset = 16;
+
+// Word index of the command tag in a CU register map.  The simulated
+// host writes the command id + 1 to the first argument so that the
+// CU can tell which command the firmware started.
+const uint32_t tag_word = 4;
+
+struct stop_simulation {};
+
+struct command
+{
+  uint32_t cu_idx = 0;
+  uint32_t slot_idx = 0;
+  uint64_t submit = 0;
+  uint64_t start = 0;
+  uint64_t done = 0;
+  uint64_t notify = 0;
+  bool started = false;
+  bool cu_done = false;
+  bool notified = false;
+};
+
+struct compute_unit
+{
+  value_type ctrl = AP_IDLE;
+  value_type gie = 0;
+  value_type ier = 0;
+  value_type tag = 0;
+  bool busy = false;
+  uint64_t cmd = 0;
+  uint64_t busy_since = 0;
+  uint64_t busy_cycles = 0;
+};
+
+struct intc_regs
+{
+  value_type isr = 0;
+  value_type ier = 0;
+  value_type mer = 0;
+};
+
+using event = std::pair<uint64_t, uint32_t>;
+using event_queue = std::priority_queue<event, std::vector<event>, std::greater<event>>;
+
+void
+validate(const ert_sim::config& cfg)
+{
+  if (cfg.num_cus < 1 || cfg.num_cus > 128)
+    throw std::runtime_error("number of cus must be in [1,128]");
+  if (cfg.slot_size < 0x200 || cfg.slot_size > ERT_CQ_SIZE || (cfg.slot_size & 0x3))
+    throw std::runtime_error("slot size must be a multiple of 4 in [0x200,0x10000]");
+  if (cfg.num_cus + 6 > cfg.slot_size / 4)
+    throw std::runtime_error("configure command does not fit in slot");
+  if (cfg.regmap_words <= tag_word || cfg.regmap_words + 2 > cfg.slot_size / 4)
+    throw std::runtime_error("register map must be more than 4 words and fit in slot");
+  if (cfg.fw == ert_sim::firmware::v30 && (cfg.cu_dma || cfg.cu_isr))
+    throw std::runtime_error("v30 firmware has no cu dma or cu isr");
+  if (cfg.fw == ert_sim::firmware::legacy && cfg.kds_30)
+    throw std::runtime_error("kds 3.0 requires v30 firmware");
+  if (cfg.num_cmds == 0)
+    throw std::runtime_error("number of commands must be non zero");
+}
+
+class simulator
+{
+  const ert_sim::config m_cfg;
+  const layout m_layout;
+  std::mt19937 m_rng;
+
+  uint64_t m_now = 0;
+  uint64_t m_start = 0;
+  uint32_t m_num_slots = 0;
+
+  // Command queue BRAM
+  std::vector<value_type> m_cq;
+
+  // CSR state that is not plain storage
+  value_type m_cu_status[4] = {0};
+  value_type m_cq_status[4] = {0};
+  value_type m_cu_isr_enabled = 0;
+
+  // Interrupt controllers
+  intc_regs m_intc;
+  intc_regs m_intc_cu[4];
+  bool m_irq_enabled = false;
+  bool m_in_isr = false;
+
+  // Everything else is plain storage
+  std::unordered_map<addr_type, value_type> m_regs;
+
+  std::vector<compute_unit> m_cus;
+  event_queue m_cu_events;    // (done time, cu_idx)
+  event_queue m_host_events;  // (submit time, slot_idx)
+
+  // Host side
+  std::vector<command> m_cmds;
+  std::vector<int64_t> m_slot_cmd;
+  bool m_config_submitted = false;
+  bool m_configured = false;
+  uint64_t m_completed = 0;
+  uint32_t m_occupied = 0;
+  uint64_t m_occupied_since = 0;
+  double m_occupied_area = 0;
+
+  ert_sim::stats m_stats;
+
+  void
+  error(std::string msg)
+  {
+    // Bound the error list, the first few are what matter
+    if (m_stats.errors.size() < 32)
+      m_stats.errors.push_back("cycle " + std::to_string(m_now) + ": " + std::move(msg));
+  }
+
+  bool
+  in_range(addr_type addr, addr_type base, addr_type size) const
+  {
+    return addr >= base && addr < base + size;
+  }
+
+  bool
+  is_cu(addr_type addr) const
+  {
+    return in_range(addr, cu_base, static_cast<addr_type>(m_cfg.num_cus) << cu_offset);
+  }
+
+  uint32_t
+  cu_idx(addr_type addr) const
+  {
+    return (addr - cu_base) >> cu_offset;
+  }
+
+  addr_type
+  slot_addr(uint32_t slot_idx) const
+  {
+    return m_layout.cq + slot_idx * m_cfg.slot_size;
+  }
+
+  value_type&
+  cq_word(addr_type addr)
+  {
+    return m_cq[(addr - m_layout.cq) >> 2];
+  }
+
+  void
+  update_occupancy(int delta)
+  {
+    m_occupied_area += static_cast<double>(m_occupied) * (m_now - m_occupied_since);
+    m_occupied_since = m_now;
+    m_occupied += delta;
+  }
+
+  // Interrupt inputs are level sensitive, re-raise any source that is
+  // still pending after the firmware acknowledged the controller.
+  void
+  update_irq_lines()
+  {
+    for (size_t w = 0; w < 4; ++w) {
+      if (m_cq_status[w])
+        m_intc.isr |= 0x1;
+      if (m_cu_status[w])
+        m_intc.isr |= 0x2;
+      if (m_intc_cu[w].isr & m_intc_cu[w].ier)
+        m_intc.isr |= (0x20 << w);
+    }
+  }
+
+  bool
+  irq_pending() const
+  {
+    return m_irq_enabled && !m_in_isr && m_intc.mer == 0x3 && (m_intc.isr & m_intc.ier);
+  }
+
+  void
+  advance(uint64_t cycles)
+  {
+    m_now += cycles;
+    if (m_cfg.max_cycles && m_now > m_cfg.max_cycles)
+      throw stop_simulation();
+
+    while (!m_cu_events.empty() && m_cu_events.top().first <= m_now) {
+      auto ev = m_cu_events.top();
+      m_cu_events.pop();
+      complete_cu(ev.second, ev.first);
+    }
+
+    while (!m_host_events.empty() && m_host_events.top().first <= m_now) {
+      auto ev = m_host_events.top();
+      m_host_events.pop();
+      submit(ev.second);
+    }
+  }
+
+  void
+  start_cu(uint32_t idx)
+  {
+    auto& cu = m_cus[idx];
+    if (cu.busy) {
+      error("cu(" + std::to_string(idx) + ") started while busy");
+      return;
+    }
+
+    auto id = static_cast<uint64_t>(cu.tag) - 1;
+    if (cu.tag == 0 || id >= m_cmds.size()) {
+      error("cu(" + std::to_string(idx) + ") started with unknown command tag " + std::to_string(cu.tag));
+      return;
+    }
+
+    auto& cmd = m_cmds[id];
+    if (cmd.started)
+      error("command " + std::to_string(id) + " started twice");
+    if (cmd.cu_idx != idx)
+      error("command " + std::to_string(id) + " assigned cu(" + std::to_string(cmd.cu_idx)
+            + ") started on cu(" + std::to_string(idx) + ")");
+
+    cmd.started = true;
+    cmd.start = m_now;
+
+    cu.busy = true;
+    cu.cmd = id;
+    cu.busy_since = m_now;
+    cu.ctrl = AP_START;
+
+    auto cycles = m_cfg.cu_cycles;
+    if (m_cfg.cu_jitter)
+      cycles += m_rng() % m_cfg.cu_jitter;
+    m_cu_events.emplace(m_now + cycles, idx);
+  }
+
+  void
+  complete_cu(uint32_t idx, uint64_t time)
+  {
+    auto& cu = m_cus[idx];
+    cu.busy = false;
+    cu.busy_cycles += time - cu.busy_since;
+
+    auto& cmd = m_cmds[cu.cmd];
+    cmd.cu_done = true;
+    cmd.done = time;
+
+    bool irq = cu.gie && cu.ier;
+    if (m_cfg.fw == ert_sim::firmware::legacy && irq && m_cu_isr_enabled) {
+      // CU ISR acknowledges the CU and records the completion
+      m_cu_status[idx >> 5] |= 1u << (idx & 0x1f);
+      cu.ctrl = AP_IDLE;
+    }
+    else if (m_cfg.fw == ert_sim::firmware::v30 && irq && m_cfg.kds_30) {
+      // v30 firmware expects a lone CU on bit 1 of the first controller
+      auto bit = (m_cfg.num_cus == 1) ? 0x2 : (1u << (idx & 0x1f));
+      m_intc_cu[idx >> 5].isr |= bit;
+      cu.ctrl = AP_DONE | AP_IDLE;
+    }
+    else {
+      cu.ctrl = AP_DONE | AP_IDLE;
+    }
+    update_irq_lines();
+  }
+
+  // CU DMA engine, transfers the register map of each slot in mask to
+  // the CU whose address the firmware wrote to the slot's CU section.
+  // ERT_HW_EMU firmware always uses the 5.2 addressing scheme.
+  void
+  cu_dma(uint32_t mask_idx, value_type mask)
+  {
+    for (uint32_t bit = 0; mask; mask >>= 1, ++bit) {
+      if (!(mask & 0x1))
+        continue;
+      auto slot_idx = (mask_idx << 5) + bit;
+      if (slot_idx >= m_num_slots) {
+        error("cu dma for invalid slot(" + std::to_string(slot_idx) + ")");
+        continue;
+      }
+      auto saddr = slot_addr(slot_idx);
+      auto cu_addr = cq_word(saddr + 4) << 2;
+      if (!is_cu(cu_addr)) {
+        error("cu dma to invalid cu address " + std::to_string(cu_addr));
+        continue;
+      }
+      auto header = cq_word(saddr);
+      auto cu_masks = 1 + ((header >> 10) & 0x3);
+      auto regmap = saddr + 4 + cu_masks * 4;
+      auto idx = cu_idx(cu_addr);
+      m_cus[idx].tag = cq_word(regmap + tag_word * 4);
+      start_cu(idx);
+    }
+  }
+
+  void
+  host_notify(uint32_t mask_idx, value_type mask)
+  {
+    for (uint32_t bit = 0; mask; mask >>= 1, ++bit) {
+      if (!(mask & 0x1))
+        continue;
+      auto slot_idx = (mask_idx << 5) + bit;
+
+      if (!m_configured) {
+        if (slot_idx == 0 && m_config_submitted)
+          configured();
+        else
+          error("unexpected notification for slot(" + std::to_string(slot_idx) + ") before configure");
+        continue;
+      }
+
+      if (slot_idx >= m_num_slots || m_slot_cmd[slot_idx] < 0) {
+        error("notification for idle slot(" + std::to_string(slot_idx) + ")");
+        continue;
+      }
+
+      auto id = m_slot_cmd[slot_idx];
+      auto& cmd = m_cmds[id];
+      if (!cmd.cu_done)
+        error("command " + std::to_string(id) + " notified before its cu completed");
+
+      cmd.notified = true;
+      cmd.notify = m_now;
+      ++m_completed;
+      m_slot_cmd[slot_idx] = -1;
+      update_occupancy(-1);
+
+      if (m_cmds.size() < m_cfg.num_cmds)
+        m_host_events.emplace(m_now + m_cfg.host_cycles, slot_idx);
+    }
+  }
+
+  void
+  submit_configure()
+  {
+    m_config_submitted = true;
+
+    auto saddr = slot_addr(0);
+    value_type features = 0x1;
+    if (m_cfg.cu_dma)
+      features |= 0x4;
+    if (m_cfg.cu_isr)
+      features |= 0x8;
+    if (m_cfg.cq_int)
+      features |= 0x10;
+    if (m_cfg.kds_30)
+      features |= 0x100;
+
+    cq_word(saddr + 0x4) = m_cfg.slot_size;
+    cq_word(saddr + 0x8) = m_cfg.num_cus;
+    cq_word(saddr + 0xC) = cu_offset;
+    cq_word(saddr + 0x10) = cu_base;
+    cq_word(saddr + 0x14) = features;
+    for (uint32_t i = 0; i < m_cfg.num_cus; ++i)
+      cq_word(saddr + 0x18 + (i << 2)) = cu_base + (i << cu_offset); // ap_ctrl_hs
+
+    value_type count = 5 + m_cfg.num_cus;
+    cq_word(saddr) = ERT_CMD_STATE_NEW | (count << 12) | (ERT_CONFIGURE << 23) | (ERT_CTRL << 28);
+  }
+
+  void
+  configured()
+  {
+    m_configured = true;
+    m_start = m_now;
+    m_occupied_since = m_now;
+    m_slot_cmd.assign(m_num_slots, -1);
+    for (uint32_t slot_idx = 0; slot_idx < m_num_slots; ++slot_idx)
+      m_host_events.emplace(m_now + m_cfg.host_cycles, slot_idx);
+  }
+
+  void
+  submit(uint32_t slot_idx)
+  {
+    if (m_cmds.size() >= m_cfg.num_cmds)
+      return;
+
+    if (m_slot_cmd[slot_idx] >= 0) {
+      error("host submit to busy slot(" + std::to_string(slot_idx) + ")");
+      return;
+    }
+
+    auto id = m_cmds.size();
+    m_cmds.emplace_back();
+    auto& cmd = m_cmds.back();
+    cmd.cu_idx = id % m_cfg.num_cus;
+    cmd.slot_idx = slot_idx;
+    cmd.submit = m_now;
+    m_slot_cmd[slot_idx] = id;
+
+    // Payload, then header last as the host driver does
+    auto saddr = slot_addr(slot_idx);
+    cq_word(saddr + 4) = cmd.cu_idx;
+    auto regmap = saddr + 8;
+    for (uint32_t w = 0; w < m_cfg.regmap_words; ++w)
+      cq_word(regmap + (w << 2)) = (w < tag_word) ? 0 : static_cast<value_type>(id + w);
+    cq_word(regmap + (tag_word << 2)) = static_cast<value_type>(id + 1);
+
+    value_type count = 1 + m_cfg.regmap_words;
+    cq_word(saddr) = ERT_CMD_STATE_NEW | (count << 12) | (ERT_START_CU << 23) | (ERT_CU << 28);
+
+    if (m_cfg.cq_int) {
+      m_cq_status[slot_idx >> 5] |= 1u << (slot_idx & 0x1f);
+      update_irq_lines();
+    }
+
+    update_occupancy(1);
+  }
+
+  value_type
+  read_csr(addr_type offset)
+  {
+    if (in_range(offset, csr_status, 0x10))
+      return 0; // host side register, COR
+    if (in_range(offset, csr_cu_status, 0x10)) {
+      auto& reg = m_cu_status[(offset - csr_cu_status) >> 2];
+      auto val = reg;
+      reg = 0;
+      return val;
+    }
+    if (in_range(offset, csr_cq_status, 0x10)) {
+      auto& reg = m_cq_status[(offset - csr_cq_status) >> 2];
+      auto val = reg;
+      reg = 0;
+      return val;
+    }
+    if (offset == csr_cudma_state || offset == csr_cuisr_state)
+      return ERT_HLS_MODULE_IDLE;
+    if (offset == csr_cu_isr_enable)
+      return m_cu_isr_enabled;
+    return m_regs[m_layout.csr + offset];
+  }
+
+  void
+  write_csr(addr_type offset, value_type val)
+  {
+    if (in_range(offset, csr_status, 0x10))
+      host_notify((offset - csr_status) >> 2, val);
+    else if (in_range(offset, csr_cu_dma, 0x10))
+      cu_dma((offset - csr_cu_dma) >> 2, val);
+    else if (offset == csr_cu_isr_enable)
+      m_cu_isr_enabled = val;
+    else
+      m_regs[m_layout.csr + offset] = val;
+  }
+
+  value_type
+  read_intc(intc_regs& intc, addr_type offset)
+  {
+    if (offset == intc_isr)
+      return intc.isr;
+    if (offset == intc_ipr)
+      return intc.isr & intc.ier;
+    if (offset == intc_ier)
+      return intc.ier;
+    if (offset == intc_mer)
+      return intc.mer;
+    return 0;
+  }
+
+  void
+  write_intc(intc_regs& intc, addr_type offset, value_type val)
+  {
+    if (offset == intc_ier)
+      intc.ier = val;
+    else if (offset == intc_mer)
+      intc.mer = val;
+    else if (offset == intc_iar) {
+      intc.isr &= ~val;
+      update_irq_lines();
+    }
+  }
+
+  value_type
+  read_cu(uint32_t idx, addr_type offset)
+  {
+    auto& cu = m_cus[idx];
+    switch (offset) {
+    case 0x0: {
+      auto val = cu.ctrl;
+      cu.ctrl &= ~AP_DONE; // COR
+      return val;
+    }
+    case 0x4:
+      return cu.gie;
+    case 0x8:
+      return cu.ier;
+    default:
+      return (offset == (tag_word << 2)) ? cu.tag : 0;
+    }
+  }
+
+  void
+  write_cu(uint32_t idx, addr_type offset, value_type val)
+  {
+    auto& cu = m_cus[idx];
+    switch (offset) {
+    case 0x0:
+      if (val & AP_START)
+        start_cu(idx);
+      break;
+    case 0x4:
+      cu.gie = val;
+      break;
+    case 0x8:
+      cu.ier = val;
+      break;
+    default:
+      if (offset == (tag_word << 2))
+        cu.tag = val;
+      break;
+    }
+  }
+
+  bool
+  is_intc_cu(addr_type addr) const
+  {
+    return m_cfg.fw == ert_sim::firmware::v30 && in_range(addr, m_layout.intc_cu, 0x4000);
+  }
+
+  static ert_sim::latency
+  make_latency(std::vector<uint64_t>& v)
+  {
+    ert_sim::latency lat;
+    if (v.empty())
+      return lat;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (auto x : v)
+      sum += x;
+    lat.avg = sum / v.size();
+    lat.p50 = v[v.size() / 2];
+    lat.p99 = v[std::min(v.size() - 1, (v.size() * 99) / 100)];
+    lat.max = v.back();
+    return lat;
+  }
+
+public:
+  explicit
+  simulator(const ert_sim::config& cfg)
+    : m_cfg(cfg)
+    , m_layout(cfg.fw == ert_sim::firmware::v30 ? v30_layout : legacy_layout)
+    , m_rng(cfg.seed)
+    , m_num_slots(ERT_CQ_SIZE / cfg.slot_size)
+    , m_cq(ERT_CQ_SIZE / 4, 0)
+    , m_cus(cfg.num_cus)
+  {
+    m_cmds.reserve(cfg.num_cmds);
+  }
+
+  value_type
+  read(addr_type addr)
+  {
+    ++m_stats.reads;
+    if (in_range(addr, m_layout.cq, ERT_CQ_SIZE)) {
+      advance(m_cfg.cq_cycles);
+      return cq_word(addr);
+    }
+
+    advance(m_cfg.reg_cycles);
+    if (in_range(addr, m_layout.csr, csr_size))
+      return read_csr(addr - m_layout.csr);
+    if (in_range(addr, m_layout.intc, intc_size))
+      return read_intc(m_intc, addr - m_layout.intc);
+    if (is_intc_cu(addr))
+      return read_intc(m_intc_cu[(addr - m_layout.intc_cu) >> 12], (addr - m_layout.intc_cu) & 0xfff);
+    if (is_cu(addr))
+      return read_cu(cu_idx(addr), addr & ((1 << cu_offset) - 1));
+    return m_regs[addr];
+  }
+
+  void
+  write(addr_type addr, value_type val)
+  {
+    ++m_stats.writes;
+    if (in_range(addr, m_layout.cq, ERT_CQ_SIZE)) {
+      advance(m_cfg.cq_cycles);
+      cq_word(addr) = val;
+      return;
+    }
+
+    advance(m_cfg.reg_cycles);
+    if (in_range(addr, m_layout.csr, csr_size))
+      write_csr(addr - m_layout.csr, val);
+    else if (in_range(addr, m_layout.intc, intc_size))
+      write_intc(m_intc, addr - m_layout.intc, val);
+    else if (is_intc_cu(addr))
+      write_intc(m_intc_cu[(addr - m_layout.intc_cu) >> 12], (addr - m_layout.intc_cu) & 0xfff, val);
+    else if (is_cu(addr))
+      write_cu(cu_idx(addr), addr & ((1 << cu_offset) - 1), val);
+    else
+      m_regs[addr] = val;
+  }
+
+  void
+  enable_interrupts(bool enable)
+  {
+    m_irq_enabled = enable;
+  }
+
+  // Called by the firmware once per slot in the scheduler loop
+  void
+  loop_wait()
+  {
+    ++m_stats.loops;
+    advance(m_cfg.loop_cycles);
+
+    // The scheduler clears the command queue in its initial setup, so
+    // the configure command is written on first loop iteration
+    if (!m_config_submitted)
+      submit_configure();
+
+    if (m_completed == m_cfg.num_cmds)
+      throw stop_simulation();
+
+    if (!irq_pending())
+      return;
+
+    ++m_stats.interrupts;
+    m_in_isr = true;
+    advance(m_cfg.isr_cycles);
+    if (m_cfg.fw == ert_sim::firmware::v30)
+      cu_interrupt_handler_v30();
+    else
+      cu_interrupt_handler();
+    m_in_isr = false;
+  }
+
+  ert_sim::stats
+  run()
+  {
+    try {
+      if (m_cfg.fw == ert_sim::firmware::v30)
+        scheduler_v30_loop();
+      else
+        scheduler_loop();
+    }
+    catch (const stop_simulation&) {
+    }
+
+    if (m_completed < m_cfg.num_cmds)
+      error("stopped with " + std::to_string(m_cfg.num_cmds - m_completed) + " commands outstanding");
+
+    update_occupancy(0);
+    auto window = m_now - m_start;
+
+    m_stats.num_slots = m_num_slots;
+    m_stats.cycles = window;
+    m_stats.completed = m_completed;
+    m_stats.slot_utilization = window ? m_occupied_area / (static_cast<double>(window) * m_num_slots) : 0;
+    for (auto& cu : m_cus)
+      m_stats.cu_utilization.push_back(window ? static_cast<double>(cu.busy_cycles) / window : 0);
+
+    std::vector<uint64_t> dispatch, completion, total;
+    for (auto& cmd : m_cmds) {
+      if (!cmd.notified)
+        continue;
+      dispatch.push_back(cmd.start - cmd.submit);
+      completion.push_back(cmd.notify - cmd.done);
+      total.push_back(cmd.notify - cmd.submit);
+    }
+    m_stats.dispatch = make_latency(dispatch);
+    m_stats.completion = make_latency(completion);
+    m_stats.total = make_latency(total);
+    return m_stats;
+  }
+};
+
+simulator* s_sim = nullptr;
+
+} // namespace
+
+// Externs required by the ERT_HW_EMU firmware build
+uint32_t
+read_reg(uint32_t addr)
+{
+  return s_sim->read(addr);
+}
+
+void
+write_reg(uint32_t addr, uint32_t val)
+{
+  s_sim->write(addr, val);
+}
+
+void
+microblaze_enable_interrupts()
+{
+  s_sim->enable_interrupts(true);
+}
+
+void
+microblaze_disable_interrupts()
+{
+  s_sim->enable_interrupts(false);
+}
+
+void
+reg_access_wait()
+{
+  s_sim->loop_wait();
+}
+
+namespace ert_sim {
+
+stats
+run(const config& cfg)
+{
+  if (s_sim)
+    throw std::runtime_error("ert simulation already running");
+
+  validate(cfg);
+  simulator sim(cfg);
+  s_sim = &sim;
+  auto st = sim.run();
+  s_sim = nullptr;
+  return st;
+}
+
+} // ert_sim
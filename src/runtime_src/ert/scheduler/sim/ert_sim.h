@@ -0,0 +1,128 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ert_sim_h_
+#define ert_sim_h_
+
+/**
+ * Host simulation of the ERT firmware
+ *
+ * The ERT firmware (scheduler.cpp, scheduler_v30.cpp) built with
+ * ERT_HW_EMU accesses all peripherals through the externs read_reg,
+ * write_reg, microblaze_{enable,disable}_interrupts and
+ * reg_access_wait.  This simulator implements those externs on top of
+ * a modelled register file (command queue, CSR, interrupt controller,
+ * CU DMA, CU ISR and HLS CU control registers) driven by a simulated
+ * cycle clock, so that the unmodified firmware algorithms can be run
+ * and measured on the host.
+ *
+ * The simulation is single threaded and deterministic.  The clock
+ * advances on every register access and once per scheduler loop
+ * iteration (reg_access_wait), CUs complete after a configurable
+ * number of cycles, and pending interrupts are delivered to the
+ * firmware interrupt handler at scheduler loop boundaries.
+ *
+ * A simulated host keeps the command queue full with ERT_START_CU
+ * commands and verifies that every command is started exactly once
+ * on its assigned CU and is reported complete only after its CU is
+ * done.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ert_sim {
+
+enum class firmware { legacy, v30 };
+
+struct config
+{
+  firmware fw = firmware::legacy;
+
+  // Configuration sent to ERT with ERT_CONFIGURE
+  uint32_t num_cus = 4;
+  uint32_t slot_size = 0x1000;     // num_slots is ERT_CQ_SIZE / slot_size
+  bool cu_dma = false;             // legacy only
+  bool cu_isr = false;             // legacy only
+  bool cq_int = false;
+  bool kds_30 = false;             // v30 only
+
+  // Workload
+  uint64_t num_cmds = 10000;
+  uint32_t regmap_words = 16;      // including 4 control words
+
+  // Timing model in MicroBlaze cycles
+  uint64_t cu_cycles = 1000;       // CU execution time
+  uint64_t cu_jitter = 0;          // uniform [0,cu_jitter) added to cu_cycles
+  uint64_t reg_cycles = 20;        // AXI-lite register access
+  uint64_t cq_cycles = 4;          // command queue BRAM access
+  uint64_t loop_cycles = 10;       // scheduler loop overhead per slot
+  uint64_t isr_cycles = 40;        // interrupt entry and exit
+  uint64_t host_cycles = 0;        // host latency to refill a freed slot
+  uint64_t max_cycles = 0;         // 0 is no limit
+  uint32_t seed = 1;
+};
+
+struct latency
+{
+  uint64_t p50 = 0;
+  uint64_t p99 = 0;
+  uint64_t max = 0;
+  double avg = 0;
+};
+
+struct stats
+{
+  uint32_t num_slots = 0;
+  uint64_t cycles = 0;
+  uint64_t completed = 0;
+  uint64_t reads = 0;
+  uint64_t writes = 0;
+  uint64_t loops = 0;
+  uint64_t interrupts = 0;
+
+  // submit -> CU start
+  latency dispatch;
+  // CU done -> host notified
+  latency completion;
+  // submit -> host notified
+  latency total;
+
+  // time weighted average of occupied slots / num_slots
+  double slot_utilization = 0;
+  // per CU busy cycles / total cycles
+  std::vector<double> cu_utilization;
+
+  // Protocol violations detected while running, empty on success
+  std::vector<std::string> errors;
+};
+
+/**
+ * run() - Run the firmware against the simulated hardware
+ *
+ * @cfg: Simulation and workload configuration
+ * Return: Statistics for the run
+ *
+ * The firmware scheduler keeps its state in statics, so only one
+ * simulation can be run per process.
+ */
+stats
+run(const config& cfg);
+
+} // ert_sim
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * ert_sim - Run the ERT firmware scheduler against simulated hardware
+ *
+ * Examples:
+ *   # polling scheduler, 8 CUs, 64 slots
+ *   ert_sim --cus 8 --slot-size 0x400
+ *
+ *   # interrupt driven scheduler with CU DMA
+ *   ert_sim --cus 8 --cu-dma --cu-isr --cq-int
+ *
+ *   # v30 firmware with KDS 3.0 CU interrupts
+ *   ert_sim --v30 --kds30 --cq-int
+ *
+ * Exit status is 0 if all commands completed without protocol
+ * violations, 1 otherwise, and 2 for usage errors.
+ */
+
+#include "ert_sim.h"
+
+#include <getopt.h>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void
+usage(const char* prog)
+{
+  std::cout
+    << "usage: " << prog << " [options]\n"
+    << "  --v30               run scheduler_v30 firmware (default legacy)\n"
+    << "  --cus <n>           number of CUs (4)\n"
+    << "  --slot-size <n>     command queue slot size in bytes (0x1000)\n"
+    << "  --cu-dma            enable CU DMA (legacy)\n"
+    << "  --cu-isr            enable CU interrupts (legacy)\n"
+    << "  --cq-int            enable command queue interrupts\n"
+    << "  --kds30             enable KDS 3.0 CU interrupts (v30)\n"
+    << "  --cmds <n>          number of commands to run (10000)\n"
+    << "  --regmap <n>        register map words per command (16)\n"
+    << "  --cu-cycles <n>     CU execution cycles (1000)\n"
+    << "  --cu-jitter <n>     random extra CU cycles in [0,n) (0)\n"
+    << "  --reg-cycles <n>    cycles per register access (20)\n"
+    << "  --cq-cycles <n>     cycles per command queue access (4)\n"
+    << "  --loop-cycles <n>   scheduler loop overhead per slot (10)\n"
+    << "  --isr-cycles <n>    interrupt entry and exit cycles (40)\n"
+    << "  --host-cycles <n>   host latency to refill a free slot (0)\n"
+    << "  --max-cycles <n>    stop after n cycles (0, unlimited)\n"
+    << "  --seed <n>          seed for CU jitter (1)\n"
+    << "  --mhz <n>           MicroBlaze clock for reporting (250)\n";
+}
+
+uint64_t
+to_number(const char* str)
+{
+  char* end = nullptr;
+  auto val = std::strtoull(str, &end, 0);
+  if (!end || *end)
+    throw std::runtime_error(std::string("bad number '") + str + "'");
+  return val;
+}
+
+void
+print_latency(const char* name, const ert_sim::latency& lat)
+{
+  std::cout << "  " << std::left << std::setw(20) << name << std::right
+            << "avg " << std::fixed << std::setprecision(1) << lat.avg
+            << "  p50 " << lat.p50 << "  p99 " << lat.p99 << "  max " << lat.max
+            << " cycles\n";
+}
+
+void
+print(const ert_sim::config& cfg, const ert_sim::stats& st, double mhz)
+{
+  std::cout << "ERT " << (cfg.fw == ert_sim::firmware::v30 ? "v30" : "legacy")
+            << " firmware: " << cfg.num_cus << " CUs, " << st.num_slots << " slots"
+            << (cfg.cu_dma ? ", cu dma" : "")
+            << (cfg.cu_isr ? ", cu isr" : "")
+            << (cfg.kds_30 ? ", kds 3.0" : "")
+            << (cfg.cq_int ? ", cq interrupt" : ", cq polling") << "\n";
+
+  double kcycles = st.cycles / 1000.0;
+  double per_kcycle = kcycles ? st.completed / kcycles : 0;
+  std::cout << std::fixed << std::setprecision(3)
+            << "  commands            " << st.completed << "\n"
+            << "  cycles              " << st.cycles << "\n"
+            << "  throughput          " << per_kcycle << " cmds/kcycle ("
+            << std::setprecision(1) << per_kcycle * mhz << " K cmds/s at " << mhz << " MHz)\n";
+
+  print_latency("dispatch latency", st.dispatch);
+  print_latency("completion latency", st.completion);
+  print_latency("total latency", st.total);
+
+  std::cout << "  slot utilization    " << std::setprecision(1) << st.slot_utilization * 100 << "%\n"
+            << "  cu utilization     ";
+  for (auto util : st.cu_utilization)
+    std::cout << " " << util * 100 << "%";
+  std::cout << "\n"
+            << "  interrupts          " << st.interrupts << "\n"
+            << "  register reads      " << st.reads << "\n"
+            << "  register writes     " << st.writes << "\n"
+            << "  loop iterations     " << st.loops << "\n";
+
+  for (auto& err : st.errors)
+    std::cout << "error: " << err << "\n";
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  static const struct option long_options[] = {
+    {"v30",         no_argument,       nullptr, 'v'},
+    {"cus",         required_argument, nullptr, 'c'},
+    {"slot-size",   required_argument, nullptr, 's'},
+    {"cu-dma",      no_argument,       nullptr, 'D'},
+    {"cu-isr",      no_argument,       nullptr, 'I'},
+    {"cq-int",      no_argument,       nullptr, 'Q'},
+    {"kds30",       no_argument,       nullptr, 'K'},
+    {"cmds",        required_argument, nullptr, 'n'},
+    {"regmap",      required_argument, nullptr, 'r'},
+    {"cu-cycles",   required_argument, nullptr, 'u'},
+    {"cu-jitter",   required_argument, nullptr, 'j'},
+    {"reg-cycles",  required_argument, nullptr, 'R'},
+    {"cq-cycles",   required_argument, nullptr, 'q'},
+    {"loop-cycles", required_argument, nullptr, 'l'},
+    {"isr-cycles",  required_argument, nullptr, 'i'},
+    {"host-cycles", required_argument, nullptr, 'H'},
+    {"max-cycles",  required_argument, nullptr, 'm'},
+    {"seed",        required_argument, nullptr, 'S'},
+    {"mhz",         required_argument, nullptr, 'M'},
+    {"help",        no_argument,       nullptr, 'h'},
+    {nullptr, 0, nullptr, 0}
+  };
+
+  ert_sim::config cfg;
+  double mhz = 250;
+
+  try {
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", long_options, nullptr)) != -1) {
+      switch (opt) {
+      case 'v': cfg.fw = ert_sim::firmware::v30; break;
+      case 'c': cfg.num_cus = to_number(optarg); break;
+      case 's': cfg.slot_size = to_number(optarg); break;
+      case 'D': cfg.cu_dma = true; break;
+      case 'I': cfg.cu_isr = true; break;
+      case 'Q': cfg.cq_int = true; break;
+      case 'K': cfg.kds_30 = true; break;
+      case 'n': cfg.num_cmds = to_number(optarg); break;
+      case 'r': cfg.regmap_words = to_number(optarg); break;
+      case 'u': cfg.cu_cycles = to_number(optarg); break;
+      case 'j': cfg.cu_jitter = to_number(optarg); break;
+      case 'R': cfg.reg_cycles = to_number(optarg); break;
+      case 'q': cfg.cq_cycles = to_number(optarg); break;
+      case 'l': cfg.loop_cycles = to_number(optarg); break;
+      case 'i': cfg.isr_cycles = to_number(optarg); break;
+      case 'H': cfg.host_cycles = to_number(optarg); break;
+      case 'm': cfg.max_cycles = to_number(optarg); break;
+      case 'S': cfg.seed = to_number(optarg); break;
+      case 'M': mhz = to_number(optarg); break;
+      case 'h': usage(argv[0]); return 0;
+      default: usage(argv[0]); return 2;
+      }
+    }
+
+    auto st = ert_sim::run(cfg);
+    print(cfg, st, mhz);
+    return st.errors.empty() ? 0 : 1;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "ert_sim: " << ex.what() << "\n";
+    return 2;
+  }
+}
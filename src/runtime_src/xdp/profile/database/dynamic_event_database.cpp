@@ -221,7 +221,7 @@ namespace xdp {
   void VPDynamicDatabase::addPowerSample(uint64_t deviceId, double timestamp,
           const std::vector<uint64_t>& values)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> lock(sampleLock) ;
 
     if (powerSamples.find(deviceId) == powerSamples.end())
     {
@@ -235,15 +235,24 @@ namespace xdp {
   std::vector<VPDynamicDatabase::CounterSample>
   VPDynamicDatabase::getPowerSamples(uint64_t deviceId)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> lock(sampleLock) ;
 
     return powerSamples[deviceId] ;
   }
 
+  void VPDynamicDatabase::takePowerSamples(uint64_t deviceId,
+                                           std::vector<CounterSample>& samples)
+  {
+    samples.clear() ;
+
+    std::lock_guard<std::mutex> lock(sampleLock) ;
+    std::swap(samples, powerSamples[deviceId]) ;
+  }
+
   void VPDynamicDatabase::addAIESample(uint64_t deviceId, double timestamp,
           const std::vector<uint64_t>& values)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> lock(sampleLock) ;
 
     if (aieSamples.find(deviceId) == aieSamples.end())
     {
@@ -257,15 +266,24 @@ namespace xdp {
   std::vector<VPDynamicDatabase::CounterSample>
   VPDynamicDatabase::getAIESamples(uint64_t deviceId)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> lock(sampleLock) ;
 
     return aieSamples[deviceId] ;
   }
 
+  void VPDynamicDatabase::takeAIESamples(uint64_t deviceId,
+                                         std::vector<CounterSample>& samples)
+  {
+    samples.clear() ;
+
+    std::lock_guard<std::mutex> lock(sampleLock) ;
+    std::swap(samples, aieSamples[deviceId]) ;
+  }
+
   void VPDynamicDatabase::addNOCSample(uint64_t deviceId, double timestamp,
           std::string name, const std::vector<uint64_t>& values)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> lock(sampleLock) ;
 
     // Store name
     if (nocNames.find(deviceId) == nocNames.end())
@@ -289,7 +307,7 @@ namespace xdp {
   std::vector<VPDynamicDatabase::CounterSample>
   VPDynamicDatabase::getNOCSamples(uint64_t deviceId)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> lock(sampleLock) ;
 
     return nocSamples[deviceId] ;
   }
@@ -297,8 +315,20 @@ namespace xdp {
   VPDynamicDatabase::CounterNames
   VPDynamicDatabase::getNOCNames(uint64_t deviceId)
   {
-    std::lock_guard<std::mutex> lock(dbLock) ;
+    std::lock_guard<std::mutex> lock(sampleLock) ;
 
     return nocNames[deviceId] ;
   }
+
+  void VPDynamicDatabase::takeNOCSamples(uint64_t deviceId,
+                                         std::vector<CounterSample>& samples,
+                                         CounterNames& names)
+  {
+    samples.clear() ;
+    names.clear() ;
+
+    std::lock_guard<std::mutex> lock(sampleLock) ;
+    std::swap(samples, nocSamples[deviceId]) ;
+    std::swap(names, nocNames[deviceId]) ;
+  }
 }
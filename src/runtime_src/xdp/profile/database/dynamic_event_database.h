@@ -97,6 +97,10 @@ namespace xdp {
     //  we have to maintain exclusivity
     std::mutex dbLock ;
 
+    // Counter samples are added by the sampler thread and have their
+    //  own lock so sampling does not contend with event logging
+    std::mutex sampleLock ;
+
     std::map<uint64_t, uint64_t> traceIDMap;
 
     void addHostEvent(VTFEvent* event) ;
@@ -134,19 +138,30 @@ namespace xdp {
     XDP_EXPORT void addAIETraceData(uint64_t deviceId, uint64_t strmIndex, void* buffer, uint64_t bufferSz);
     XDP_EXPORT AIETraceDataType* getAIETraceData(uint64_t deviceId, uint64_t strmIndex);
 
-    // Functions that are used by counter-based plugins
+    // Functions that are used by counter-based plugins.  The take
+    //  functions move all samples added so far into the passed
+    //  containers, which are cleared and whose storage is reused by
+    //  the database, so writers can stream samples to file with
+    //  bounded memory.
     XDP_EXPORT void addPowerSample(uint64_t deviceId, double timestamp,
 				   const std::vector<uint64_t>& values) ;
     XDP_EXPORT std::vector<CounterSample> getPowerSamples(uint64_t deviceId) ;
+    XDP_EXPORT void takePowerSamples(uint64_t deviceId,
+				     std::vector<CounterSample>& samples) ;
 
     XDP_EXPORT void addAIESample(uint64_t deviceId, double timestamp,
 				   const std::vector<uint64_t>& values) ;
     XDP_EXPORT std::vector<CounterSample> getAIESamples(uint64_t deviceId) ;
+    XDP_EXPORT void takeAIESamples(uint64_t deviceId,
+				   std::vector<CounterSample>& samples) ;
 
     XDP_EXPORT void addNOCSample(uint64_t deviceId, double timestamp, std::string name,
 				   const std::vector<uint64_t>& values) ;
     XDP_EXPORT std::vector<CounterSample> getNOCSamples(uint64_t deviceId) ;
     XDP_EXPORT CounterNames getNOCNames(uint64_t deviceId) ;
+    XDP_EXPORT void takeNOCSamples(uint64_t deviceId,
+				   std::vector<CounterSample>& samples,
+				   CounterNames& names) ;
   } ;
   
 }
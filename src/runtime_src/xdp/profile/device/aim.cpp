@@ -53,6 +53,12 @@
 #define XAIM_SAMPLE_READ_BUSY_CYCLES_UPPER_OFFSET    0xF4
 #define XAIM_SAMPLE_WRITE_BUSY_CYCLES_UPPER_OFFSET   0xF8
 
+/* Sampled counters are read as blocks of consecutive registers,
+ * 0x80 to 0xB8 and 0xC0 to 0xF8 */
+#define XAIM_SAMPLE_WORDS                            15
+#define XAIM_SAMPLE_WORD(block, offset)              (block)[((offset) - XAIM_SAMPLE_WRITE_BYTES_OFFSET) / 4]
+#define XAIM_SAMPLE_UPPER_WORD(block, offset)        (block)[((offset) - XAIM_SAMPLE_WRITE_BYTES_UPPER_OFFSET) / 4]
+
 /* SPM Control Register masks */
 #define XAIM_CR_COUNTER_RESET_MASK               0x00000002
 #define XAIM_CR_COUNTER_ENABLE_MASK              0x00000001
@@ -135,9 +141,11 @@ size_t AIM::readCounter(xclCounterResults& counterResults, uint32_t s /*index*/)
     size_t size = 0;
     uint32_t sampleInterval = 0;
     
-    // Read sample interval register
-    // NOTE: this also latches the sampled metric counters
-    size += read(XAIM_SAMPLE_OFFSET, 4, &sampleInterval);
+    // Read sample interval register, which latches the sampled metric
+    // counters, then all counters with one read
+    uint32_t lower[XAIM_SAMPLE_WORDS] = {};
+    size += readSnapshot(XAIM_SAMPLE_OFFSET, &sampleInterval,
+                         XAIM_SAMPLE_WRITE_BYTES_OFFSET, XAIM_SAMPLE_WORDS, lower);
 
     // Samples are taken almost immediately and it is assumed that the intervals are close to each other.
     // So, only one sample interval reading is okay.
@@ -145,26 +153,30 @@ size_t AIM::readCounter(xclCounterResults& counterResults, uint32_t s /*index*/)
        counterResults.SampleIntervalUsec = static_cast<float>(sampleInterval / (getDevice()->getDeviceClock()));
     }
 
-    size += read(XAIM_SAMPLE_WRITE_BYTES_OFFSET, 4, &counterResults.WriteBytes[s]);
-    size += read(XAIM_SAMPLE_WRITE_TRANX_OFFSET, 4, &counterResults.WriteTranx[s]);
-    size += read(XAIM_SAMPLE_WRITE_LATENCY_OFFSET, 4, &counterResults.WriteLatency[s]);
-    size += read(XAIM_SAMPLE_READ_BYTES_OFFSET, 4, &counterResults.ReadBytes[s]);
-    size += read(XAIM_SAMPLE_READ_TRANX_OFFSET, 4, &counterResults.ReadTranx[s]);
-    size += read(XAIM_SAMPLE_READ_LATENCY_OFFSET, 4, &counterResults.ReadLatency[s]);
-    size += read(XAIM_SAMPLE_READ_BUSY_CYCLES_OFFSET, 4, &counterResults.ReadBusyCycles[s]);
-    size += read(XAIM_SAMPLE_WRITE_BUSY_CYCLES_OFFSET, 4, &counterResults.WriteBusyCycles[s]);
+    counterResults.WriteBytes[s]      = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_WRITE_BYTES_OFFSET);
+    counterResults.WriteTranx[s]      = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_WRITE_TRANX_OFFSET);
+    counterResults.WriteLatency[s]    = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_WRITE_LATENCY_OFFSET);
+    counterResults.ReadBytes[s]       = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_READ_BYTES_OFFSET);
+    counterResults.ReadTranx[s]       = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_READ_TRANX_OFFSET);
+    counterResults.ReadLatency[s]     = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_READ_LATENCY_OFFSET);
+    counterResults.ReadBusyCycles[s]  = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_READ_BUSY_CYCLES_OFFSET);
+    counterResults.WriteBusyCycles[s] = XAIM_SAMPLE_WORD(lower, XAIM_SAMPLE_WRITE_BUSY_CYCLES_OFFSET);
 
     // Read upper 32 bits (if available)
     if(has64bit()) {
-        uint64_t upper[8] = {};
-        size += read(XAIM_SAMPLE_WRITE_BYTES_UPPER_OFFSET, 4, &upper[0]);
-        size += read(XAIM_SAMPLE_WRITE_TRANX_UPPER_OFFSET, 4, &upper[1]);
-        size += read(XAIM_SAMPLE_WRITE_LATENCY_UPPER_OFFSET, 4, &upper[2]);
-        size += read(XAIM_SAMPLE_READ_BYTES_UPPER_OFFSET, 4, &upper[3]);
-        size += read(XAIM_SAMPLE_READ_TRANX_UPPER_OFFSET, 4, &upper[4]);
-        size += read(XAIM_SAMPLE_READ_LATENCY_UPPER_OFFSET, 4, &upper[5]);
-        size += read(XAIM_SAMPLE_READ_BUSY_CYCLES_UPPER_OFFSET, 4, &upper[6]);
-        size += read(XAIM_SAMPLE_WRITE_BUSY_CYCLES_UPPER_OFFSET, 4, &upper[7]);
+        uint32_t block[XAIM_SAMPLE_WORDS] = {};
+        size += readSnapshot(0, nullptr, XAIM_SAMPLE_WRITE_BYTES_UPPER_OFFSET, XAIM_SAMPLE_WORDS, block);
+
+        uint64_t upper[8] = {
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_WRITE_BYTES_UPPER_OFFSET),
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_WRITE_TRANX_UPPER_OFFSET),
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_WRITE_LATENCY_UPPER_OFFSET),
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_READ_BYTES_UPPER_OFFSET),
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_READ_TRANX_UPPER_OFFSET),
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_READ_LATENCY_UPPER_OFFSET),
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_READ_BUSY_CYCLES_UPPER_OFFSET),
+          XAIM_SAMPLE_UPPER_WORD(block, XAIM_SAMPLE_WRITE_BUSY_CYCLES_UPPER_OFFSET)
+        };
 
         counterResults.WriteBytes[s]      += (upper[0] << 32);
         counterResults.WriteTranx[s]      += (upper[1] << 32);
@@ -41,6 +41,12 @@
 #define XAM_MAX_PARALLEL_ITER_OFFSET                0xC8
 #define XAM_MAX_PARALLEL_ITER_UPPER_OFFSET          0xCC
 
+/* Sampled counters are read as one block of consecutive registers
+ * from 0x80, up to 0x9C, 0xBC with upper 32 bits, or 0xCC with
+ * dataflow counters */
+#define XAM_SAMPLE_WORDS                            20
+#define XAM_SAMPLE_WORD(block, offset)              (block)[((offset) - XAM_ACCEL_EXECUTION_COUNT_OFFSET) / 4]
+
 /* SAM Trace Control Masks */
 #define XAM_TRACE_STALL_SELECT_MASK    0x0000001c
 #define XAM_COUNTER_RESET_MASK         0x00000002
@@ -127,26 +133,32 @@ size_t AM::readCounter(xclCounterResults& counterResults, uint32_t s /*index*/)
                       << std::endl;
     }
         
-    // Read sample interval register
-    // NOTE: this also latches the sampled metric counters
-    size += read(XAM_SAMPLE_OFFSET, 4, &sampleInterval);
+    // Read sample interval register, which latches the sampled metric
+    // counters, then all counters with one read
+    size_t words = hasDataflow() ? XAM_SAMPLE_WORDS
+      : (has64bit() ? (XAM_BUSY_CYCLES_OFFSET - XAM_ACCEL_EXECUTION_COUNT_OFFSET) / 4
+                    : (XAM_ACCEL_EXECUTION_COUNT_UPPER_OFFSET - XAM_ACCEL_EXECUTION_COUNT_OFFSET) / 4);
+    uint32_t block[XAM_SAMPLE_WORDS] = {};
+    size += readSnapshot(XAM_SAMPLE_OFFSET, &sampleInterval,
+                         XAM_ACCEL_EXECUTION_COUNT_OFFSET, words, block);
 
     if(out_stream) {
         (*out_stream) << "Accelerator Monitor Sample Interval : " << sampleInterval << std::endl;
     }
 
-    size += read(XAM_ACCEL_EXECUTION_COUNT_OFFSET, 4, &counterResults.CuExecCount[s]);
-    size += read(XAM_ACCEL_EXECUTION_CYCLES_OFFSET, 4, &counterResults.CuExecCycles[s]);
-    size += read(XAM_ACCEL_MIN_EXECUTION_CYCLES_OFFSET, 4, &counterResults.CuMinExecCycles[s]);
-    size += read(XAM_ACCEL_MAX_EXECUTION_CYCLES_OFFSET, 4, &counterResults.CuMaxExecCycles[s]);
+    counterResults.CuExecCount[s]     = XAM_SAMPLE_WORD(block, XAM_ACCEL_EXECUTION_COUNT_OFFSET);
+    counterResults.CuExecCycles[s]    = XAM_SAMPLE_WORD(block, XAM_ACCEL_EXECUTION_CYCLES_OFFSET);
+    counterResults.CuMinExecCycles[s] = XAM_SAMPLE_WORD(block, XAM_ACCEL_MIN_EXECUTION_CYCLES_OFFSET);
+    counterResults.CuMaxExecCycles[s] = XAM_SAMPLE_WORD(block, XAM_ACCEL_MAX_EXECUTION_CYCLES_OFFSET);
 
-    // Read upper 32 bits (if available)
+    // Upper 32 bits (if available)
     if(has64bit()) {
-        uint64_t upper[4] = {};
-        size += read(XAM_ACCEL_EXECUTION_COUNT_UPPER_OFFSET, 4, &upper[0]);
-        size += read(XAM_ACCEL_EXECUTION_CYCLES_UPPER_OFFSET, 4, &upper[1]);
-        size += read(XAM_ACCEL_MIN_EXECUTION_CYCLES_UPPER_OFFSET, 4, &upper[2]);
-        size += read(XAM_ACCEL_MAX_EXECUTION_CYCLES_UPPER_OFFSET, 4, &upper[3]);
+        uint64_t upper[4] = {
+          XAM_SAMPLE_WORD(block, XAM_ACCEL_EXECUTION_COUNT_UPPER_OFFSET),
+          XAM_SAMPLE_WORD(block, XAM_ACCEL_EXECUTION_CYCLES_UPPER_OFFSET),
+          XAM_SAMPLE_WORD(block, XAM_ACCEL_MIN_EXECUTION_CYCLES_UPPER_OFFSET),
+          XAM_SAMPLE_WORD(block, XAM_ACCEL_MAX_EXECUTION_CYCLES_UPPER_OFFSET)
+        };
 
         counterResults.CuExecCount[s]     += (upper[0] << 32);
         counterResults.CuExecCycles[s]    += (upper[1] << 32);
@@ -164,13 +176,14 @@ size_t AM::readCounter(xclCounterResults& counterResults, uint32_t s /*index*/)
     }
 
     if(hasDataflow()) {
-        size += read(XAM_BUSY_CYCLES_OFFSET, 4, &counterResults.CuBusyCycles[s]);
-        size += read(XAM_MAX_PARALLEL_ITER_OFFSET, 4, &counterResults.CuMaxParallelIter[s]);
+        counterResults.CuBusyCycles[s]      = XAM_SAMPLE_WORD(block, XAM_BUSY_CYCLES_OFFSET);
+        counterResults.CuMaxParallelIter[s] = XAM_SAMPLE_WORD(block, XAM_MAX_PARALLEL_ITER_OFFSET);
 
         if(has64bit()) {
-            uint64_t upper[2] = {};
-            size += read(XAM_BUSY_CYCLES_UPPER_OFFSET, 4, &upper[0]);
-            size += read(XAM_MAX_PARALLEL_ITER_UPPER_OFFSET, 4, &upper[1]);
+            uint64_t upper[2] = {
+              XAM_SAMPLE_WORD(block, XAM_BUSY_CYCLES_UPPER_OFFSET),
+              XAM_SAMPLE_WORD(block, XAM_MAX_PARALLEL_ITER_UPPER_OFFSET)
+            };
             counterResults.CuBusyCycles[s]  += (upper[0] << 32);
             counterResults.CuMaxParallelIter[s]  += (upper[1] << 32);
         }
@@ -190,9 +203,9 @@ size_t AM::readCounter(xclCounterResults& counterResults, uint32_t s /*index*/)
     }
 
     if(hasStall()) {
-        size += read(XAM_ACCEL_STALL_INT_OFFSET, 4, &counterResults.CuStallIntCycles[s]);
-        size += read(XAM_ACCEL_STALL_STR_OFFSET, 4, &counterResults.CuStallStrCycles[s]);
-        size += read(XAM_ACCEL_STALL_EXT_OFFSET, 4, &counterResults.CuStallExtCycles[s]);
+        counterResults.CuStallIntCycles[s] = XAM_SAMPLE_WORD(block, XAM_ACCEL_STALL_INT_OFFSET);
+        counterResults.CuStallStrCycles[s] = XAM_SAMPLE_WORD(block, XAM_ACCEL_STALL_STR_OFFSET);
+        counterResults.CuStallExtCycles[s] = XAM_SAMPLE_WORD(block, XAM_ACCEL_STALL_EXT_OFFSET);
     }
 
 
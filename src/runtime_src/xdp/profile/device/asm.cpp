@@ -36,6 +36,12 @@
 #define XASM_STALL_CYCLES_OFFSET      0x98
 #define XASM_STARVE_CYCLES_OFFSET     0xA0
 
+/* Sampled 64 bit counters are read as one block from 0x80 to 0xA4 */
+#define XASM_SAMPLE_WORDS             10
+#define XASM_SAMPLE_COUNTER(block, offset) \
+  ((static_cast<uint64_t>((block)[((offset) - XASM_NUM_TRANX_OFFSET) / 4 + 1]) << 32) | \
+   (block)[((offset) - XASM_NUM_TRANX_OFFSET) / 4])
+
 /* SSPM Control Mask */
 #define XASM_COUNTER_RESET_MASK       0x00000001
 
@@ -104,13 +110,17 @@ size_t ASM::readCounter(xclCounterResults& counterResults, uint32_t s /*index*/)
         (*out_stream) << "Reading AXI Stream Monitors.." << std::endl;
     }
 
-    size += read(XASM_SAMPLE_OFFSET, 4, &sampleInterval);
-
-    size += read(XASM_NUM_TRANX_OFFSET, 8, &counterResults.StrNumTranx[s]);
-    size += read(XASM_DATA_BYTES_OFFSET, 8, &counterResults.StrDataBytes[s]);
-    size += read(XASM_BUSY_CYCLES_OFFSET, 8, &counterResults.StrBusyCycles[s]);
-    size += read(XASM_STALL_CYCLES_OFFSET, 8, &counterResults.StrStallCycles[s]);
-    size += read(XASM_STARVE_CYCLES_OFFSET, 8, &counterResults.StrStarveCycles[s]);
+    // Read sample interval register, which latches the sampled metric
+    // counters, then all 64 bit counters with one read
+    uint32_t block[XASM_SAMPLE_WORDS] = {};
+    size += readSnapshot(XASM_SAMPLE_OFFSET, &sampleInterval,
+                         XASM_NUM_TRANX_OFFSET, XASM_SAMPLE_WORDS, block);
+
+    counterResults.StrNumTranx[s]     = XASM_SAMPLE_COUNTER(block, XASM_NUM_TRANX_OFFSET);
+    counterResults.StrDataBytes[s]    = XASM_SAMPLE_COUNTER(block, XASM_DATA_BYTES_OFFSET);
+    counterResults.StrBusyCycles[s]   = XASM_SAMPLE_COUNTER(block, XASM_BUSY_CYCLES_OFFSET);
+    counterResults.StrStallCycles[s]  = XASM_SAMPLE_COUNTER(block, XASM_STALL_CYCLES_OFFSET);
+    counterResults.StrStarveCycles[s] = XASM_SAMPLE_COUNTER(block, XASM_STARVE_CYCLES_OFFSET);
 
     // AXIS without TLAST is assumed to be one long transfer
     if (counterResults.StrNumTranx[s] == 0 && counterResults.StrDataBytes[s] > 0) {
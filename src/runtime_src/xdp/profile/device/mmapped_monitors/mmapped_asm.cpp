@@ -67,7 +67,21 @@ int MMappedASM::read(uint64_t offset, size_t size, void* data)
   if(!isMMapped()) {
     return 0;
   }
-  memcpy((char*)data, mapped_device + offset, size);
+  if(size <= sizeof(uint32_t)) {
+    memcpy((char*)data, mapped_device + offset, size);
+    return size;
+  }
+  // Counter snapshots are read as one block, copy a register at a time
+  // so the block is read with 32 bit accesses
+  size_t numWords = size / sizeof(uint32_t);
+  size_t remBytes = size % sizeof(uint32_t);
+  volatile uint32_t* regs = (volatile uint32_t*)(mapped_device + offset);
+  for(size_t i = 0; i < numWords ; i++) {
+    ((uint32_t*)data)[i] = regs[i];
+  }
+  if(remBytes) {
+    memcpy(((uint32_t*)data)+numWords, (uint32_t*)(mapped_device + offset)+numWords, remBytes);
+  }
   return size;
 }
 
@@ -163,6 +163,16 @@ int ProfileIP::unmgdRead(unsigned flags, void *buf, size_t count, uint64_t offse
     return 0;
 }
 
+size_t ProfileIP::readSnapshot(uint64_t sampleOffset, uint32_t* sample,
+                               uint64_t offset, size_t words, uint32_t* data)
+{
+    size_t size = 0;
+    if (sample)
+        size += read(sampleOffset, sizeof(uint32_t), sample);
+    size += read(offset, words * sizeof(uint32_t), data);
+    return size;
+}
+
 void ProfileIP::showWarning(std::string reason) {
     /**
      * TODO: we will need to discuss more on how xdp should
@@ -126,6 +126,16 @@ public:
 
     virtual int unmgdRead(unsigned flags, void *buf, size_t count, uint64_t offset);
 
+    /**
+     * The readSnapshot method reads the sample register, which
+     * latches the sampled counters of a monitor, and then reads
+     * a block of consecutive 32 bit counter registers with a
+     * single read rather than one read per register, so all
+     * counters come from the same sample.
+     */
+    size_t readSnapshot(uint64_t sampleOffset, uint32_t* sample,
+                        uint64_t offset, size_t words, uint32_t* data);
+
     /**
      * Since this API as part of the profiling code should not
      * crash the rest of the code, it will need to simply warn
@@ -0,0 +1,215 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Trace S2MM decoder dump comparison
+//
+// Decodes synthetic trace buffers with TraceS2MM::parseTraceBuf twice.
+// The reference decoder has a log stream, which keeps every packet on
+// the per packet parsePacket path; the other decoder takes the batched
+// data packet path.  The results of both are dumped as text and must
+// be identical.  Each case decodes two buffers in a row to cover the
+// state carried between calls (first timestamp, clock training).
+//
+// % trace_s2mm_test
+//
+// Returns the number of failed cases.
+
+#include "../traceS2MM.h"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct trace_case
+{
+  const char* name;
+  uint32_t format;
+  size_t packets;     // per buffer
+  unsigned int seed;
+  double empty;       // probability of an empty word ending the buffer
+  double train;       // probability of a clock training group (format 1)
+  size_t garbage;     // leading words before the clock training (format 1)
+};
+
+const trace_case cases[] = {
+  {"format0 short",             0, 5,     1, 0,     0,     0},
+  {"format0 full",              0, 4096,  2, 0,     0,     0},
+  {"format0 empty word",        0, 4096,  3, 0.001, 0,     0},
+  {"format0 over max samples",  0, 20000, 4, 0,     0,     0},
+  {"format1 full",              1, 4096,  5, 0,     0.01,  0},
+  {"format1 dense training",    1, 4096,  6, 0,     0.2,   0},
+  {"format1 empty word",        1, 4096,  7, 0.001, 0.01,  0},
+  {"format1 garbage",           1, 4096,  8, 0,     0.01,  37},
+  {"format1 unaligned runs",    1, 1023,  9, 0,     0.05,  3}
+};
+
+const uint64_t ts_mask = 0x1FFFFFFFFFFF;
+const uint64_t train_bit = 1ULL << 63;
+
+// Clock training packets carry a 16 bit slice of the host timestamp
+// above the device timestamp
+void
+add_training(std::vector<uint64_t>& buf, uint64_t& ts, std::mt19937_64& rng)
+{
+  uint64_t host = rng();
+  for (int mod = 0; mod < 4; ++mod) {
+    ts += rng() % 16;
+    buf.push_back(train_bit | (((host >> (16 * mod)) & 0xFFFF) << 45) | (ts & ts_mask));
+  }
+}
+
+std::vector<uint64_t>
+make_buffer(const trace_case& tc, std::mt19937_64& rng, uint64_t& ts, bool first)
+{
+  std::vector<uint64_t> buf;
+  std::uniform_real_distribution<double> coin(0, 1);
+
+  if (first) {
+    for (size_t i = 0; i < tc.garbage; ++i)
+      buf.push_back(rng() & ~train_bit);
+    if (tc.format == 1) {
+      add_training(buf, ts, rng);
+      add_training(buf, ts, rng);
+    }
+  }
+
+  while (buf.size() < tc.packets) {
+    if (tc.empty && coin(rng) < tc.empty) {
+      buf.push_back(0);
+      break;
+    }
+    if (tc.format == 1 && coin(rng) < tc.train) {
+      add_training(buf, ts, rng);
+      continue;
+    }
+
+    // Flags, ID, pulse and overflow are random; format 1 data packets
+    // have the clock training bit clear
+    ts += rng() % 64;
+    uint64_t packet = (rng() & ~ts_mask) | (ts & ts_mask);
+    if (tc.format == 1)
+      packet &= ~train_bit;
+    if (!packet)
+      packet = 1;
+    buf.push_back(packet);
+  }
+  return buf;
+}
+
+std::string
+dump(const xclTraceResultsVector& tv)
+{
+  std::ostringstream os;
+  os << "length " << tv.mLength << "\n";
+  for (unsigned int i = 0; i < tv.mLength; ++i) {
+    auto& r = tv.mArray[i];
+    os << i << ":"
+       << " id " << r.EventID
+       << " type " << r.EventType
+       << " ts " << r.Timestamp
+       << " ovf " << static_cast<int>(r.Overflow)
+       << " trace " << r.TraceID
+       << " err " << static_cast<int>(r.Error)
+       << " rsvd " << static_cast<int>(r.Reserved)
+       << " train " << r.isClockTrain
+       << " host " << r.HostTimestamp
+       << " flags " << static_cast<int>(r.EventFlags)
+       << "\n";
+  }
+  return os.str();
+}
+
+std::string
+first_difference(const std::string& a, const std::string& b)
+{
+  std::istringstream sa(a), sb(b);
+  std::string la, lb;
+  while (true) {
+    bool ga = static_cast<bool>(std::getline(sa, la));
+    bool gb = static_cast<bool>(std::getline(sb, lb));
+    if (!ga && !gb)
+      return "";
+    if (!ga || !gb || la != lb)
+      return "  expected: " + la + "\n  actual:   " + lb + "\n";
+  }
+}
+
+bool
+run_case(const trace_case& tc)
+{
+  std::ostringstream log;
+  xdp::TraceS2MM reference(nullptr, 0);
+  reference.setLogStream(&log);
+  reference.setTraceFormat(tc.format);
+
+  xdp::TraceS2MM batched(nullptr, 0);
+  batched.setTraceFormat(tc.format);
+
+  std::unique_ptr<xclTraceResultsVector> expected(new xclTraceResultsVector);
+  std::unique_ptr<xclTraceResultsVector> actual(new xclTraceResultsVector);
+
+  std::mt19937_64 rng(tc.seed);
+  uint64_t ts = rng() & (ts_mask >> 4);
+  for (int call = 0; call < 2; ++call) {
+    auto buf = make_buffer(tc, rng, ts, call == 0);
+    auto bytes = buf.size() * sizeof(uint64_t);
+
+    std::memset(expected.get(), 0, sizeof(xclTraceResultsVector));
+    std::memset(actual.get(), 0, sizeof(xclTraceResultsVector));
+    reference.parseTraceBuf(buf.data(), bytes, *expected);
+    batched.parseTraceBuf(buf.data(), bytes, *actual);
+    log.str("");
+
+    auto want = dump(*expected);
+    auto got = dump(*actual);
+    if (want != got) {
+      std::cerr << "FAILED: " << tc.name << ", buffer " << call << "\n"
+                << first_difference(want, got);
+      return false;
+    }
+    if (!expected->mLength && tc.packets > 8) {
+      std::cerr << "FAILED: " << tc.name << ", buffer " << call << " decoded nothing\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int
+main()
+{
+  // ProfileIP warns about the missing device on stdout
+  auto buf = std::cout.rdbuf();
+  std::ostringstream quiet;
+  std::cout.rdbuf(quiet.rdbuf());
+
+  int failures = 0;
+  for (auto& tc : cases)
+    if (!run_case(tc))
+      ++failures;
+
+  std::cout.rdbuf(buf);
+  if (!failures)
+    std::cout << "trace_s2mm_test: PASSED\n";
+  return failures;
+}
@@ -17,9 +17,15 @@
 #include "traceS2MM.h"
 #include "tracedefs.h"
 //#include "xdp/profile/core/rt_util.h"
+#include <algorithm>
 #include <bitset>
 #include <iomanip>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define XDP_TRACE_SIMD_X86
+#endif
+
 namespace xdp {
 
 TraceS2MM::TraceS2MM(Device* handle /** < [in] the xrt or hal device handle */,
@@ -230,6 +236,192 @@ uint64_t TraceS2MM::seekClockTraining(uint64_t* arr, uint64_t count)
   return count;
 }
 
+namespace {
+
+// Batch decoder for runs of data packets.  Packets are classified and
+// unpacked into a structure of arrays staging buffer with vector bit
+// extraction (AVX2 or SSE2 when available), then emitted as trace
+// results.  The result must match TraceS2MM::parsePacket bit for bit.
+constexpr uint64_t packetTsMask = 0x1FFFFFFFFFFF;
+constexpr size_t stageSize = 256;
+
+struct PacketStage
+{
+  uint64_t timestamp[stageSize]; // (packet & mask) - first timestamp
+  uint64_t flags[stageSize];     // (packet >> 45) & 0xF
+  uint64_t id[stageSize];        // (packet >> 49) & 0xFFF
+  uint64_t pulse[stageSize];     // (packet >> 61) & 0x1
+  uint64_t overflow[stageSize];  // (packet >> 62) & 0x1
+};
+
+// Number of leading packets that are data packets, a run ends at an
+// empty packet or, with trace format 1, at a clock training packet
+size_t classifyScalar(const uint64_t* in, size_t n, bool format1)
+{
+  for (size_t i = 0; i < n; ++i)
+    if (!in[i] || (format1 && (in[i] >> 63)))
+      return i;
+  return n;
+}
+
+// Unpack packets [begin, n), returns n
+size_t unpackScalar(const uint64_t* in, size_t begin, size_t n, uint64_t firstTs, PacketStage& s)
+{
+  for (size_t i = begin; i < n; ++i) {
+    auto packet = in[i];
+    s.timestamp[i] = (packet & packetTsMask) - firstTs;
+    s.flags[i] = (packet >> 45) & 0xF;
+    s.id[i] = (packet >> 49) & 0xFFF;
+    s.pulse[i] = (packet >> 61) & 0x1;
+    s.overflow[i] = (packet >> 62) & 0x1;
+  }
+  return n;
+}
+
+#ifdef XDP_TRACE_SIMD_X86
+__attribute__((target("avx2")))
+size_t classifyAVX2(const uint64_t* in, size_t n, bool format1)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    int stop = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(p, zero)));
+    if (format1)
+      stop |= _mm256_movemask_pd(_mm256_castsi256_pd(p));
+    if (stop)
+      return i + __builtin_ctz(stop);
+  }
+  return i + classifyScalar(in + i, n - i, format1);
+}
+
+__attribute__((target("avx2")))
+size_t unpackAVX2(const uint64_t* in, size_t n, uint64_t firstTs, PacketStage& s)
+{
+  const __m256i tsMask = _mm256_set1_epi64x(packetTsMask);
+  const __m256i first = _mm256_set1_epi64x(firstTs);
+  const __m256i mask4 = _mm256_set1_epi64x(0xF);
+  const __m256i mask12 = _mm256_set1_epi64x(0xFFF);
+  const __m256i mask1 = _mm256_set1_epi64x(0x1);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.timestamp + i),
+                        _mm256_sub_epi64(_mm256_and_si256(p, tsMask), first));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.flags + i),
+                        _mm256_and_si256(_mm256_srli_epi64(p, 45), mask4));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.id + i),
+                        _mm256_and_si256(_mm256_srli_epi64(p, 49), mask12));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.pulse + i),
+                        _mm256_and_si256(_mm256_srli_epi64(p, 61), mask1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.overflow + i),
+                        _mm256_and_si256(_mm256_srli_epi64(p, 62), mask1));
+  }
+  return unpackScalar(in, i, n, firstTs, s);
+}
+
+size_t classifySSE2(const uint64_t* in, size_t n, bool format1)
+{
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, zero));
+    int stop = ((eq & 0xFF) == 0xFF) | (((eq >> 8) == 0xFF) << 1);
+    if (format1)
+      stop |= _mm_movemask_pd(_mm_castsi128_pd(p));
+    if (stop)
+      return i + __builtin_ctz(stop);
+  }
+  return i + classifyScalar(in + i, n - i, format1);
+}
+
+size_t unpackSSE2(const uint64_t* in, size_t n, uint64_t firstTs, PacketStage& s)
+{
+  const __m128i tsMask = _mm_set1_epi64x(packetTsMask);
+  const __m128i first = _mm_set1_epi64x(firstTs);
+  const __m128i mask4 = _mm_set1_epi64x(0xF);
+  const __m128i mask12 = _mm_set1_epi64x(0xFFF);
+  const __m128i mask1 = _mm_set1_epi64x(0x1);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s.timestamp + i),
+                     _mm_sub_epi64(_mm_and_si128(p, tsMask), first));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s.flags + i),
+                     _mm_and_si128(_mm_srli_epi64(p, 45), mask4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s.id + i),
+                     _mm_and_si128(_mm_srli_epi64(p, 49), mask12));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s.pulse + i),
+                     _mm_and_si128(_mm_srli_epi64(p, 61), mask1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s.overflow + i),
+                     _mm_and_si128(_mm_srli_epi64(p, 62), mask1));
+  }
+  return unpackScalar(in, i, n, firstTs, s);
+}
+#endif
+
+size_t unpackDefault(const uint64_t* in, size_t n, uint64_t firstTs, PacketStage& s)
+{
+  return unpackScalar(in, 0, n, firstTs, s);
+}
+
+struct PacketDecoder
+{
+  size_t (*classify)(const uint64_t*, size_t, bool) = classifyScalar;
+  size_t (*unpack)(const uint64_t*, size_t, uint64_t, PacketStage&) = unpackDefault;
+
+  PacketDecoder()
+  {
+#ifdef XDP_TRACE_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) {
+      classify = classifyAVX2;
+      unpack = unpackAVX2;
+    }
+    else {
+      classify = classifySSE2;
+      unpack = unpackSSE2;
+    }
+#endif
+  }
+};
+
+void emitPackets(const PacketStage& s, size_t n, xclTraceResults* out)
+{
+  for (size_t i = 0; i < n; ++i) {
+    auto& result = out[i];
+    result.Timestamp = s.timestamp[i];
+    result.EventType = s.flags[i] ? XCL_PERF_MON_END_EVENT : XCL_PERF_MON_START_EVENT;
+    result.TraceID = static_cast<unsigned int>(s.id[i]);
+    result.Reserved = static_cast<unsigned char>(s.pulse[i]);
+    result.Overflow = static_cast<unsigned char>(s.overflow[i]);
+    result.EventID = XCL_PERF_MON_HW_EVENT;
+    result.EventFlags = static_cast<unsigned char>(s.flags[i] | (s.pulse[i] << 4));
+    result.isClockTrain = 0;
+  }
+}
+
+// Decode the leading run of data packets, returns the number decoded
+uint64_t decodeDataPackets(const uint64_t* in, uint64_t n, bool format1,
+                           uint64_t firstTs, xclTraceResults* out)
+{
+  static const PacketDecoder decoder;
+  PacketStage stage;
+  uint64_t done = 0;
+  while (done < n) {
+    size_t block = static_cast<size_t>(std::min<uint64_t>(stageSize, n - done));
+    size_t run = decoder.classify(in + done, block, format1);
+    decoder.unpack(in + done, run, firstTs, stage);
+    emitPackets(stage, run, out + done);
+    done += run;
+    if (run < block)
+      break;
+  }
+  return done;
+}
+
+} // namespace
+
 void TraceS2MM::parseTraceBuf(void* buf, uint64_t size, xclTraceResultsVector& traceVector)
 {
     if(out_stream)
@@ -257,6 +449,20 @@ void TraceS2MM::parseTraceBuf(void* buf, uint64_t size, xclTraceResultsVector& t
       return;
 
     for (auto i = idx; i < count; i++) {
+      // Runs of data packets are decoded in batches.  The first packet,
+      // clock training and debug output take the per packet path below.
+      bool batch = !out_stream && i > 0
+        && (mTraceFormat == 1 || i >= 8 || mclockTrainingdone);
+      if (batch) {
+        auto n = decodeDataPackets(pos + i, count - i, mTraceFormat == 1,
+                                   mPacketFirstTs, traceVector.mArray + tvindex);
+        tvindex += n;
+        i += n;
+        traceVector.mLength = tvindex;
+        if (i == count)
+          break;
+      }
+
       auto currentPacket = pos[i];
       if (!currentPacket)
         return;
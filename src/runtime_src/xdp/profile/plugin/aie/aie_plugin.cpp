@@ -16,8 +16,11 @@
 
 #define XDP_SOURCE
 
+#include <algorithm>
+
 #include "xdp/profile/plugin/aie/aie_plugin.h"
 #include "xdp/profile/writer/aie/aie_writer.h"
+#include "xdp/profile/plugin/vp_base/sampler.h"
 
 #include "core/common/system.h"
 #include "core/common/time.h"
@@ -34,7 +37,8 @@ extern "C" {
 namespace xdp {
 
   AIEProfilingPlugin::AIEProfilingPlugin() 
-      : XDPPlugin(), mKeepPolling(true)
+      : XDPPlugin(), mSamplerId(0), mPollingInterval(20), mWriteSamples(1),
+        mNumSamples(0)
   {
     db->registerPlugin(this);
    
@@ -65,15 +69,17 @@ namespace xdp {
     // Get polling interval (in msec)
     mPollingInterval = xrt_core::config::get_aie_profile_interval_ms();
 
-    // Start the AIE profiling thread
-    mPollingThread = std::thread(&AIEProfilingPlugin::pollAIECounters, this);
+    // Stream samples to file about once a second
+    mWriteSamples = mPollingInterval ? std::max(1000u / mPollingInterval, 1u) : 1000;
+
+    // Start sampling AIE counters
+    mSamplerId = Sampler::instance().addSource(mPollingInterval,
+                                               [this] { sampleAIECounters(); });
   }
 
   AIEProfilingPlugin::~AIEProfilingPlugin()
   {
-    // Stop the polling thread
-    mKeepPolling = false;
-    mPollingThread.join();
+    stopSampling();
 
     if (VPDatabase::alive()) {
       for (auto w : writers) {
@@ -84,55 +90,74 @@ namespace xdp {
     }
   }
 
-  void AIEProfilingPlugin::pollAIECounters()
+  void AIEProfilingPlugin::stopSampling()
   {
-    while (mKeepPolling) {
-      uint64_t index = 0;
-
-      // Iterate over all devices
-      for (auto handle : mHandles) {
-        // Wait until xclbin has been loaded and device has been updated in database
-        if (!(db->getStaticInfo().isDeviceReady(index))) {
-          ++index;
-          continue;
-        }
+    if (mSamplerId) {
+      Sampler::instance().removeSource(mSamplerId);
+      mSamplerId = 0;
+    }
+  }
 
-        auto drv = ZYNQ::shim::handleCheck(handle);
-        if (!drv)
-          continue;
-        auto aieArray = drv->getAieArray();
-        if (!aieArray)
+  void AIEProfilingPlugin::writeAll(bool openNewFiles)
+  {
+    // No more samples after the final write
+    stopSampling();
+    XDPPlugin::writeAll(openNewFiles);
+  }
+
+  void AIEProfilingPlugin::sampleAIECounters()
+  {
+    std::vector<void*> handles;
+    {
+      std::lock_guard<std::mutex> lock(mHandleLock);
+      handles = mHandles;
+    }
+
+    // Iterate over all devices
+    for (uint64_t index = 0; index < handles.size(); ++index) {
+      // Wait until xclbin has been loaded and device has been updated in database
+      if (!(db->getStaticInfo().isDeviceReady(index)))
+        continue;
+
+      auto drv = ZYNQ::shim::handleCheck(handles[index]);
+      if (!drv)
+        continue;
+      auto aieArray = drv->getAieArray();
+      if (!aieArray)
+        continue;
+
+      // Iterate over all AIE Counters
+      auto numCounters = db->getStaticInfo().getNumAIECounter(index);
+      for (uint64_t c=0; c < numCounters; c++) {
+        auto aie = db->getStaticInfo().getAIECounter(index, c);
+        if (!aie)
           continue;
 
-        // Iterate over all AIE Counters
-        auto numCounters = db->getStaticInfo().getNumAIECounter(index);
-        for (uint64_t c=0; c < numCounters; c++) {
-          auto aie = db->getStaticInfo().getAIECounter(index, c);
-          if (!aie)
-            continue;
-
-          std::vector<uint64_t> values;
-          values.push_back(aie->column);
-          values.push_back(aie->row);
-          values.push_back(aie->startEvent);
-          values.push_back(aie->endEvent);
-          values.push_back(aie->resetEvent);
-
-          // Read counter value from device
-          XAie_LocType tileLocation = XAie_TileLoc(aie->column, aie->row+1);
-          uint32_t counterValue;
-          XAie_PerfCounterGet(aieArray->getDevInst(), tileLocation, XAIE_CORE_MOD, aie->counterNumber, &counterValue);
-          values.push_back(counterValue);
-
-          // Get timestamp in milliseconds
-          double timestamp = xrt_core::time_ns() / 1.0e6;
-
-	        db->getDynamicInfo().addAIESample(index, timestamp, values);
-        }
-        ++index;
+        std::vector<uint64_t> values;
+        values.reserve(6);
+        values.push_back(aie->column);
+        values.push_back(aie->row);
+        values.push_back(aie->startEvent);
+        values.push_back(aie->endEvent);
+        values.push_back(aie->resetEvent);
+
+        // Read counter value from device
+        XAie_LocType tileLocation = XAie_TileLoc(aie->column, aie->row+1);
+        uint32_t counterValue;
+        XAie_PerfCounterGet(aieArray->getDevInst(), tileLocation, XAIE_CORE_MOD, aie->counterNumber, &counterValue);
+        values.push_back(counterValue);
+
+        // Get timestamp in milliseconds
+        double timestamp = xrt_core::time_ns() / 1.0e6;
+
+        db->getDynamicInfo().addAIESample(index, timestamp, values);
       }
+    }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(mPollingInterval));     
+    if (++mNumSamples % mWriteSamples == 0) {
+      for (auto w : writers) {
+        w->write(false);
+      }
     }
   }
 
@@ -143,7 +168,10 @@ namespace xdp {
     xclGetDebugIPlayoutPath(handle, pathBuf, 512);
 
     std::string sysfspath(pathBuf);
-    mHandles.push_back(handle);
+    {
+      std::lock_guard<std::mutex> lock(mHandleLock);
+      mHandles.push_back(handle);
+    }
 
     uint64_t deviceId = db->addDevice(sysfspath); // Get the unique device Id
 
@@ -17,9 +17,9 @@
 #ifndef XDP_AIE_PLUGIN_DOT_H
 #define XDP_AIE_PLUGIN_DOT_H
 
+#include <mutex>
 #include <vector>
 #include <string>
-#include <thread>
 
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 #include "xdp/config.h"
@@ -37,14 +37,21 @@ namespace xdp {
     XDP_EXPORT
     void updateAIEDevice(void* handle);
 
+    XDP_EXPORT
+    virtual void writeAll(bool openNewFiles);
+
   private:
-    void pollAIECounters();
+    void sampleAIECounters();
+    void stopSampling();
 
   private:
-    // AIE profiling uses its own thread
-    bool mKeepPolling;
+    // AIE counters are sampled by the shared sampler thread, and
+    // samples are streamed to file every mWriteSamples samples
+    uint64_t mSamplerId;
     unsigned int mPollingInterval;
-    std::thread mPollingThread;
+    unsigned int mWriteSamples;
+    unsigned int mNumSamples;
+    std::mutex mHandleLock;
     std::vector<void*> mHandles;
   };
 
@@ -18,18 +18,21 @@
 
 #include "xdp/profile/plugin/noc/noc_plugin.h"
 #include "xdp/profile/writer/noc/noc_writer.h"
+#include "xdp/profile/plugin/vp_base/sampler.h"
 
 #include "core/common/system.h"
 #include "core/common/time.h"
 #include "core/common/config_reader.h"
 #include "core/include/experimental/xrt-next.h"
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 
 namespace xdp {
 
   NOCProfilingPlugin::NOCProfilingPlugin() 
-      : XDPPlugin(), mKeepPolling(true)
+      : XDPPlugin(), mSamplerId(0), mPollingInterval(20), mWriteSamples(1),
+        mPollNum(0)
   {
     db->registerPlugin(this);
    
@@ -58,15 +61,17 @@ namespace xdp {
     // Get polling interval (in msec)
     mPollingInterval = xrt_core::config::get_noc_profile_interval_ms();
 
-    // Start the NOC profiling thread
-    mPollingThread = std::thread(&NOCProfilingPlugin::pollNOCCounters, this);
+    // Stream samples to file about once a second
+    mWriteSamples = mPollingInterval ? std::max(1000u / mPollingInterval, 1u) : 1000;
+
+    // Start sampling NOC counters
+    mSamplerId = Sampler::instance().addSource(mPollingInterval,
+                                               [this] { sampleNOCCounters(); });
   }
 
   NOCProfilingPlugin::~NOCProfilingPlugin()
   {
-    // Stop the polling thread
-    mKeepPolling = false;
-    mPollingThread.join();
+    stopSampling();
 
     if (VPDatabase::alive()) {
       for (auto w : writers) {
@@ -77,62 +82,77 @@ namespace xdp {
     }
   }
 
-  void NOCProfilingPlugin::pollNOCCounters()
+  void NOCProfilingPlugin::stopSampling()
+  {
+    if (mSamplerId) {
+      Sampler::instance().removeSource(mSamplerId);
+      mSamplerId = 0;
+    }
+  }
+
+  void NOCProfilingPlugin::writeAll(bool openNewFiles)
+  {
+    // No more samples after the final write
+    stopSampling();
+    XDPPlugin::writeAll(openNewFiles);
+  }
+
+  void NOCProfilingPlugin::sampleNOCCounters()
   {
-    uint32_t pollnum = 0;
-
-    while (mKeepPolling) {
-      // Get timestamp in milliseconds
-      double timestamp = xrt_core::time_ns() / 1.0e6;
-      uint64_t index = 0;
-
-      // Iterate over all devices
-      for (auto device : mDevices) {
-        // Iterate over all NOC NMUs
-        auto numNOC = db->getStaticInfo().getNumNOC(index);
-        for (uint64_t n=0; n < numNOC; n++) {
-          auto noc = db->getStaticInfo().getNOC(index, n);
-
-          // Name = <master>-<NMU cell>-<read QoS>-<write QoS>-<NPI freq>-<AIE freq>
-          std::vector<std::string> result; 
-          boost::split(result, noc->name, boost::is_any_of("-"));
-          std::string cellName = (result.size() > 1) ? result[1] : "N/A";
-
-          // TODO: replace dummy data with counter values
-          std::vector<uint64_t> values;
-
-          // Read
-          uint64_t readByteCount    = pollnum * 128;
-          uint64_t readBurstCount   = pollnum * 10;
-          uint64_t readTotalLatency = pollnum * 1000;
-          uint64_t readMinLatency   = 42;
-          uint64_t readMaxLatency   = 100;
-          values.push_back(readByteCount);
-          values.push_back(readBurstCount);
-          values.push_back(readTotalLatency);
-          values.push_back(readMinLatency);
-          values.push_back(readMaxLatency);
-
-          // Write
-          uint64_t writeByteCount    = pollnum * 234;
-          uint64_t writeBurstCount   = pollnum * 21;
-          uint64_t writeTotalLatency = pollnum * 1234;
-          uint64_t writeMinLatency   = 24;
-          uint64_t writeMaxLatency   = 123;
-          values.push_back(writeByteCount);
-          values.push_back(writeBurstCount);
-          values.push_back(writeTotalLatency);
-          values.push_back(writeMinLatency);
-          values.push_back(writeMaxLatency);
-
-          // Add sample to dynamic database
-	        db->getDynamicInfo().addNOCSample(index, timestamp, cellName, values);
-	        ++index;
-        }
+    uint32_t pollnum = mPollNum++;
+
+    // Get timestamp in milliseconds
+    double timestamp = xrt_core::time_ns() / 1.0e6;
+
+    // Iterate over all devices
+    for (uint64_t index = 0; index < mDevices.size(); ++index) {
+      // Iterate over all NOC NMUs
+      auto numNOC = db->getStaticInfo().getNumNOC(index);
+      for (uint64_t n=0; n < numNOC; n++) {
+        auto noc = db->getStaticInfo().getNOC(index, n);
+
+        // Name = <master>-<NMU cell>-<read QoS>-<write QoS>-<NPI freq>-<AIE freq>
+        std::vector<std::string> result; 
+        boost::split(result, noc->name, boost::is_any_of("-"));
+        std::string cellName = (result.size() > 1) ? result[1] : "N/A";
+
+        // TODO: replace dummy data with counter values
+        std::vector<uint64_t> values;
+        values.reserve(10);
+
+        // Read
+        uint64_t readByteCount    = pollnum * 128;
+        uint64_t readBurstCount   = pollnum * 10;
+        uint64_t readTotalLatency = pollnum * 1000;
+        uint64_t readMinLatency   = 42;
+        uint64_t readMaxLatency   = 100;
+        values.push_back(readByteCount);
+        values.push_back(readBurstCount);
+        values.push_back(readTotalLatency);
+        values.push_back(readMinLatency);
+        values.push_back(readMaxLatency);
+
+        // Write
+        uint64_t writeByteCount    = pollnum * 234;
+        uint64_t writeBurstCount   = pollnum * 21;
+        uint64_t writeTotalLatency = pollnum * 1234;
+        uint64_t writeMinLatency   = 24;
+        uint64_t writeMaxLatency   = 123;
+        values.push_back(writeByteCount);
+        values.push_back(writeBurstCount);
+        values.push_back(writeTotalLatency);
+        values.push_back(writeMinLatency);
+        values.push_back(writeMaxLatency);
+
+        // Add sample to dynamic database
+        db->getDynamicInfo().addNOCSample(index, timestamp, cellName, values);
       }
+    }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(mPollingInterval));
-      ++pollnum;      
+    if (mPollNum % mWriteSamples == 0) {
+      for (auto w : writers) {
+        w->write(false);
+      }
     }
   }
 
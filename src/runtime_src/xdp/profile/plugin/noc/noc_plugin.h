@@ -19,7 +19,6 @@
 
 #include <vector>
 #include <string>
-#include <thread>
 
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 #include "xdp/config.h"
@@ -32,14 +31,19 @@ namespace xdp {
     NOCProfilingPlugin();
     ~NOCProfilingPlugin();
 
+    XDP_EXPORT virtual void writeAll(bool openNewFiles);
+
   private:
-    void pollNOCCounters();
+    void sampleNOCCounters();
+    void stopSampling();
 
   private:
-    // NOC profiling uses its own thread
-    bool mKeepPolling;
+    // NOC counters are sampled by the shared sampler thread, and
+    // samples are streamed to file every mWriteSamples samples
+    uint64_t mSamplerId;
     unsigned int mPollingInterval;
-    std::thread mPollingThread;
+    unsigned int mWriteSamples;
+    uint32_t mPollNum;
     std::vector<std::string> mDevices;
   };
 
@@ -16,8 +16,11 @@
 
 #define XDP_SOURCE
 
+#include <algorithm>
+
 #include "xdp/profile/plugin/power/power_plugin.h"
 #include "xdp/profile/writer/power/power_writer.h"
+#include "xdp/profile/plugin/vp_base/sampler.h"
 #include "core/common/system.h"
 #include "core/common/time.h"
 #include "core/common/config_reader.h"
@@ -54,7 +57,8 @@ namespace xdp {
     } ;
 
   PowerProfilingPlugin::PowerProfilingPlugin() :
-    XDPPlugin(), keepPolling(true), pollingInterval(20)
+    XDPPlugin(), samplerId(0), pollingInterval(20), writeSamples(1),
+    numSamples(0)
   {
     db->registerPlugin(this) ;
 
@@ -94,15 +98,17 @@ namespace xdp {
       handle = xclOpen(index, "/dev/null", XCL_INFO) ;
     }
 
-    // Start the power profiling thread
-    pollingThread = std::thread(&PowerProfilingPlugin::pollPower, this) ;
+    // Stream samples to file about once a second
+    writeSamples = pollingInterval ? std::max(1000u / pollingInterval, 1u) : 1000 ;
+
+    // Start sampling power
+    samplerId = Sampler::instance().addSource(pollingInterval,
+                                              [this] { samplePower() ; }) ;
   }
 
   PowerProfilingPlugin::~PowerProfilingPlugin()
   {
-    // Stop the polling thread
-    keepPolling = false ;
-    pollingThread.join() ;
+    stopSampling() ;
 
     if (VPDatabase::alive())
     {
@@ -115,39 +121,59 @@ namespace xdp {
     }
   }
 
-  void PowerProfilingPlugin::pollPower()
+  void PowerProfilingPlugin::stopSampling()
+  {
+    if (samplerId)
+    {
+      Sampler::instance().removeSource(samplerId) ;
+      samplerId = 0 ;
+    }
+  }
+
+  void PowerProfilingPlugin::writeAll(bool openNewFiles)
+  {
+    // No more samples after the final write
+    stopSampling() ;
+    XDPPlugin::writeAll(openNewFiles) ;
+  }
+
+  void PowerProfilingPlugin::samplePower()
   {
-    while(keepPolling)
+    // Get timestamp in milliseconds
+    double timestamp = xrt_core::time_ns() / 1.0e6 ;
+    uint64_t index = 0 ;
+    for (auto& device : filePaths)
     {
-      // Get timestamp in milliseconds
-      double timestamp = xrt_core::time_ns() / 1.0e6 ;
-      uint64_t index = 0 ;
-      for (auto device : filePaths)
+      std::vector<uint64_t> values ;
+      values.reserve(device.size()) ;
+      for (auto& file : device)
       {
-	std::vector<uint64_t> values ;
-	for (auto file : device)
+	std::ifstream fs(file) ;
+	if (!fs)
 	{
-	  std::ifstream fs(file) ;
-	  if (!fs)
-	  {
-	    // When we tried to get the path to this file, we got a bad
-	    //  result (like empty string).  So all devices are aligned and
-	    //  have the same amount of information we'll just record this
-	    //  data element as 0.
-	    values.push_back(0) ;
-	    continue ;
-	  }
-	  std::string data ;
-	  std::getline(fs, data) ;
-	  uint64_t dp = data.empty() ? 0 : std::stoul(data) ;
-	  values.push_back(dp) ;
-	  fs.close() ;
+	  // When we tried to get the path to this file, we got a bad
+	  //  result (like empty string).  So all devices are aligned and
+	  //  have the same amount of information we'll just record this
+	  //  data element as 0.
+	  values.push_back(0) ;
+	  continue ;
 	}
-	(db->getDynamicInfo()).addPowerSample(index, timestamp, values) ;
-	++index ;	
+	std::string data ;
+	std::getline(fs, data) ;
+	uint64_t dp = data.empty() ? 0 : std::stoul(data) ;
+	values.push_back(dp) ;
+	fs.close() ;
       }
+      (db->getDynamicInfo()).addPowerSample(index, timestamp, values) ;
+      ++index ;
+    }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(pollingInterval)) ;
+    if (++numSamples % writeSamples == 0)
+    {
+      for (auto w : writers)
+      {
+	w->write(false) ;
+      }
     }
   }
 
@@ -19,7 +19,6 @@
 
 #include <vector>
 #include <string>
-#include <thread>
 
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 #include "xdp/config.h"
@@ -35,16 +34,20 @@ namespace xdp {
   private:
     std::vector<std::vector<std::string>> filePaths ;
 
-    // Power profiling requires its own thread
-    bool keepPolling ;
-    std::thread pollingThread ;
+    // Power is sampled by the shared sampler thread, and samples are
+    //  streamed to file every writeSamples samples
+    uint64_t samplerId ;
     unsigned int pollingInterval ;
-    void pollPower() ;
+    unsigned int writeSamples ;
+    unsigned int numSamples ;
+    void samplePower() ;
+    void stopSampling() ;
   public:
     PowerProfilingPlugin() ;
     ~PowerProfilingPlugin() ;
 
     XDP_EXPORT void addDevice(void* handle) ;
+    XDP_EXPORT virtual void writeAll(bool openNewFiles) ;
   } ;
 
 } // end namespace xdp
@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include "xdp/profile/plugin/vp_base/sampler.h"
+
+namespace xdp {
+
+  Sampler::Sampler() : nextId(1), running(0), stop(false),
+                       start(clock::now())
+  {
+  }
+
+  Sampler::~Sampler()
+  {
+    {
+      std::lock_guard<std::mutex> lk(lock) ;
+      stop = true ;
+    }
+    changed.notify_all() ;
+    if (samplingThread.joinable())
+      samplingThread.join() ;
+  }
+
+  Sampler& Sampler::instance()
+  {
+    static Sampler sampler ;
+    return sampler ;
+  }
+
+  uint64_t Sampler::addSource(unsigned int intervalMs, SampleFunction sample)
+  {
+    std::chrono::milliseconds interval(intervalMs ? intervalMs : 1) ;
+
+    std::lock_guard<std::mutex> lk(lock) ;
+    auto elapsed = clock::now() - start ;
+    auto next = start + interval * (elapsed / interval + 1) ;
+    auto id = nextId++ ;
+    sources[id] = Source{interval, next, std::move(sample)} ;
+
+    // The sampling thread runs while there are sources.  If the thread
+    //  is being stopped, removeSource restarts it after the join.
+    if (!samplingThread.joinable() && !stop)
+      samplingThread = std::thread(&Sampler::sampleSources, this) ;
+    changed.notify_all() ;
+    return id ;
+  }
+
+  void Sampler::removeSource(uint64_t id)
+  {
+    std::thread done ;
+    {
+      std::unique_lock<std::mutex> lk(lock) ;
+      while (running == id)
+        changed.wait(lk) ;
+      sources.erase(id) ;
+
+      if (sources.empty() && samplingThread.joinable()) {
+        stop = true ;
+        done = std::move(samplingThread) ;
+      }
+    }
+    changed.notify_all() ;
+    if (!done.joinable())
+      return ;
+    done.join() ;
+
+    // Sources added while the thread was stopping need a new thread
+    std::lock_guard<std::mutex> lk(lock) ;
+    stop = false ;
+    if (!sources.empty() && !samplingThread.joinable())
+      samplingThread = std::thread(&Sampler::sampleSources, this) ;
+  }
+
+  void Sampler::sampleSources()
+  {
+    std::unique_lock<std::mutex> lk(lock) ;
+    while (!stop) {
+      if (sources.empty()) {
+        changed.wait(lk) ;
+        continue ;
+      }
+
+      auto due = sources.begin()->second.next ;
+      for (auto& source : sources)
+        due = std::min(due, source.second.next) ;
+
+      auto now = clock::now() ;
+      if (now < due) {
+        changed.wait_until(lk, due) ;
+        continue ;
+      }
+
+      // Sample all sources that are due.  The lock is released while
+      //  sampling so sources can be added, a source being sampled
+      //  cannot be removed.
+      for (auto itr = sources.begin() ; itr != sources.end() ; ++itr) {
+        auto& source = itr->second ;
+        if (source.next > now)
+          continue ;
+
+        running = itr->first ;
+        auto sample = source.sample ;
+        lk.unlock() ;
+        sample() ;
+        lk.lock() ;
+        running = 0 ;
+
+        // Skip sample times that were missed
+        auto elapsed = clock::now() - start ;
+        source.next = start + source.interval * (elapsed / source.interval + 1) ;
+      }
+      changed.notify_all() ;
+    }
+  }
+
+} // end namespace xdp
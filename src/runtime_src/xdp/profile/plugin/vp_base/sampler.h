@@ -0,0 +1,81 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef XDP_SAMPLER_DOT_H
+#define XDP_SAMPLER_DOT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "xdp/config.h"
+
+namespace xdp {
+
+  // The sampler is shared by all plugins that periodically read
+  //  counters (power, NOC, AIE).  Every source registers a sample
+  //  function and an interval, and all sources are called from a
+  //  single thread.  Sample times of a source are multiples of its
+  //  interval from a common start time, so sources with the same or
+  //  harmonic intervals are sampled together and sampling does not
+  //  drift with the time spent reading counters.
+  class Sampler
+  {
+  public:
+    typedef std::function<void ()> SampleFunction ;
+
+  private:
+    typedef std::chrono::steady_clock clock ;
+
+    struct Source
+    {
+      std::chrono::milliseconds interval ;
+      clock::time_point next ;
+      SampleFunction sample ;
+    } ;
+
+    std::mutex lock ;
+    std::condition_variable changed ;
+    std::map<uint64_t, Source> sources ;
+    uint64_t nextId ;
+    uint64_t running ;  // id of source being sampled, 0 if none
+    bool stop ;
+    clock::time_point start ;
+    std::thread samplingThread ;
+
+    Sampler() ;
+    void sampleSources() ;
+
+  public:
+    XDP_EXPORT ~Sampler() ;
+    XDP_EXPORT static Sampler& instance() ;
+
+    // Sample function is called every interval milliseconds, starting
+    //  with the next multiple of interval.  Return id for removeSource.
+    XDP_EXPORT uint64_t addSource(unsigned int intervalMs,
+                                  SampleFunction sample) ;
+
+    // Return when the sample function is no longer called.  Must not be
+    //  called from a sample function.
+    XDP_EXPORT void removeSource(uint64_t id) ;
+  } ;
+
+} // end namespace xdp
+
+#endif
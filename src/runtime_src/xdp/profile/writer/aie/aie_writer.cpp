@@ -25,15 +25,19 @@ namespace xdp {
 					     const char* deviceName, uint64_t deviceIndex) :
     VPWriter(fileName),
     mDeviceName(deviceName),
-    mDeviceIndex(deviceIndex)
+    mDeviceIndex(deviceIndex),
+    mHeaderWritten(false)
   {
   }
 
   AIEProfilingWriter::~AIEProfilingWriter()
-  {    
+  {
+    // A run without samples still gets a file with the header
+    if (!mHeaderWritten && VPDatabase::alive())
+      writeHeader();
   }
 
-  void AIEProfilingWriter::write(bool openNewFile)
+  void AIEProfilingWriter::writeHeader()
   {
     // Grab AIE clock freq from first counter in metadata
     // NOTE: Assumed the same for all tiles
@@ -52,18 +56,30 @@ namespace xdp {
          << "reset"        << ","
          << "value"        << ","
          << std::endl;
+  }
 
-    // Write all data elements
-    std::vector<VPDynamicDatabase::CounterSample> samples = 
-      (db->getDynamicInfo()).getAIESamples(mDeviceIndex);
+  void AIEProfilingWriter::write(bool /*openNewFile*/)
+  {
+    // Write data elements added since the last write
+    (db->getDynamicInfo()).takeAIESamples(mDeviceIndex, mSamples);
+
+    // Samples are only added once the device is loaded, so the header
+    // written with the first samples has the AIE metadata
+    if (mSamples.empty() && !mHeaderWritten)
+      return;
+    if (!mHeaderWritten) {
+      writeHeader();
+      mHeaderWritten = true;
+    }
 
-    for (auto sample : samples) {
+    for (auto& sample : mSamples) {
       fout << sample.first << ","; // Timestamp
       for (auto value : sample.second) {
         fout << value << ",";
       }
-      fout << std::endl;
+      fout << "\n";
     }
+    fout.flush();
   }
 
 } // end namespace xdp
@@ -18,7 +18,9 @@
 #define AIE_WRITER_DOT_H
 
 #include <string>
+#include <vector>
 #include "xdp/profile/writer/vp_base/vp_writer.h"
+#include "xdp/profile/database/dynamic_event_database.h"
 
 namespace xdp {
 
@@ -34,6 +36,13 @@ namespace xdp {
   private:
     std::string mDeviceName;
     uint64_t mDeviceIndex;
+
+    // Samples are appended to the file as they are taken from the
+    // database, the header is written once
+    bool mHeaderWritten;
+    std::vector<VPDynamicDatabase::CounterSample> mSamples;
+
+    void writeHeader();
   };
 
 } // end namespace xdp
@@ -27,7 +27,8 @@ namespace xdp {
 					     const char* deviceName, uint64_t deviceIndex) :
     VPWriter(fileName),
     mDeviceName(deviceName),
-    mDeviceIndex(deviceIndex)
+    mDeviceIndex(deviceIndex),
+    mHeaderWritten(false)
   {
     // TODO: calculate sample period based on requested value 
     //       and granularity of clock frequency
@@ -35,10 +36,13 @@ namespace xdp {
   }
 
   NOCProfilingWriter::~NOCProfilingWriter()
-  {    
+  {
+    // A run without samples still gets a file with the headers
+    if (!mHeaderWritten && VPDatabase::alive())
+      writeHeader();
   }
 
-  void NOCProfilingWriter::write(bool openNewFile)
+  void NOCProfilingWriter::writeHeader()
   {
     // Write header #1
     fout << "Target device: " << mDeviceName << std::endl;
@@ -93,27 +97,37 @@ namespace xdp {
          << "write_min_latency"   << ","
          << "write_max_latency"   << ","
          << std::endl;
+  }
 
-    // Write all data elements
-    std::vector<VPDynamicDatabase::CounterSample> samples = 
-      (db->getDynamicInfo()).getNOCSamples(mDeviceIndex);
-    VPDynamicDatabase::CounterNames names = 
-      (db->getDynamicInfo()).getNOCNames(mDeviceIndex);
+  void NOCProfilingWriter::write(bool /*openNewFile*/)
+  {
+    // Write data elements added since the last write
+    (db->getDynamicInfo()).takeNOCSamples(mDeviceIndex, mSamples, mNames);
+
+    // Samples are only added once the device is loaded, so the header
+    // written with the first samples lists the NOC cells
+    if (mSamples.empty() && !mHeaderWritten)
+      return;
+    if (!mHeaderWritten) {
+      writeHeader();
+      mHeaderWritten = true;
+    }
 
-    for (auto sample : samples) {
+    for (auto& sample : mSamples) {
       fout << sample.first << ","; // Timestamp
       
       // Report NMU cell name for this sample
-      auto iter = names.find(sample.first);
-      std::string cellName = (iter == names.end()) ? "N/A" : iter->second;
+      auto iter = mNames.find(sample.first);
+      std::string cellName = (iter == mNames.end()) ? "N/A" : iter->second;
       fout << cellName << ",";
       
       // Report all samples at this timestamp for this NMU cell
       for (auto value : sample.second) {
         fout << value << ",";
       }
-      fout << std::endl;
+      fout << "\n";
     }
+    fout.flush();
   }
 
 } // end namespace xdp
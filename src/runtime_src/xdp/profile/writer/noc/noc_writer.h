@@ -18,8 +18,10 @@
 #define NOC_WRITER_DOT_H
 
 #include <string>
+#include <vector>
 
 #include "xdp/profile/writer/vp_base/vp_writer.h"
+#include "xdp/profile/database/dynamic_event_database.h"
 
 namespace xdp {
 
@@ -36,6 +38,14 @@ namespace xdp {
     double mSamplePeriod;
     std::string mDeviceName;
     uint64_t mDeviceIndex;
+
+    // Samples are appended to the file as they are taken from the
+    // database, the headers are written once
+    bool mHeaderWritten;
+    std::vector<VPDynamicDatabase::CounterSample> mSamples;
+    VPDynamicDatabase::CounterNames mNames;
+
+    void writeHeader();
   };
 
 } // end namespace xdp
@@ -24,7 +24,8 @@ namespace xdp {
   PowerProfilingWriter::PowerProfilingWriter(const char* filename,
 					     const char* d,
 					     uint64_t index) :
-    VPWriter(filename), deviceName(d), deviceIndex(index)
+    VPWriter(filename), deviceName(d), deviceIndex(index),
+    headerWritten(false)
   {
   }
 
@@ -32,9 +33,8 @@ namespace xdp {
   {    
   }
 
-  void PowerProfilingWriter::write(bool openNewFile)
+  void PowerProfilingWriter::writeHeader()
   {
-    // Write header
     fout << "Target device: " << deviceName << std::endl ;
     fout << "timestamp"    << ","
 	 << "12v_aux_curr" << ","
@@ -62,20 +62,29 @@ namespace xdp {
 	 << "vccint_temp"  << ","
 	 << "fan_rpm"
 	 << std::endl;
+  }
+
+  void PowerProfilingWriter::write(bool /*openNewFile*/)
+  {
+    if (!headerWritten)
+    {
+      writeHeader() ;
+      headerWritten = true ;
+    }
 
-    // Write all of the data elements
-    std::vector<VPDynamicDatabase::CounterSample> samples = 
-      (db->getDynamicInfo()).getPowerSamples(deviceIndex) ;
+    // Write the data elements added since the last write
+    (db->getDynamicInfo()).takePowerSamples(deviceIndex, samples) ;
 
-    for (auto sample : samples)
+    for (auto& sample : samples)
     {
       fout << sample.first << "," ; // Timestamp
       for (auto value : sample.second)
       {
 	fout << value << "," ;
       }
-      fout << std::endl ;
+      fout << "\n" ;
     }
+    fout.flush() ;
   }
 
 } // end namespace xdp
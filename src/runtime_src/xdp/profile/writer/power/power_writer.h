@@ -18,8 +18,10 @@
 #define POWER_WRITER_DOT_H
 
 #include <string>
+#include <vector>
 
 #include "xdp/profile/writer/vp_base/vp_writer.h"
+#include "xdp/profile/database/dynamic_event_database.h"
 
 namespace xdp {
 
@@ -28,6 +30,13 @@ namespace xdp {
   private:
     std::string deviceName ;
     uint64_t deviceIndex ;
+
+    // Samples are appended to the file as they are taken from the
+    //  database, the header is written once
+    bool headerWritten ;
+    std::vector<VPDynamicDatabase::CounterSample> samples ;
+
+    void writeHeader() ;
   public:
     PowerProfilingWriter(const char* filename, const char* d, uint64_t index) ;
     ~PowerProfilingWriter() ;
@@ -671,6 +671,66 @@ void FormatString::dbgDump(std::ostream& str) const
 
 /////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Size of the buffer a single conversion is printed into
+const int printBufLen = 1024;
+
+// Build the host printf format string for a conversion specifier
+void buildFormat(const ConversionSpec& conversion, char* formatStr)
+{
+  strcpy(formatStr, "%");
+  if (conversion.m_leftJustify)
+    strcat(formatStr, "-");
+  if (conversion.m_signPlus)
+    strcat(formatStr, "+");
+  if (conversion.m_prefixSpace)
+    strcat(formatStr, " ");
+  if (conversion.m_alternative)
+    strcat(formatStr, "#");
+  if (conversion.m_padZero)
+    strcat(formatStr, "0");
+  if (conversion.m_fieldWidth) {
+    char *buf = formatStr + strlen(formatStr);
+    sprintf(buf, "%d", conversion.m_fieldWidthValue);
+  }
+  if (conversion.m_precision) {
+    char *buf = formatStr + strlen(formatStr);
+    sprintf(buf, ".%d", conversion.m_precisionValue);
+  }
+  switch ( conversion.m_lengthModifier ) {
+    case ConversionSpec::CS_CHAR: {
+      strcat(formatStr, "hh");
+      break;
+    }
+    case ConversionSpec::CS_SHORT: {
+      strcat(formatStr, "h");
+      break;
+    }
+    case ConversionSpec::CS_INT_FLOAT: {
+      // TODO: Vec Only...
+      //strcat(formatStr, "hl");
+      break;
+    }
+    case ConversionSpec::CS_LONG: {
+      // HACK: LONG only supported for non vectors now...
+      if ( conversion.m_vectorSize == 1 ) {
+        strcat(formatStr, "l");
+      }
+      break;
+    }
+    default:
+      break;
+  }
+
+  strcat(formatStr, " ");
+  formatStr[strlen(formatStr)-1] = conversion.m_specifier;
+}
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+
 BufferPrintf::BufferPrintf()
   : m_currentOffset(0)
 {
@@ -717,40 +777,34 @@ void BufferPrintf::setBuffer(const MemBuffer& buf)
 void BufferPrintf::setStringTable(const StringTable& table)
 {
   m_stringTable = table;
+  m_formats.clear();
 }
 
 void BufferPrintf::print(std::ostream& os)
 {
-  moveToFirstRecord();
-  while ( hasNextRecord() ) {
-    std::string formatStr = getFormat();
-    FormatString format(formatStr);
-    if ( format.isValid() ) {
-      std::vector<XCL::Printf::ConversionSpec> conversionVec;
-      format.getSpecifiers(conversionVec);
-      std::vector<PrintfArg> argVec;
-      int argOffset = getFormatByteCount();
-      for ( auto conversion : conversionVec ) {
-        PrintfArg arg = buildArg(m_currentOffset + argOffset, conversion);
-        argVec.push_back(arg);
-        argOffset += getElementByteCount(conversion) * conversion.m_vectorSize;
-        // HACK: Special handling for vec3 packed strangely from compiler
-        //    float3 += 32 bits
-        //    others += 64 bits
-        if ( conversion.isVector() && conversion.m_vectorSize == 3) {
-          if ( conversion.isFloatClass() ) {
-            argOffset += 4;
-          }
-          else {
-            argOffset += 8;
-          }
+  // Output of all records is collected and written to the stream in
+  // large chunks rather than once per record
+  const size_t flushSize = 64 * 1024;
+  std::string out;
+  try {
+    moveToFirstRecord();
+    while ( hasNextRecord() ) {
+      const CompiledFormat& format = getCompiledFormat();
+      if ( format.valid ) {
+        formatRecord(format, out, os);
+        if ( out.size() >= flushSize ) {
+          os << out;
+          out.clear();
         }
       }
-      std::string result = string_printf(formatStr, argVec);
-      os << result;
+      nextRecord();
     }
-    nextRecord();
   }
+  catch (...) {
+    os << out;
+    throw;
+  }
+  os << out;
 }
 
 void BufferPrintf::dbgDump(std::ostream& os) const
@@ -878,33 +932,100 @@ void BufferPrintf::nextRecord()
     throwError("nextRecord - No next record");
   }
 
-  std::string formatStr = getFormat();
-  FormatString format(formatStr);
-  if ( !format.isValid() ) {
+  const CompiledFormat& format = getCompiledFormat();
+  if ( !format.valid ) {
     std::string msg = "nextRecord - Invalid format: ";
-    msg += formatStr;
+    msg += format.format;
     throwError(msg);
   }
-  std::vector<ConversionSpec> conversionVec;
-  format.getSpecifiers(conversionVec);
-  // skip format ID
-  m_currentOffset += getFormatByteCount();
-  // Skip all arguments
-  for (auto conversion : conversionVec) {
-    m_currentOffset += getElementByteCount(conversion) * conversion.m_vectorSize;
-    // HACK: Special handling for vec3 packed strangely from compiler
-    //    float3 += 32 bits
-    //    others += 64 bits
-    if ( conversion.isVector() && conversion.m_vectorSize == 3) {
-      if ( conversion.isFloatClass() ) {
-        m_currentOffset += 4;
+  // Skip format ID and all arguments
+  m_currentOffset += format.recordBytes;
+  m_currentOffset = nextRecordOffset(m_currentOffset);
+}
+
+const BufferPrintf::CompiledFormat& BufferPrintf::getCompiledFormat()
+{
+  uint32_t id = getFormatID();
+  auto found = m_formats.find(id);
+  if ( found != m_formats.end() ) {
+    return found->second;
+  }
+
+  CompiledFormat compiled;
+  lookup(id, compiled.format);
+  FormatString format(compiled.format);
+  compiled.valid = format.isValid();
+  compiled.recordBytes = getFormatByteCount();
+  if ( compiled.valid ) {
+    std::vector<ConversionSpec> conversionVec;
+    format.getSpecifiers(conversionVec);
+    format.getSplitFormatString(compiled.split);
+    for ( auto& conversion : conversionVec ) {
+      CompiledConversion cc;
+      cc.spec = conversion;
+      buildFormat(conversion, cc.format);
+      cc.elementBytes = getElementByteCount(conversion);
+      cc.argBytes = cc.elementBytes * conversion.m_vectorSize;
+      // HACK: Special handling for vec3 packed strangely from compiler
+      //    float3 += 32 bits
+      //    others += 64 bits
+      if ( conversion.isVector() && conversion.m_vectorSize == 3) {
+        if ( conversion.isFloatClass() ) {
+          cc.argBytes += 4;
+        }
+        else {
+          cc.argBytes += 8;
+        }
+      }
+      compiled.recordBytes += cc.argBytes;
+      compiled.conversions.push_back(cc);
+    }
+  }
+  return m_formats.emplace(id, std::move(compiled)).first->second;
+}
+
+void BufferPrintf::formatRecord(const CompiledFormat& format, std::string& out, std::ostream& os) const
+{
+  char printBuf[printBufLen];
+  int bufIdx = m_currentOffset + getFormatByteCount();
+  out += format.split[0];
+  for ( size_t idx = 0; idx < format.conversions.size(); ++idx ) {
+    const CompiledConversion& cc = format.conversions[idx];
+    const ConversionSpec& conversion = cc.spec;
+    for ( int i = 0; i < conversion.m_vectorSize; ++i ) {
+      int elementIdx = bufIdx + i*cc.elementBytes;
+      if ( i > 0 ) {
+        out += ",";
+      }
+      if ( conversion.isIntClass() ) {
+        uint64_t val = extractField(elementIdx, cc.elementBytes);
+        snprintf(printBuf, printBufLen, cc.format, val);
+      }
+      else if ( conversion.isFloatClass() ) {
+        // Host byte order, as written by the kernel
+        if ( conversion.isVector() ) {
+          float val = 0;
+          std::memcpy(&val, &m_buf[elementIdx], sizeof(val));
+          snprintf(printBuf, printBufLen, cc.format, val);
+        }
+        else {
+          double val = 0;
+          std::memcpy(&val, &m_buf[elementIdx], sizeof(val));
+          snprintf(printBuf, printBufLen, cc.format, val);
+        }
       }
       else {
-        m_currentOffset += 8;
+        // Temporary error - remove when %s works
+        os << out;
+        out.clear();
+        std::cout << std::endl << "ERROR: Printf conversion specifier '%s' is not allowed" << std::endl;
+        snprintf(printBuf, printBufLen, cc.format, "");
       }
+      out += printBuf;
     }
+    out += format.split[idx+1];
+    bufIdx += cc.argBytes;
   }
-  m_currentOffset = nextRecordOffset(m_currentOffset);
 }
 
 std::string BufferPrintf::getFormat() const
@@ -944,119 +1065,15 @@ uint64_t BufferPrintf::extractField(int idx, int byteCount) const
   return val;
 }
 
-PrintfArg BufferPrintf::buildArg(int bufIdx, ConversionSpec& conversion) const
-{
-  int elementBytes = getElementByteCount(conversion);
-  if ( conversion.isIntClass() ) {
-    if ( conversion.isVector() ) {
-      std::vector<uint64_t> vec;
-      for ( int i = 0; i < conversion.m_vectorSize; ++i ) {
-        uint64_t val = extractField(bufIdx + i*elementBytes, elementBytes);
-        vec.push_back(val);
-      }
-      PrintfArg arg(vec);
-      return arg;
-    }
-    else {
-      uint64_t val = extractField(bufIdx, elementBytes);
-      PrintfArg arg(val);
-      return arg;
-    }
-  }
-  else if ( conversion.isFloatClass() ) {
-    if ( conversion.isVector() ) {
-      std::vector<float> vec;
-      for ( int i = 0; i < conversion.m_vectorSize; ++i ) {
-        float val = 0;
-        uint8_t *ptr = (uint8_t*)&val;
-        for ( int ii = elementBytes-1; ii >= 0; --ii ) {
-          ptr[ii] = m_buf[bufIdx+ii+(i*elementBytes)];
-        }
-        vec.push_back(val);
-      }
-      PrintfArg arg(vec);
-      return arg;
-    }
-    else {
-      double val = 0;
-      uint8_t *ptr = (uint8_t*)&val;
-      for ( int i = elementBytes-1; i >= 0; --i ) {
-        ptr[i] = m_buf[bufIdx+i];
-      }
-      PrintfArg arg(val);
-      return arg;
-    }
-  }
-  else if ( conversion.isStringClass() ) {
-    /*uint64_t idx = */ (void)extractField(bufIdx, elementBytes);
-    std::string str = "";
-    // Temporary error - remove when %s works
-    std::cout << std::endl << "ERROR: Printf conversion specifier '%s' is not allowed" << std::endl;
-//    lookup(idx, str);
-    PrintfArg arg(str);
-    return arg;
-  }
-  // TODO: probably best to throw an exception here...
-  PrintfArg arg(0);
-  return arg;
-}
-
-
 /////////////////////////////////////////////////////////////////////////
 
 std::string convertArg(PrintfArg& arg, ConversionSpec& conversion)
 {
   std::string retval = "";
   char formatStr[32];
-  strcpy(formatStr, "%");
-  if (conversion.m_leftJustify)
-    strcat(formatStr, "-");
-  if (conversion.m_signPlus)
-    strcat(formatStr, "+");
-  if (conversion.m_prefixSpace)
-    strcat(formatStr, " ");
-  if (conversion.m_alternative)
-    strcat(formatStr, "#");
-  if (conversion.m_padZero)
-    strcat(formatStr, "0");
-  if (conversion.m_fieldWidth) {
-    char *buf = formatStr + strlen(formatStr);
-    sprintf(buf, "%d", conversion.m_fieldWidthValue);
-  }
-  if (conversion.m_precision) {
-    char *buf = formatStr + strlen(formatStr);
-    sprintf(buf, ".%d", conversion.m_precisionValue);
-  }
-  switch ( conversion.m_lengthModifier ) {
-    case ConversionSpec::CS_CHAR: {
-      strcat(formatStr, "hh");
-      break;
-    }
-    case ConversionSpec::CS_SHORT: {
-      strcat(formatStr, "h");
-      break;
-    }
-    case ConversionSpec::CS_INT_FLOAT: {
-      // TODO: Vec Only...
-      //strcat(formatStr, "hl");
-      break;
-    }
-    case ConversionSpec::CS_LONG: {
-      // HACK: LONG only supported for non vectors now...
-      if ( conversion.m_vectorSize == 1 ) {
-        strcat(formatStr, "l");
-      }
-      break;
-    }
-    default:
-      break;
-  }
-
-  strcat(formatStr, " ");
-  formatStr[strlen(formatStr)-1] = conversion.m_specifier;
-  // TODO: later make this dynamically size... for now 1024 should be sufficient
-  int bufLen = 1024;
-  char *printBuf = new char[bufLen];
+  buildFormat(conversion, formatStr);
+  int bufLen = printBufLen;
+  char printBuf[printBufLen];
   switch ( arg.m_typeInfo ) {
     case PrintfArg::AT_PTR: {
       snprintf(printBuf, bufLen, formatStr, arg.ptr);
@@ -1111,7 +1128,6 @@ std::string convertArg(PrintfArg& arg, ConversionSpec& conversion)
       break;
     }
   }
-  delete[] printBuf;
   return retval;
 }
 
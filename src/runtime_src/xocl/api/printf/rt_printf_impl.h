@@ -295,9 +295,30 @@ private:
     // Extract a value from buffer
     uint64_t extractField(int idx, int byteCount) const;
 
-    // Build up a printf argument given the conversion specifier
-    // and memory buffer and string table
-    PrintfArg buildArg(int bufIdx, ConversionSpec& conversion) const;
+    // A format string parsed once per format ID. Each conversion keeps
+    // the host printf format string built from its specifier and the
+    // number of bytes its argument takes in the buffer, so records are
+    // decoded straight from the buffer without reparsing the format.
+    struct CompiledConversion {
+      ConversionSpec spec;
+      char format[32];
+      int elementBytes;
+      int argBytes;
+    };
+
+    struct CompiledFormat {
+      std::string format;
+      bool valid;
+      std::vector<std::string> split;
+      std::vector<CompiledConversion> conversions;
+      int recordBytes; // format ID and all arguments
+    };
+
+    // Returns the compiled format for the current record
+    const CompiledFormat& getCompiledFormat();
+
+    // Append the text of the current record to out
+    void formatRecord(const CompiledFormat& format, std::string& out, std::ostream& os) const;
     
     // Convert escape sequences \n, \r, \t, \ to text representation
     // Newline replaced by string: "\n"
@@ -310,6 +331,7 @@ private:
     int m_currentOffset;
     MemBuffer m_buf;
     StringTable m_stringTable;
+    std::map<uint32_t, CompiledFormat> m_formats;
 };
 
 
@@ -0,0 +1,300 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Kernel printf buffer decode benchmark
+//
+// Fills a synthetic printf buffer, one 2KB segment per work item, with
+// records of scalar and vector conversions and prints it with
+// BufferPrintf.  The same records are also printed by parsing the
+// format of every record and converting each argument through
+// PrintfArg and string_printf, which is how BufferPrintf decoded
+// records before formats were compiled once per format ID.  Both
+// outputs must be identical.
+//
+// % printf_bench [--work-items <n>] [--iterations <n>]
+
+#include "../rt_printf_impl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace XCL::Printf;
+
+const BufferPrintf::StringTable formats = {
+  {1, "wi %d: x=%5d y=%u mask=0x%08x\n"},
+  {2, "acc %8.3f scale %e ratio %g\n"},
+  {3, "ids %v4hld lanes %v2hlx\n"},
+  {4, "pos %v3hlf dir %v3ld %%\n"},
+  {5, "w %v4hlf\n"}
+};
+
+struct record
+{
+  uint32_t id;
+  size_t offset;
+};
+
+void
+put_int(BufferPrintf::MemBuffer& buf, size_t& offset, uint64_t val)
+{
+  for (int i = 0; i < 8; ++i)
+    buf[offset++] = static_cast<uint8_t>(val >> (8 * i));
+}
+
+template <typename T>
+void
+put_float(BufferPrintf::MemBuffer& buf, size_t& offset, T val)
+{
+  std::memcpy(&buf[offset], &val, sizeof(val));
+  offset += sizeof(val);
+}
+
+size_t
+record_bytes(uint32_t id)
+{
+  FormatString format(formats.at(id));
+  std::vector<ConversionSpec> specs;
+  format.getSpecifiers(specs);
+  size_t bytes = BufferPrintf::getFormatByteCount();
+  for (auto& spec : specs) {
+    bytes += BufferPrintf::getElementByteCount(spec) * spec.m_vectorSize;
+    if (spec.isVector() && spec.m_vectorSize == 3)
+      bytes += spec.isFloatClass() ? 4 : 8;
+  }
+  return bytes;
+}
+
+// Fill each work item segment with records until the next one does
+// not fit; the rest of the segment stays 0xFF
+BufferPrintf::MemBuffer
+make_buffer(size_t work_items, std::vector<record>& records)
+{
+  size_t segment = getWorkItemPrintfBufferSize();
+  BufferPrintf::MemBuffer buf(work_items * segment, 0xFF);
+
+  for (size_t wi = 0; wi < work_items; ++wi) {
+    size_t offset = wi * segment;
+    size_t end = offset + segment;
+    for (uint32_t n = 0; ; ++n) {
+      uint32_t id = 1 + (wi + n) % formats.size();
+      if (offset + record_bytes(id) + BufferPrintf::getFormatByteCount() > end)
+        break;
+
+      records.push_back({id, offset});
+      put_int(buf, offset, id);
+      switch (id) {
+      case 1:
+        put_int(buf, offset, wi);
+        put_int(buf, offset, static_cast<uint64_t>(-static_cast<int64_t>(n)));
+        put_int(buf, offset, wi * n);
+        put_int(buf, offset, 0xdead0000 + n);
+        break;
+      case 2:
+        put_float(buf, offset, wi * 0.125 + n);
+        put_float(buf, offset, 1.0 / (n + 1));
+        put_float(buf, offset, static_cast<double>(wi) / (n + 3));
+        break;
+      case 3:
+        for (int i = 0; i < 4; ++i)
+          put_int(buf, offset, wi * 4 + i);
+        for (int i = 0; i < 2; ++i)
+          put_int(buf, offset, 0xf0 + n + i);
+        break;
+      case 4:
+        for (int i = 0; i < 3; ++i)
+          put_float(buf, offset, static_cast<float>(wi + i * 0.5f));
+        offset += 4;
+        for (int i = 0; i < 3; ++i)
+          put_int(buf, offset, static_cast<uint64_t>(i - 1));
+        offset += 8;
+        break;
+      case 5:
+        for (int i = 0; i < 4; ++i)
+          put_float(buf, offset, static_cast<float>(n) / (i + 1));
+        break;
+      }
+    }
+  }
+  return buf;
+}
+
+uint64_t
+extract(const BufferPrintf::MemBuffer& buf, size_t offset)
+{
+  uint64_t val = 0;
+  for (int i = 7; i >= 0; --i)
+    val = (val << 8) | buf[offset + i];
+  return val;
+}
+
+// Parse the format and build a PrintfArg for every argument of every
+// record
+void
+print_reparse(const BufferPrintf::MemBuffer& buf, const std::vector<record>& records, std::ostream& os)
+{
+  for (auto& rec : records) {
+    const std::string& str = formats.at(rec.id);
+    FormatString format(str);
+    std::vector<ConversionSpec> specs;
+    format.getSpecifiers(specs);
+
+    std::vector<PrintfArg> args;
+    size_t offset = rec.offset + BufferPrintf::getFormatByteCount();
+    for (auto& spec : specs) {
+      int bytes = BufferPrintf::getElementByteCount(spec);
+      if (spec.isIntClass() && spec.isVector()) {
+        std::vector<uint64_t> vec;
+        for (int i = 0; i < spec.m_vectorSize; ++i)
+          vec.push_back(extract(buf, offset + i * bytes));
+        args.emplace_back(vec);
+      }
+      else if (spec.isIntClass()) {
+        args.emplace_back(extract(buf, offset));
+      }
+      else if (spec.isVector()) {
+        std::vector<float> vec(spec.m_vectorSize);
+        std::memcpy(vec.data(), &buf[offset], vec.size() * sizeof(float));
+        args.emplace_back(vec);
+      }
+      else {
+        double val = 0;
+        std::memcpy(&val, &buf[offset], sizeof(val));
+        args.emplace_back(val);
+      }
+      offset += bytes * spec.m_vectorSize;
+      if (spec.isVector() && spec.m_vectorSize == 3)
+        offset += spec.isFloatClass() ? 4 : 8;
+    }
+    os << string_printf(str, args);
+  }
+}
+
+template <typename Function>
+double
+time_ms(unsigned int iterations, Function&& fcn)
+{
+  auto begin = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    fcn();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+  return elapsed.count() / iterations;
+}
+
+void
+usage()
+{
+  std::cout << "usage: printf_bench [options]\n\n"
+            << "  [--work-items <n>]  Number of 2KB work item segments (default 4096)\n"
+            << "  [--iterations <n>]  Timed iterations of each decoder (default 5)\n"
+            << "  [-h]\n";
+}
+
+int
+run(int argc, char** argv)
+{
+  size_t work_items = 4096;
+  unsigned int iterations = 5;
+
+  std::vector<std::string> args(argv+1,argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "--work-items")
+      work_items = std::stoul(arg);
+    else if (cur == "--iterations")
+      iterations = std::stoul(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (!work_items || !iterations)
+    throw std::runtime_error("--work-items and --iterations must be positive");
+
+  std::vector<record> records;
+  auto buf = make_buffer(work_items, records);
+
+  std::ostringstream expected;
+  print_reparse(buf, records, expected);
+
+  BufferPrintf printer(buf, formats);
+  std::ostringstream actual;
+  printer.print(actual);
+
+  auto exp = expected.str();
+  auto act = actual.str();
+  if (act != exp) {
+    auto pos = std::mismatch(exp.begin(), exp.begin() + std::min(exp.size(), act.size()), act.begin()).first - exp.begin();
+    std::cout << "FAILED: output differs at offset " << pos << "\n"
+              << "expected: " << exp.substr(pos, 64) << "\n"
+              << "actual:   " << act.substr(pos, 64) << "\n";
+    return 1;
+  }
+
+  auto reparse = time_ms(iterations, [&] {
+    std::ostringstream os;
+    print_reparse(buf, records, os);
+  });
+
+  auto compiled = time_ms(iterations, [&] {
+    BufferPrintf printer(buf, formats);
+    std::ostringstream os;
+    printer.print(os);
+  });
+
+  std::cout << "work items: " << work_items
+            << "  records: " << records.size()
+            << "  output bytes: " << act.size() << "\n"
+            << "reparse per record:  " << reparse << " ms\n"
+            << "compiled formats:    " << compiled << " ms\n"
+            << "speedup:             " << reparse / compiled << "x\n"
+            << "PASSED\n";
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
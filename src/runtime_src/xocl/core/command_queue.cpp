@@ -80,25 +80,32 @@ queue(event* ev)
   XOCL_DEBUG(std::cout,"queue(",m_uid,") queues event(",ev->get_uid(),")\n");
 
   std::lock_guard<std::mutex> lk(m_events_mutex);
-  if (!ooo && m_last_queued_event.get()) {
-    m_last_queued_event->chain(ev);
-
-    auto tmp_lval = static_cast<cl_event>(m_last_queued_event.get());
-    xocl::profile::log_dependencies(ev, 1, &tmp_lval);
+  if (!ooo) {
+    if (m_last_queued_event.get()) {
+      m_last_queued_event->chain(ev);
+
+      auto tmp_lval = static_cast<cl_event>(m_last_queued_event.get());
+      xocl::profile::log_dependencies(ev, 1, &tmp_lval);
+    }
+    m_last_queued_event = ev;
   }
 
+  // In an out of order queue every event depends on the last barrier.
+  // Each barrier is itself chained to the barrier before it, so it is
+  // sufficient to chain only to the last barrier that is still queued.
   if (ooo) {
-    for (auto b: m_barriers)
-      b->chain(ev);
+    if (m_last_barrier) {
+      m_last_barrier->chain(ev);
 
-    xocl::profile::log_dependencies(ev, m_barriers.size(), reinterpret_cast<cl_event*>(m_barriers.data()) );
+      auto tmp_lval = static_cast<cl_event>(m_last_barrier);
+      xocl::profile::log_dependencies(ev, 1, &tmp_lval);
+    }
 
     if (ev->get_command_type()==CL_COMMAND_BARRIER)
-      m_barriers.push_back(ev);
+      m_last_barrier = ev;
   }
 
   m_events.insert(ev);
-  m_last_queued_event = ev;
   ev->retain();
 
   return true;
@@ -144,12 +151,8 @@ remove(event* ev)
   m_events.erase(it);
   if (m_last_queued_event==ev)
     m_last_queued_event = nullptr;
-
-  if ((ev->get_command_type()==CL_COMMAND_BARRIER) && (m_props.test(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)))  {
-    auto bit = std::find(m_barriers.begin(),m_barriers.end(),ev);
-    assert(bit!=m_barriers.end());
-    m_barriers.erase(bit);
-  }
+  if (m_last_barrier==ev)
+    m_last_barrier = nullptr;
 
   ev->release();
   if (m_events.empty())
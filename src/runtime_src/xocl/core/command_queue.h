@@ -204,7 +204,7 @@ private:
   mutable std::mutex m_events_mutex;
   mutable std::condition_variable m_has_events;
   event_queue_type m_events;
-  std::vector<event*> m_barriers;
+  event* m_last_barrier = nullptr;
   ptr<event> m_last_queued_event;
   property_type m_props;
 };
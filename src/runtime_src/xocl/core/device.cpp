@@ -906,8 +906,7 @@ copy_buffer(memory* src_buffer, memory* dst_buffer, size_t src_offset, size_t ds
   // if m2m present then use xclCopyBO
   try {
     auto core_device = m_xdevice->get_core_device();
-    auto m2m = xrt_core::device_query<xrt_core::query::m2m>(core_device);
-    if (xrt_core::query::m2m::to_bool(m2m)) {
+    if (core_device->get_capabilities().m2m) {
       auto cb = [this](memory* sbuf, memory* dbuf, size_t soff, size_t doff, size_t sz, const cmd_type& c) {
         c->start();
         auto sboh = sbuf->get_buffer_object(this);
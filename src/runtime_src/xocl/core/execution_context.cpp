@@ -23,6 +23,7 @@
 
 #include "core/common/xclbin_parser.h"
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <bitset>
@@ -161,8 +162,12 @@ execution_context(device* device
 
   // Bind the kernel arguments to this context so that the same kernel
   // object can be reused while this context is executing
-  for (auto& arg : m_kernel->get_argument_range())
+  m_arg_generation = m_kernel->get_argument_generation();
+  for (auto& arg : m_kernel->get_argument_range()) {
     m_kernel_args.push_back(arg->clone());
+    if (arg->is_printf())
+      m_printf_buffer = m_kernel_args.back()->get_memory_object();
+  }
 
   // Compute units to use
   add_compute_units(device);
@@ -209,6 +214,29 @@ cu_control_type() const
   return m_cus.front()->get_control_type();
 }
 
+std::shared_ptr<execution_context::start_kernel>
+execution_context::
+get_command(xrt::device* xdevice, ert_cmd_opcode opcode)
+{
+  // A command is referenced by the scheduler until its completion
+  // notification has returned, so the command whose completion
+  // started this work-group is reused at the earliest by the next
+  for (auto& cmd : m_commands) {
+    if (cmd.use_count() == 1) {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      cmd->reset(opcode);
+      return cmd;
+    }
+  }
+
+  // Retain up to twice the number of commands in flight, see execute()
+  auto cmd = std::make_shared<start_kernel>(xdevice,this,opcode);
+  auto limit = m_dataflow ? 40*m_cus.size() : 4*m_cus.size();
+  if (m_commands.size() < limit)
+    m_commands.push_back(cmd);
+  return cmd;
+}
+
 bool
 execution_context::
 write(const command_type& cmd)
@@ -305,61 +333,29 @@ update_work()
 
 void
 execution_context::
-start()
+fill_arguments(packet_type& regmap, size_t offset, ert_cmd_opcode opcode, uint32_t ctrl)
 {
-  XOCL_DEBUGF("execution_context(%d) starting workgroup(%d,%d,%d)\n"
-              ,get_uid(),m_cu_group_id[0],m_cu_group_id[1],m_cu_group_id[2]);
-
-  // On first work load, transition event to CL_RUNNING
-  if ( (m_cu_group_id[0]==0) && (m_cu_group_id[1]==0) && (m_cu_group_id[2]==0))
-    m_event->set_status(CL_RUNNING);
-
   auto xdevice = m_device->get_xrt_device();
 
-  // Construct command packet and send to hardware
-  auto ctrl = cu_control_type();
-  auto opcode = (ctrl == ACCEL_ADAPTER) ? ERT_EXEC_WRITE : ERT_START_KERNEL;
-  auto cmd = std::make_shared<start_kernel>(xdevice,this,opcode);
-  ++m_active;
-  auto& packet = cmd->get_packet();
-
-  // Encode CUs in cu bitmasks with bits in position according to the
-  // CUs that can be used
-  encode_compute_units(packet);
-
-  // Create the cu register map
-  auto offset = packet.size();  // start of regmap
-  auto& regmap = packet;
-
   // Ensure that S_AXI_CONTROL is created even when kernel
   // has no arguments.
-  packet[offset]   = 0;  // control signals
-  packet[offset+1] = 0;  // gier
-  packet[offset+2] = 0;  // ier
-  packet[offset+3] = 0;  // isr
+  regmap[offset]   = 0;  // control signals
+  regmap[offset+1] = 0;  // gier
+  regmap[offset+2] = 0;  // ier
+  regmap[offset+3] = 0;  // isr
 
   if (opcode == ERT_EXEC_WRITE) {
     // scheduler relies on exec_write addr,value pair
     // starting at offset+6 (4 ctrl + 2 ctx)
     // this is a mess, need separate exec_write packet.
-    packet[offset+4] = 0; // ctx-in
-    packet[offset+5] = 0; // ctx-out
-  }
-
-  size3 num_workgroups {0,0,0};
-  for (auto d : {0,1,2}) {
-    if (m_lsize[d]) // actually always true
-      num_workgroups[d] = m_gsize[d]/m_lsize[d];
+    regmap[offset+4] = 0; // ctx-in
+    regmap[offset+5] = 0; // ctx-out
   }
 
   // Push kernel args
-  xocl::memory* printf_buffer = nullptr;
   for (auto& arg : m_kernel_args) {
-    if (arg->is_printf()) {
-      printf_buffer = arg->get_memory_object();
-      assert(printf_buffer);
+    if (arg->is_printf())
       continue;
-    }
 
     auto address_space = arg->get_address_space();
     if (address_space == kernel::argument::addr_space_type::SPIR_ADDRSPACE_PRIVATE)
@@ -394,53 +390,151 @@ start()
     assert(arg->get_arginfo_range().size()==1);
     fill_regmap(regmap,offset,opcode,ctrl,&physaddr,arg->get_size(),arg->get_arginfo_range());
   }
+}
+
+uint64_t
+execution_context::
+get_printf_buffer_addr()
+{
+  if (!m_printf_buffer)
+    return 0;
+
+  if (!m_printf_buffer_addr) {
+    auto boh = m_printf_buffer->get_buffer_object_or_error(m_device);
+    m_printf_buffer_addr = static_cast<uint64_t>(m_device->get_xrt_device()->getDeviceAddr(boh));
+  }
+
+  // This computes the offset that gets added to a physical printf buffer
+  // address for a given workgroup. Necessary so we have a different
+  // segment to hold each workgroup in the overall buffer.
+  size_t lwsx = m_lsize[0];
+  size_t lwsy = m_lsize[1];
+  size_t lwsz = m_lsize[2];
+  size_t gwsx = m_gsize[0];
+  size_t gwsy = m_gsize[1];
+  size_t local_buffer_size = lwsx * lwsy * lwsz * 2048 /*XCL::Printf::getWorkItemPrintfBufferSize()*/;
+  size_t group_x_size = gwsx / lwsx;
+  size_t group_y_size = gwsy / lwsy;
+  size_t group_id = m_cu_group_id[0] +
+                    group_x_size * m_cu_group_id[1] +
+                    group_y_size * group_x_size * m_cu_group_id[2];
+  auto printf_buffer_offset = group_id * local_buffer_size;
+  return m_printf_buffer_addr + printf_buffer_offset;
+}
+
+void
+execution_context::
+fill_rtinfo_argument(packet_type& regmap, size_t offset, ert_cmd_opcode opcode, uint32_t ctrl,
+                     const kernel::argument* arg)
+{
+  auto nm = arg->get_name();
+  XOCL_DEBUGF("execution_context(%d) sets rtinfo(%s)\n",get_uid(),nm.c_str());
+  if (nm=="work_dim")
+    fill_regmap(regmap,offset,opcode,ctrl,&m_dim,sizeof(cl_uint),arg->get_arginfo_range());
+  else if (nm=="global_offset")
+    fill_regmap(regmap,offset,opcode,ctrl,m_goffset.data(),3*sizeof(size_t),arg->get_arginfo_range());
+  else if (nm=="global_size")
+    fill_regmap(regmap,offset,opcode,ctrl,m_gsize.data(),3*sizeof(size_t),arg->get_arginfo_range());
+  else if (nm=="local_size")
+    fill_regmap(regmap,offset,opcode,ctrl,m_lsize.data(),3*sizeof(size_t),arg->get_arginfo_range());
+  else if (nm=="num_groups") {
+    size3 num_workgroups {0,0,0};
+    for (auto d : {0,1,2}) {
+      if (m_lsize[d]) // actually always true
+        num_workgroups[d] = m_gsize[d]/m_lsize[d];
+    }
+    fill_regmap(regmap,offset,opcode,ctrl,num_workgroups.data(),3*sizeof(size_t),arg->get_arginfo_range());
+  }
+  else if (nm=="global_id")
+    fill_regmap(regmap,offset,opcode,ctrl,m_cu_global_id.data(),3*sizeof(size_t),arg->get_arginfo_range());
+  else if (nm=="local_id") {
+    size3 local_id {0,0,0};
+    fill_regmap(regmap,offset,opcode,ctrl,local_id.data(),3*sizeof(size_t),arg->get_arginfo_range());
+  }
+  else if (nm=="group_id")
+    fill_regmap(regmap,offset,opcode,ctrl,m_cu_group_id.data(),3*sizeof(size_t),arg->get_arginfo_range());
+  else if (nm=="printf_buffer") {
+    auto printf_buffer_addr = get_printf_buffer_addr();
+    fill_regmap(regmap,offset,opcode,ctrl,&printf_buffer_addr,sizeof(printf_buffer_addr),arg->get_arginfo_range());
+  }
+}
 
-  // Set runtime arguments as required
-  size3 local_id {0,0,0};
-  uint64_t printf_buffer_addr = 0;
-  if ( printf_buffer ) {
-    // This computes the offset that gets added to a physical printf buffer
-    // address for a given workgroup. Necessary so we have a different
-    // segment to hold each workgroup in the overall buffer.
-    size_t lwsx = m_lsize[0];
-    size_t lwsy = m_lsize[1];
-    size_t lwsz = m_lsize[2];
-    size_t gwsx = m_gsize[0];
-    size_t gwsy = m_gsize[1];
-    size_t local_buffer_size = lwsx * lwsy * lwsz * 2048 /*XCL::Printf::getWorkItemPrintfBufferSize()*/;
-    size_t group_x_size = gwsx / lwsx;
-    size_t group_y_size = gwsy / lwsy;
-    size_t group_id = m_cu_group_id[0] +
-                      group_x_size * m_cu_group_id[1] +
-                      group_y_size * group_x_size * m_cu_group_id[2];
-    auto printf_buffer_offset = group_id * local_buffer_size;
-    auto boh = printf_buffer->get_buffer_object_or_error(m_device);
-    auto printf_buffer_base_addr = static_cast<uint64_t>(xdevice->getDeviceAddr(boh));
-    printf_buffer_addr = printf_buffer_base_addr + printf_buffer_offset;
+void
+execution_context::
+init_regmap(packet_type& regmap, size_t offset, uint32_t ctrl)
+{
+  // Argument values are the same for all launches of the kernel until
+  // an argument is set, reuse the image of a previous launch if any
+  if (auto image = m_kernel->get_regmap_image(m_device,m_arg_generation)) {
+    std::copy(image->begin(),image->end(),regmap.data()+offset);
+    regmap.resize(offset+image->size());
+  }
+  else {
+    fill_arguments(regmap,offset,ERT_START_KERNEL,ctrl);
+    auto begin = regmap.data()+offset;
+    auto end = regmap.data()+regmap.size();
+    m_kernel->set_regmap_image(m_device,m_arg_generation,
+                               std::make_shared<kernel::regmap_image_type>(begin,end));
   }
 
-  // Push runtime args
+  // Runtime args are fixed for the context except for work-group ids
   for (auto& arg : m_kernel->get_rtinfo_argument_range()) {
     auto nm = arg->get_name();
-    XOCL_DEBUGF("execution_context(%d) sets rtinfo(%s)\n",get_uid(),nm.c_str());
-    if (nm=="work_dim")
-      fill_regmap(regmap,offset,opcode,ctrl,&m_dim,sizeof(cl_uint),arg->get_arginfo_range());
-    else if (nm=="global_offset")
-      fill_regmap(regmap,offset,opcode,ctrl,m_goffset.data(),3*sizeof(size_t),arg->get_arginfo_range());
-    else if (nm=="global_size")
-      fill_regmap(regmap,offset,opcode,ctrl,m_gsize.data(),3*sizeof(size_t),arg->get_arginfo_range());
-    else if (nm=="local_size")
-      fill_regmap(regmap,offset,opcode,ctrl,m_lsize.data(),3*sizeof(size_t),arg->get_arginfo_range());
-    else if (nm=="num_groups")
-      fill_regmap(regmap,offset,opcode,ctrl,num_workgroups.data(),3*sizeof(size_t),arg->get_arginfo_range());
-    else if (nm=="global_id")
-      fill_regmap(regmap,offset,opcode,ctrl,m_cu_global_id.data(),3*sizeof(size_t),arg->get_arginfo_range());
-    else if (nm=="local_id")
-      fill_regmap(regmap,offset,opcode,ctrl,local_id.data(),3*sizeof(size_t),arg->get_arginfo_range());
-    else if (nm=="group_id")
-      fill_regmap(regmap,offset,opcode,ctrl,m_cu_group_id.data(),3*sizeof(size_t),arg->get_arginfo_range());
-    else if (nm=="printf_buffer")
-      fill_regmap(regmap,offset,opcode,ctrl,&printf_buffer_addr,sizeof(printf_buffer_addr),arg->get_arginfo_range());
+    if (nm=="global_id" || nm=="group_id" || nm=="printf_buffer")
+      m_wg_rtinfo_args.push_back(arg.get());
+    else
+      fill_rtinfo_argument(regmap,offset,ERT_START_KERNEL,ctrl,arg.get());
+  }
+
+  m_regmap.assign(regmap.data()+offset,regmap.data()+regmap.size());
+}
+
+void
+execution_context::
+start()
+{
+  XOCL_DEBUGF("execution_context(%d) starting workgroup(%d,%d,%d)\n"
+              ,get_uid(),m_cu_group_id[0],m_cu_group_id[1],m_cu_group_id[2]);
+
+  // On first work load, transition event to CL_RUNNING
+  if ( (m_cu_group_id[0]==0) && (m_cu_group_id[1]==0) && (m_cu_group_id[2]==0))
+    m_event->set_status(CL_RUNNING);
+
+  auto xdevice = m_device->get_xrt_device();
+
+  // Construct command packet and send to hardware
+  auto ctrl = cu_control_type();
+  auto opcode = (ctrl == ACCEL_ADAPTER) ? ERT_EXEC_WRITE : ERT_START_KERNEL;
+  auto cmd = get_command(xdevice,opcode);
+  ++m_active;
+  auto& packet = cmd->get_packet();
+
+  // Encode CUs in cu bitmasks with bits in position according to the
+  // CUs that can be used
+  encode_compute_units(packet);
+
+  // Create the cu register map
+  auto offset = packet.size();  // start of regmap
+  auto& regmap = packet;
+
+  if (opcode == ERT_START_KERNEL) {
+    // Register map is at fixed offsets, copy the prebuilt register
+    // map and patch the work-group dependent runtime args
+    if (m_regmap.empty())
+      init_regmap(regmap,offset,ctrl);
+    else {
+      std::copy(m_regmap.begin(),m_regmap.end(),regmap.data()+offset);
+      regmap.resize(offset+m_regmap.size());
+    }
+
+    for (auto arg : m_wg_rtinfo_args)
+      fill_rtinfo_argument(regmap,offset,opcode,ctrl,arg);
+  }
+  else {
+    // Exec write appends addr,value pairs in order of arguments
+    fill_arguments(regmap,offset,opcode,ctrl);
+    for (auto& arg : m_kernel->get_rtinfo_argument_range())
+      fill_rtinfo_argument(regmap,offset,opcode,ctrl,arg.get());
   }
 
   // send command to mbs
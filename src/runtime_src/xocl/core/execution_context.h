@@ -24,6 +24,7 @@
 #include "xrt/scheduler/command.h"
 #include <mutex>
 #include <array>
+#include <vector>
 #include <algorithm>
 #include <iostream>
 #include <cassert>
@@ -94,6 +95,25 @@ private:
 
   bool m_dataflow = false;
 
+  // Kernel argument generation when the arguments were bound
+  unsigned int m_arg_generation = 0;
+
+  // Register map of ERT_START_KERNEL commands with everything but
+  // work-group dependent runtime args filled in.  Built when the first
+  // work-group is started and copied into the command of each
+  // following work-group.
+  std::vector<word_type> m_regmap;
+
+  // Runtime args that must be filled in per work-group
+  std::vector<const kernel::argument*> m_wg_rtinfo_args;
+
+  // Printf buffer bound to this context and its device address
+  xocl::memory* m_printf_buffer = nullptr;
+  uint64_t m_printf_buffer_addr = 0;
+
+  // Commands reused by later work-groups, see get_command()
+  std::vector<std::shared_ptr<start_kernel>> m_commands;
+
   // The context maintains a list of kernel compute units represented
   // by xcl::cu.  These cus (their base addresses) are used in the command
   // that starts the mbs.
@@ -117,9 +137,46 @@ private:
   bool
   write(const command_type& cmd);
 
+  /**
+   * Get a command for next work-group
+   *
+   * Reuses a command of a completed work-group if possible, which
+   * saves allocating, mapping, and clearing an exec buffer for each
+   * work-group of a large NDRange.
+   */
+  std::shared_ptr<start_kernel>
+  get_command(xrt::device* xdevice, ert_cmd_opcode opcode);
+
   void
   encode_compute_units(packet_type& pkt);
 
+  /**
+   * Fill register map with control words, and argument values
+   *
+   * Indexed arguments and progvars, runtime args are not filled.
+   */
+  void
+  fill_arguments(packet_type& pkt, size_t offset, ert_cmd_opcode opcode, uint32_t ctrl);
+
+  /**
+   * Fill register map with value of one runtime arg
+   */
+  void
+  fill_rtinfo_argument(packet_type& pkt, size_t offset, ert_cmd_opcode opcode, uint32_t ctrl,
+                       const kernel::argument* arg);
+
+  /**
+   * Initialize m_regmap from the register map of the first work-group
+   */
+  void
+  init_regmap(packet_type& pkt, size_t offset, uint32_t ctrl);
+
+  /**
+   * Device address of printf buffer segment of current work-group
+   */
+  uint64_t
+  get_printf_buffer_addr();
+
   /**
    * Control type, IP_CONTROL per xclbin ip_layout
    */
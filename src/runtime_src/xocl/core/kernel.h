@@ -23,7 +23,11 @@
 #include "xocl/xclbin/xclbin.h"
 
 #include "xrt/util/td.h"
+#include <atomic>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include <iostream>
 
@@ -513,15 +517,70 @@ public:
   void
   set_argument(unsigned long idx, size_t sz, const void* arg)
   {
+    ++m_arg_generation;
     m_indexed_args.at(idx)->set(idx,sz,arg);
   }
 
   void
   set_svm_argument(unsigned long idx, size_t sz, const void* arg)
   {
+    ++m_arg_generation;
     m_indexed_args.at(idx)->set_svm(sz,arg);
   }
 
+  /**
+   * Generation of indexed argument values
+   *
+   * Incremented whenever an indexed argument is set.  The printf
+   * argument is not counted, it is not part of the regmap image.
+   */
+  unsigned int
+  get_argument_generation() const
+  {
+    return m_arg_generation;
+  }
+
+  using regmap_image_type = std::vector<uint32_t>;
+
+  /**
+   * Get cached register map image of argument values
+   *
+   * The image holds the CU register map words of the indexed and
+   * progvar arguments as bound by an execution context.  Buffer
+   * device addresses are stable for the lifetime of a buffer on a
+   * device, so the image is valid until an argument is set.
+   *
+   * @param dev
+   *  Device the image was built for
+   * @param generation
+   *  Argument generation of the execution context
+   * @return
+   *  The image, or nullptr if none is cached for @dev and @generation
+   */
+  std::shared_ptr<const regmap_image_type>
+  get_regmap_image(const device* dev, unsigned int generation) const
+  {
+    std::lock_guard<std::mutex> lk(m_regmap_mutex);
+    return (m_regmap_device == dev && m_regmap_generation == generation)
+      ? m_regmap_image
+      : nullptr;
+  }
+
+  /**
+   * Cache register map image of argument values
+   *
+   * Replaces any previously cached image.
+   */
+  void
+  set_regmap_image(const device* dev, unsigned int generation,
+                   std::shared_ptr<const regmap_image_type> image) const
+  {
+    std::lock_guard<std::mutex> lk(m_regmap_mutex);
+    m_regmap_device = dev;
+    m_regmap_generation = generation;
+    m_regmap_image = std::move(image);
+  }
+
   void
   set_printf_argument(size_t sz, const void* arg)
   {
@@ -668,6 +727,13 @@ private:
   argument_vector_type m_printf_args;
   argument_vector_type m_progvar_args;
   argument_vector_type m_rtinfo_args;
+
+  // Register map image cache, see get_regmap_image()
+  std::atomic<unsigned int> m_arg_generation {0};
+  mutable std::mutex m_regmap_mutex;
+  mutable const device* m_regmap_device = nullptr;
+  mutable unsigned int m_regmap_generation = 0;
+  mutable std::shared_ptr<const regmap_image_type> m_regmap_image;
 };
 
 namespace kernel_utils {
@@ -132,14 +132,60 @@ set_kernel_argidx(const kernel* kernel, unsigned int argidx)
   return false;
 }
 
+// private
+const memory::buffer_object_handle*
+memory::
+find_slot_boh(const device* device, bool& overflow) const
+{
+  overflow = false;
+  for (auto& slot : m_boslots) {
+    auto dev = slot.dev.load(std::memory_order_acquire);
+    if (dev == device)
+      return &slot.boh;
+    if (!dev)
+      return nullptr;
+  }
+  overflow = true;
+  return nullptr;
+}
+
+// private
+const memory::buffer_object_handle*
+memory::
+find_boh_nolock(const device* device) const
+{
+  bool overflow = false;
+  if (auto boh = find_slot_boh(device,overflow))
+    return boh;
+  if (!overflow)
+    return nullptr;
+  auto itr = m_bomap.find(device);
+  return (itr==m_bomap.end()) ? nullptr : &(*itr).second;
+}
+
+// private
+const memory::buffer_object_handle&
+memory::
+add_boh_nolock(const device* device, buffer_object_handle boh)
+{
+  for (auto& slot : m_boslots) {
+    if (slot.dev.load(std::memory_order_relaxed))
+      continue;
+    slot.boh = std::move(boh);
+    slot.dev.store(device, std::memory_order_release);
+    return slot.boh;
+  }
+  return (m_bomap[device] = std::move(boh));
+}
+
 void
 memory::
 update_buffer_object_map(const device* device, buffer_object_handle boh)
 {
   std::lock_guard<std::mutex> lk(m_boh_mutex);
-  if (m_bomap.size() == 0) {
+  if (!m_boslots[0].dev.load(std::memory_order_relaxed)) {
     update_memidx_nolock(device,boh);
-    m_bomap[device] = std::move(boh);
+    add_boh_nolock(device,std::move(boh));
   }
   else {
     throw std::runtime_error("memory::update_buffer_object_map: bomap should be empty. This is a new cl_mem object.");
@@ -154,26 +200,29 @@ get_buffer_object(device* device, xrt::device::memoryDomain domain, uint64_t mem
   assert(domain==xrt::device::memoryDomain::XRT_DEVICE_PREALLOCATED_BRAM);
 
   std::lock_guard<std::mutex> lk(m_boh_mutex);
-  auto itr = m_bomap.find(device);
-  return (itr==m_bomap.end())
-    ? (m_bomap[device] = device->allocate_buffer_object(this,domain,memidx,nullptr))
-    : (*itr).second;
+  auto boh = find_boh_nolock(device);
+  return boh
+    ? *boh
+    : add_boh_nolock(device,device->allocate_buffer_object(this,domain,memidx,nullptr));
 }
 
 memory::buffer_object_handle
 memory::
 get_buffer_object(device* device)
 {
-  std::lock_guard<std::mutex> lk(m_boh_mutex);
-  auto itr = m_bomap.find(device);
+  // Fast path, buffer object already created
+  bool overflow = false;
+  if (auto boh = find_slot_boh(device,overflow))
+    return *boh;
 
-  if (itr!=m_bomap.end())
-    return (*itr).second;
+  std::lock_guard<std::mutex> lk(m_boh_mutex);
+  if (auto boh = find_boh_nolock(device))
+    return *boh;
 
   // Get memory bank index if assigned, -1 if not assigned, which will trigger
   // allocation error when default allocation is disabled
   get_memidx_nolock(device); // computes m_memidx
-  auto boh = (m_bomap[device] = device->allocate_buffer_object(this,m_memidx));
+  auto boh = add_boh_nolock(device,device->allocate_buffer_object(this,m_memidx));
 
   // To be deleted when strict bank rules are enforced
   if (boh && m_memidx==-1) {
@@ -209,35 +258,47 @@ memory::buffer_object_handle
 memory::
 get_buffer_object_or_error(const device* device) const
 {
+  bool overflow = false;
+  if (auto boh = find_slot_boh(device,overflow))
+    return *boh;
+
   std::lock_guard<std::mutex> lk(m_boh_mutex);
-  auto itr = m_bomap.find(device);
-  if (itr==m_bomap.end())
+  auto boh = find_boh_nolock(device);
+  if (!boh)
     throw std::runtime_error("Internal error. cl_mem doesn't map to buffer object");
-  return (*itr).second;
+  return *boh;
 }
 
 memory::buffer_object_handle
 memory::
 get_buffer_object_or_null(const device* device) const
 {
+  bool overflow = false;
+  if (auto boh = find_slot_boh(device,overflow))
+    return *boh;
+  if (!overflow)
+    return nullptr;
+
   std::lock_guard<std::mutex> lk(m_boh_mutex);
-  auto itr = m_bomap.find(device);
-  return itr==m_bomap.end()
-    ? nullptr
-    : (*itr).second;
+  auto boh = find_boh_nolock(device);
+  return boh ? *boh : nullptr;
 }
 
 memory::buffer_object_handle
 memory::
 try_get_buffer_object_or_error(const device* device) const
 {
+  bool overflow = false;
+  if (auto boh = find_slot_boh(device,overflow))
+    return *boh;
+
   std::unique_lock<std::mutex> lk(m_boh_mutex, std::defer_lock);
   if (!lk.try_lock())
     throw xocl::error(DBG_EXCEPT_LOCK_FAILED, "Failed to secure lock on buffer object");
-  auto itr = m_bomap.find(device);
-  if (itr == m_bomap.end())
+  auto boh = find_boh_nolock(device);
+  if (!boh)
     throw xocl::error(DBG_EXCEPT_NOBUF_HANDLE, "Failed to find buffer handle");
-  return (*itr).second;
+  return *boh;
 }
 
 // private
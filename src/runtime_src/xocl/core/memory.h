@@ -26,6 +26,8 @@
 #include "core/common/memalign.h"
 #include "core/common/unistd.h"
 
+#include <array>
+#include <atomic>
 #include <map>
 
 #ifdef _WIN32
@@ -474,6 +476,20 @@ private:
   memidx_type
   update_memidx_nolock(const device* device, const buffer_object_handle& boh);
 
+  // Lock free lookup of buffer object in device slots.  Return nullptr
+  // if device has no buffer object in a slot, and sets @overflow if
+  // the device may be in m_bomap
+  const buffer_object_handle*
+  find_slot_boh(const device* device, bool& overflow) const;
+
+  // Lookup buffer object, caller holds m_boh_mutex
+  const buffer_object_handle*
+  find_boh_nolock(const device* device) const;
+
+  // Add buffer object of device, caller holds m_boh_mutex
+  const buffer_object_handle&
+  add_boh_nolock(const device* device, buffer_object_handle boh);
+
 private:
   unsigned int m_uid = 0;
   ptr<context> m_context;
@@ -496,6 +512,17 @@ private:
   std::unique_ptr<std::vector<std::function<void()>>> m_dtor_notify;
 
   mutable std::mutex m_boh_mutex;
+
+  // Buffer objects of the first devices are kept in slots that are
+  // read without locking, buffer objects of further devices in
+  // m_bomap.  A slot is published by setting its device after its
+  // buffer object, and is never changed or removed after that.
+  struct bo_slot
+  {
+    std::atomic<const device*> dev {nullptr};
+    buffer_object_handle boh;
+  };
+  std::array<bo_slot,4> m_boslots;
   bomap_type m_bomap;
   std::vector<const device*> m_resident;
   connidx_type m_connidx = -1;
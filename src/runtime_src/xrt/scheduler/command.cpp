@@ -41,6 +41,9 @@ struct X {
 
 static X sx;
 
+// Number of commands constructed or reset
+static unsigned int uid_count = 0;
+
 static buffer_type
 get_buffer(xrt::device* device,size_t sz)
 {
@@ -102,7 +105,6 @@ command(xrt::device* device, ert_cmd_opcode opcode)
   , m_exec_bo(get_buffer(m_device,regmap_size*sizeof(value_type)))
   , m_packet(m_device->map(m_exec_bo))
 {
-  static unsigned int uid_count = 0;
   m_uid = uid_count++;
 
   // Clear in case packet was recycled
@@ -136,6 +138,25 @@ command::
   }
 }
 
+void
+command::
+reset(ert_cmd_opcode opcode)
+{
+  m_uid = uid_count++;
+
+  // Header is rewritten, payload is overwritten by caller
+  m_packet.resize(0);
+  m_packet[0] = 0;
+
+  auto epacket = get_ert_cmd<ert_packet*>();
+  epacket->state = ERT_CMD_STATE_NEW; // new command
+  epacket->opcode = opcode & 0x1F; // [4:0]
+  epacket->type = opcode >> 5;     // [9:5]
+
+  m_done = false;
+  XRT_DEBUG(std::cout,"xrt::command::reset(",m_uid,")\n");
+}
+
 void
 command::
 execute()
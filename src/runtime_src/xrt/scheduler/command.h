@@ -179,6 +179,20 @@ public:
     return reinterpret_cast<ERT_COMMAND_TYPE>(m_packet.data());
   }
 
+  /**
+   * Reset this command for reuse
+   *
+   * @opcode: opcode of the reused command
+   *
+   * Rewrites the command header and clears the packet size, the
+   * exec buffer stays mapped.  The payload is not cleared, the caller
+   * must write every word up to the new packet size.  The command
+   * must no longer be referenced by the scheduler.
+   */
+  XRT_EXPORT
+  void
+  reset(ert_cmd_opcode opcode);
+
   /**
    * Execute this command
    */
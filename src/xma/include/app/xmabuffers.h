@@ -78,6 +78,18 @@ typedef struct XmaBufferPoolObj
 
 } XmaBufferPoolObj;
 
+/**
+ * struct XmaBufferPoolStats - Recycling statistics of a frame pool or device buffer pool
+*/
+typedef struct XmaBufferPoolStats
+{
+    uint64_t num_allocs; /**< number of buffers requested from pool */
+    uint64_t num_hits; /**< requests served with a recycled buffer */
+    uint64_t num_misses; /**< requests which had to allocate a new buffer */
+    uint32_t num_buffers; /**< buffers currently owned by pool */
+    uint32_t num_free_buffers; /**< buffers currently available for reuse */
+} XmaBufferPoolStats;
+
 /**
  * struct XmaBufferRef - Reference counted buffer used in XmaFrame and XmaDataBuffer
  *
@@ -164,6 +176,11 @@ typedef struct XmaDataBuffer
     int32_t         poc; /**< Picture order count for current output frame */
 } XmaDataBuffer;
 
+/**
+ * XmaFramePoolHandle - A Handle to a pool of host frames with identical properties.
+*/
+typedef void* XmaFramePoolHandle;
+
 /**
  * struct XmaFrameData - Member structure with array of raw data pointers for multiplane buffer
 */
@@ -233,6 +250,53 @@ xma_frame_from_device_buffers(XmaFrameProperties *frame_props,
 void
 xma_frame_free(XmaFrame *frame);
 
+/**
+ * xma_frame_pool_create() - Create a pool of host frames with identical frame properties
+ * Frames obtained with xma_frame_pool_alloc() are returned to the pool
+ * by xma_frame_free() when their refcount drops to zero, so their
+ * plane buffers are reused instead of being freed and allocated again.
+ *
+ * @frame_props: Properties of the frames in this pool
+ * @num_frames: Number of frames to pre-allocate
+ *
+ * RETURN: XmaFramePoolHandle on success; NULL on failure
+*/
+XmaFramePoolHandle
+xma_frame_pool_create(XmaFrameProperties *frame_props, uint32_t num_frames);
+
+/**
+ * xma_frame_pool_alloc() - Get a frame from the frame pool
+ * A new frame is allocated if no free frame is available in the pool.
+ * Plane buffers of a pooled frame must not be replaced by the user.
+ *
+ * @pool: Frame pool handle returned by xma_frame_pool_create()
+ *
+ * RETURN: XmaFrame pointer; NULL on failure
+*/
+XmaFrame*
+xma_frame_pool_alloc(XmaFramePoolHandle pool);
+
+/**
+ * xma_frame_pool_get_stats() - Get recycling statistics of the frame pool
+ *
+ * @pool: Frame pool handle returned by xma_frame_pool_create()
+ * @stats: Statistics of the pool are returned here
+ *
+ * RETURN: XMA_SUCCESS on success; XMA_ERROR_INVALID on invalid arguments
+*/
+int32_t
+xma_frame_pool_get_stats(XmaFramePoolHandle pool, XmaBufferPoolStats *stats);
+
+/**
+ * xma_frame_pool_destroy() - Release the frame pool
+ * Free frames are released immediately. Frames still in use are
+ * released by xma_frame_free() instead of being returned to the pool.
+ *
+ * @pool: Frame pool handle returned by xma_frame_pool_create()
+*/
+void
+xma_frame_pool_destroy(XmaFramePoolHandle pool);
+
 /**
  * xma_side_data_alloc() - Allocates side data handle, with
  * reference count equal to 1. The side data buffer 'side_data'
@@ -470,7 +534,7 @@ xma_data_from_device_buffer(XmaBufferObj *dev_buf, bool clone);
 void
 xma_data_buffer_free(XmaDataBuffer *data);
 
-int32_t xma_add_ref_cnt(XmaBufferObj *b_obj, int32_t num);//Returns new value after adding
+int32_t xma_add_ref_cnt(XmaBufferObj *b_obj, int32_t num);//Returns new value after adding; Pool buffer is recycled when it drops to zero
 
 #ifdef __cplusplus
 }
@@ -27,6 +27,12 @@ namespace xma_core {
    int32_t finalize_ddr_index(XmaHwKernel* kernel_info, int32_t req_ddr_index, int32_t& ddr_index, const std::string& prefix);
    int32_t create_session_execbo(XmaHwSessionPrivate *priv, int32_t count, const std::string& prefix);
    int32_t check_plugin_version(int32_t plugin_main_ver, int32_t plugin_sub_ver);
+
+   int32_t add_pool_buffer_ref_cnt(XmaBufferObj* b_obj, int32_t num);
+   int32_t release_pool_buffer(XmaBufferObj* b_obj);
+   XmaBufferPool* get_buffer_pool(XmaHwSessionPrivate* priv, int32_t dev_index, uint64_t size, int32_t ddr_bank, bool device_only_buffer, bool device_pool);
+   void put_buffer_pool(XmaBufferPool* pool);
+   void destroy_session_buffer_pools(XmaHwSessionPrivate* priv);
 }
 
 namespace xma_core { namespace utils {
@@ -37,6 +43,17 @@ int32_t get_cu_index(int32_t dev_index, char* cu_name);
 int32_t get_default_ddr_index(int32_t dev_index, int32_t cu_index);
 
 int32_t check_all_execbo(XmaSession s_handle);
+uint64_t get_cmd_latency(XmaHwSessionPrivate *priv1, uint32_t& p50_us, uint32_t& p99_us, uint32_t& max_us);
+
+//Load of one session on its CU from busy vs idle samples and outstanding cu cmds
+uint32_t get_session_load(uint32_t cmd_busy, uint32_t cmd_idle, uint32_t num_cu_cmds);
+//Moving session from CU with cu_load to CU with alt_cu_load should reduce load by margin
+bool is_rebalance_needed(uint32_t cu_load, uint32_t alt_cu_load, uint32_t session_load);
+//Replace requested CU with least loaded CU of same kernel as per load_balance mode
+//With req_ddr_index >= 0 only CUs connected to that DDR bank are selected
+void select_least_loaded_cu(uint32_t& hwcfg_dev_index, int32_t& cu_index, int32_t req_ddr_index, const std::string& prefix);
+//Set rebalance_hint of sessions which have less loaded CU of same kernel available
+void update_rebalance_hints();
 
 } // namespace utils
 } // namespace xma_core
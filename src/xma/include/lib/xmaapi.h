@@ -41,6 +41,7 @@ typedef struct XmaSingleton
     XmaHwCfg          hwcfg;
     bool              xma_initialized;
     uint32_t          cpu_mode;
+    uint32_t          load_balance;
     std::mutex            m_mutex;
     std::atomic<uint32_t> num_decoders;
     std::atomic<uint32_t> num_encoders;
@@ -56,7 +57,7 @@ typedef struct XmaSingleton
 
     std::atomic<bool> xma_exit;
     std::thread       xma_thread1;
-    std::thread       xma_thread2;
+    std::vector<std::thread> xma_thread2;//One completion waiter per device
 
     uint32_t          reserved[4];
 
@@ -73,6 +74,7 @@ typedef struct XmaSingleton
     log_msg_list_locked = false;
     xma_exit = false;
     cpu_mode = 0;
+    load_balance = XMA_LOAD_BALANCE_NONE;
   }
 } XmaSingleton;
 
@@ -37,6 +37,7 @@
 #include <chrono>
 #include <list>
 #include <condition_variable>
+#include <mutex>
 
 #define MAX_EXECBO_BUFF_SIZE      4096// 4KB
 #define MAX_KERNEL_REGMAP_SIZE    4032//Some space used by ert pkt
@@ -87,6 +88,7 @@ typedef struct XmaHwExecBO
     int32_t     session_id;
     uint32_t    cu_cmd_id1;//Counter
     int32_t     cu_cmd_id2;//Random num
+    std::chrono::steady_clock::time_point submit_time;
 
   XmaHwExecBO() {
     in_use = false;
@@ -101,25 +103,39 @@ typedef struct XmaHwExecBO
 
 typedef struct XmaBufferPool
 {
-    std::list<XmaBufferObj>   buffers_busy;
-    std::vector<XmaBufferObj>  buffers_free;
-    std::atomic<bool> pool_locked;
+    std::mutex m_mutex;
+    std::vector<XmaBufferObj*> buffers_free;
+    xclDeviceHandle dev_handle;
     uint64_t buffer_size;
     int32_t  bank_index;
     int32_t  dev_index;
     bool     device_only_buffer;
+    bool     pool_destroyed;//Set when last owner is gone; pool is deleted with last buffer
+    uint32_t num_owners;//Sessions using the pool; Use m_mutex
+    XmaHwDevice* device;//Set for device pools shared by sessions of the device
     std::atomic<uint32_t> num_buffers;
     std::atomic<uint32_t> num_free_buffers;
+    std::atomic<uint64_t> num_allocs;
+    std::atomic<uint64_t> num_hits;
+    std::atomic<uint64_t> num_misses;
+    XmaBufferPoolObj pool_obj;//Handle given to plugin
     uint32_t reserved[4];
 
   XmaBufferPool() {
-   pool_locked = false;
+   dev_handle = NULL;
    num_buffers = 0;
    num_free_buffers = 0;
+   num_allocs = 0;
+   num_hits = 0;
+   num_misses = 0;
    buffer_size = 0;
    bank_index = -1;
    dev_index = -1;
    device_only_buffer = false;
+   pool_destroyed = false;
+   num_owners = 0;
+   device = nullptr;
+   std::memset(&pool_obj, 0, sizeof(pool_obj));
   }
 } XmaBufferPool;
 
@@ -163,6 +179,7 @@ typedef struct XmaHwSessionPrivate
     std::atomic<uint32_t> cmd_busy_ticks_tmp;
     std::atomic<uint32_t> cmd_idle_ticks_tmp;
     std::atomic<bool> slowest_element;
+    std::atomic<bool> rebalance_hint;//Less loaded CU of same kernel is available
     std::mutex m_mutex;
     std::condition_variable work_item_done_1plus;//Use with xma_plg_work_item_done
     std::condition_variable execbo_is_free; //Use with xma_plg_schedule_work_item and xma_plg_schedule_cu_cmd
@@ -176,7 +193,9 @@ typedef struct XmaHwSessionPrivate
     std::atomic<bool> execbo_locked;
     std::vector<XmaHwExecBO> kernel_execbos;
     int32_t    num_execbo_allocated;
-    std::list<XmaBufferPool>   buffer_pools;
+    std::mutex buffer_pools_mutex;
+    std::list<XmaBufferPool*>  buffer_pools;//Use buffer_pools_mutex when adding/removing pools
+    std::array<uint32_t, XMA_LATENCY_HIST_BUCKETS> cmd_latency_hist;//Use execbo lock; cu cmd submit to completion
 
     uint32_t reserved[4];
 
@@ -201,7 +220,9 @@ typedef struct XmaHwSessionPrivate
     using_work_item_done = false;
     using_cu_cmd_status = false;
     slowest_element = false;
+    rebalance_hint = false;
     last_execbo_handle = NULLBO;
+    cmd_latency_hist.fill(0);
   }
 } XmaHwSessionPrivate;
 
@@ -216,6 +237,8 @@ typedef struct XmaBufferObjPrivate
     std::atomic<int32_t> ref_cnt;
     bool     device_only_buffer;
     xclDeviceHandle dev_handle;
+    XmaBufferPool* pool;//Owning pool if allocated with xma_plg_buffer_pool_get_buffer
+    std::atomic<bool> pool_busy;//Handed out by pool and not yet recycled
     uint32_t reserved[4];
 
   XmaBufferObjPrivate() {
@@ -227,6 +250,8 @@ typedef struct XmaBufferObjPrivate
    dev_handle = NULL;
    device_only_buffer = false;
    boHandle = 0;
+   pool = nullptr;
+   pool_busy = false;
   }
 } XmaBufferObjPrivate;
 
@@ -334,6 +359,7 @@ typedef struct XmaHwDevice
     uint32_t    cu_cmd_id2;//Counter
     std::mt19937 mt_gen;
     std::uniform_int_distribution<int32_t> rnd_dis;
+    std::list<XmaBufferPool*> buffer_pools;//Device pools; Use xma_core device pools mutex
 
     uint32_t    reserved[16];
 
@@ -46,6 +46,18 @@
 #define XMA_CPU_MODE3           3  //Same as legacy
 #define XMA_CPU_MODE4           4  //Low cpu load
 
+#define XMA_LATENCY_HIST_BUCKETS 24 //log2 of usec; Last bucket is >= 4 sec
+
+#define XMA_LOAD_BALANCE_NONE        0  //Use CU requested by session
+#define XMA_LOAD_BALANCE_DEVICE      1  //Least loaded CU of same kernel on requested device
+#define XMA_LOAD_BALANCE_ALL_DEVICES 2  //Least loaded CU of same kernel on any device
+
+#define XMA_LOAD_FULL           1024 //Session load when CU is always busy with its cmds
+#define XMA_LOAD_PER_CMD        32   //Extra load per outstanding cu cmd
+#define XMA_LOAD_MIN_SAMPLES    128  //New sessions are counted as fully loaded
+#define XMA_REBALANCE_MARGIN    256  //Min load reduction for rebalance hint
+#define XMA_REBALANCE_TICKS     100  //Rebalance hints updated every 100 stats samples (~1 sec)
+
 #define INVALID_M1             -1
 #define STATS_WINDOW            4096.0f
 #define STATS_WINDOW_1          4095
@@ -56,6 +56,20 @@ int32_t xma_get_default_ddr_index(int32_t dev_index, int32_t cu_index, char* cu_
 
 void xma_get_session_cmd_load(void);
 
+/**
+ *  xma_get_session_rebalance_hint() - Check if session would run faster on another CU
+ *
+ *  Enabled with xrt.ini Runtime.xma_load_balance setting. 1 = same device; 2 = any device.
+ *  With it, session creation uses the least loaded CU of requested kernel.
+ *  Long running sessions may recreate session when this hint is set.
+ *
+ *  @session: Any session type. For example: (XmaSession*)dec_session
+ * 
+ * RETURN: 1 if less loaded CU of same kernel is available; 0 if not; XMA_ERROR on error
+ * 
+*/
+int32_t xma_get_session_rebalance_hint(XmaSession *session);
+
 void xma_enable_mode1(void);//Hidden mode. To allow bulk submission of cu commands
 void xma_enable_mode2(void);//Hidden mode. To allow only one cu command submission per session at a time
 
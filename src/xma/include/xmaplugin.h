@@ -134,6 +134,106 @@ xma_plg_buffer_alloc_ddr(XmaSession s_handle, size_t size, bool device_only_buff
  */
 void xma_plg_buffer_free(XmaSession s_handle, XmaBufferObj b_obj);
 
+/**
+ *  xma_plg_buffer_pool_create() - Create a pool of device buffers
+ *  This function creates a pool of device buffers of the same size
+ *  on the same DDR bank and pre-allocates num_buffers of them. Buffers
+ *  are recycled through the pool instead of being freed, so the steady
+ *  state of a plugin does not allocate or map BOs. Calling this function
+ *  again with the same size, DDR bank and buffer type returns the
+ *  existing pool of this session. Typically called from plugin init
+ *  so that buffers are pre-allocated at session creation.
+ *
+ *  @s_handle: The session handle associated with this plugin instance.
+ *  @size:     Size in bytes of each device buffer in the pool.
+ *  @device_only_buffer: Allocate device only buffers without any host space
+ *  @ddr_index: DDR bank of the buffers. Use -1 for default session DDR bank
+ *  @num_buffers: Number of buffers to pre-allocate
+ *  @return_code:  XMA_SUCESS or XMA_ERROR.
+ *
+ *  RETURN:    Buffer pool object on success; NULL on failure
+ *
+ */
+XmaBufferPoolObj* xma_plg_buffer_pool_create(XmaSession s_handle, size_t size, bool device_only_buffer,
+                                             int32_t ddr_index, uint32_t num_buffers, int32_t* return_code);
+
+/**
+ *  xma_plg_device_buffer_pool_create() - Create a device buffer pool shared by sessions
+ *  Same as xma_plg_buffer_pool_create() except that the pool belongs to
+ *  the device. Sessions on the same device asking for the same size,
+ *  DDR bank and buffer type share one pool. Each session must destroy
+ *  the pool with xma_plg_buffer_pool_destroy() or at session destroy;
+ *  the pool is freed when the last session and last buffer in use are gone.
+ *
+ *  @s_handle: The session handle associated with this plugin instance.
+ *  @size:     Size in bytes of each device buffer in the pool.
+ *  @device_only_buffer: Allocate device only buffers without any host space
+ *  @ddr_index: DDR bank of the buffers. Use -1 for default session DDR bank
+ *  @num_buffers: Number of buffers to pre-allocate
+ *  @return_code:  XMA_SUCESS or XMA_ERROR.
+ *
+ *  RETURN:    Buffer pool object on success; NULL on failure
+ *
+ */
+XmaBufferPoolObj* xma_plg_device_buffer_pool_create(XmaSession s_handle, size_t size, bool device_only_buffer,
+                                                    int32_t ddr_index, uint32_t num_buffers, int32_t* return_code);
+
+/**
+ *  xma_plg_buffer_pool_get_buffer() - Get a device buffer from the pool
+ *  A free buffer of the pool is returned with reference count of one.
+ *  If no buffer is free then a new buffer is added to the pool.
+ *  The buffer goes back to the pool when its reference count drops
+ *  to zero via xma_plg_buffer_pool_release_buffer(), xma_plg_add_ref_cnt()
+ *  or when a frame/data buffer owning it is freed.
+ *
+ *  @b_pool:   Buffer pool object returned by xma_plg_buffer_pool_create()
+ *  @return_code:  XMA_SUCESS or XMA_ERROR.
+ *
+ *  RETURN:    BufferObject pointer on success; NULL on failure
+ *
+ */
+XmaBufferObj* xma_plg_buffer_pool_get_buffer(XmaBufferPoolObj* b_pool, int32_t* return_code);
+
+/**
+ *  xma_plg_buffer_pool_release_buffer() - Release a reference to a pool buffer
+ *  Buffer is returned to its pool when its reference count drops to zero.
+ *
+ *  @b_obj:    BufferObject returned by xma_plg_buffer_pool_get_buffer()
+ *
+ *  RETURN:     XMA_SUCCESS on success
+ * XMA_ERROR on failure
+ *
+ */
+int32_t xma_plg_buffer_pool_release_buffer(XmaBufferObj* b_obj);
+
+/**
+ *  xma_plg_buffer_pool_get_stats() - Get recycling statistics of the pool
+ *
+ *  @b_pool:   Buffer pool object returned by xma_plg_buffer_pool_create()
+ *  @stats:    Statistics of the pool are returned here
+ *
+ *  RETURN:     XMA_SUCCESS on success
+ * XMA_ERROR on failure
+ *
+ */
+int32_t xma_plg_buffer_pool_get_stats(XmaBufferPoolObj* b_pool, XmaBufferPoolStats* stats);
+
+/**
+ *  xma_plg_buffer_pool_destroy() - Free a pool of device buffers
+ *  Free buffers of the pool are freed immediately. Buffers still in use
+ *  are freed when they are released, also after the session is destroyed.
+ *  Pools not destroyed by the plugin are destroyed when the session is
+ *  destroyed. A device pool is freed only after all its sessions destroy it.
+ *
+ *  @s_handle: The session handle associated with this plugin instance
+ *  @b_pool:   Buffer pool object returned by xma_plg_buffer_pool_create()
+ *
+ *  RETURN:     XMA_SUCCESS on success
+ * XMA_ERROR on failure
+ *
+ */
+int32_t xma_plg_buffer_pool_destroy(XmaSession s_handle, XmaBufferPoolObj* b_pool);
+
 /**
  *  xma_plg_buffer_write() - Write data from host to device buffer
  *  This function copies data from host memory to device memory.
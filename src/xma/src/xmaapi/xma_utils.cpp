@@ -118,6 +118,164 @@ namespace xma_core {
         }
         return XMA_SUCCESS;
     }
+
+    static void free_pool_buffer(XmaBufferObj* b_obj) {
+        //pool lock must be already obtained
+        XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+        xclFreeBO(b_obj_priv->dev_handle, b_obj_priv->boHandle);
+        b_obj_priv->dummy = nullptr;
+        b_obj_priv->size = -1;
+        b_obj_priv->bank_index = -1;
+        b_obj_priv->dev_index = -1;
+        b_obj_priv->pool = nullptr;
+        delete b_obj_priv;
+        b_obj->data = nullptr;
+        b_obj->private_do_not_touch = nullptr;
+        delete b_obj;
+    }
+
+    static void delete_buffer_pool(XmaBufferPool* pool) {
+        //Last owner and last buffer are gone
+        XmaBufferPoolObjPrivate* pool_priv = (XmaBufferPoolObjPrivate*) pool->pool_obj.private_do_not_touch;
+        pool_priv->dummy = nullptr;
+        pool_priv->pool_ptr = nullptr;
+        delete pool_priv;
+        delete pool;
+    }
+
+    int32_t release_pool_buffer(XmaBufferObj* b_obj) {
+        XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+        XmaBufferPool* pool = b_obj_priv->pool;
+        bool expected = true;
+        if (!b_obj_priv->pool_busy.compare_exchange_strong(expected, false)) {
+            xma_logmsg(XMA_ERROR_LOG, XMAUTILS_MOD, "Pool buffer is already released to the pool");
+            return XMA_ERROR;
+        }
+        b_obj_priv->ref_cnt = 0;
+
+        bool delete_pool = false;
+        {
+            std::lock_guard<std::mutex> guard1(pool->m_mutex);
+            if (!pool->pool_destroyed) {
+                pool->buffers_free.emplace_back(b_obj);
+                pool->num_free_buffers++;
+                return XMA_SUCCESS;
+            }
+            free_pool_buffer(b_obj);
+            pool->num_buffers--;
+            delete_pool = (pool->num_buffers == 0);
+        }
+        if (delete_pool) {
+            delete_buffer_pool(pool);
+        }
+        return XMA_SUCCESS;
+    }
+
+    int32_t add_pool_buffer_ref_cnt(XmaBufferObj* b_obj, int32_t num) {
+        XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+        int32_t ref_cnt = (b_obj_priv->ref_cnt += num);
+        if (ref_cnt <= 0) {
+            //Last reference dropped; buffer goes back to its pool
+            release_pool_buffer(b_obj);
+        }
+        return ref_cnt;
+    }
+
+    //Device pools of all devices; XmaHwDevice is kept in a vector and can not own a mutex
+    static std::mutex g_device_pools_mutex;
+
+    XmaBufferPool* get_buffer_pool(XmaHwSessionPrivate* priv, int32_t dev_index, uint64_t size, int32_t ddr_bank, bool device_only_buffer, bool device_pool) {
+        //session buffer_pools_mutex must be already obtained
+        //Pools are keyed by buffer size, ddr bank and buffer type
+        for (auto pool: priv->buffer_pools) {
+            if (pool->buffer_size == size && pool->bank_index == ddr_bank && pool->device_only_buffer == device_only_buffer
+                && (pool->device != nullptr) == device_pool) {
+                return pool;
+            }
+        }
+
+        XmaBufferPool* pool = nullptr;
+        std::unique_lock<std::mutex> guard1(g_device_pools_mutex, std::defer_lock);
+        if (device_pool) {
+            guard1.lock();
+            for (auto itr1: priv->device->buffer_pools) {
+                if (itr1->buffer_size == size && itr1->bank_index == ddr_bank && itr1->device_only_buffer == device_only_buffer) {
+                    std::lock_guard<std::mutex> guard2(itr1->m_mutex);
+                    itr1->num_owners++;
+                    pool = itr1;
+                    break;
+                }
+            }
+        }
+        if (pool == nullptr) {
+            pool = new XmaBufferPool;
+            pool->dev_handle = priv->dev_handle;
+            pool->buffer_size = size;
+            pool->bank_index = ddr_bank;
+            pool->dev_index = dev_index;
+            pool->device_only_buffer = device_only_buffer;
+            pool->num_owners = 1;
+
+            XmaBufferPoolObjPrivate* pool_priv = new XmaBufferPoolObjPrivate;
+            pool_priv->dummy = (void*)(((uint64_t)pool_priv) | signature);
+            pool_priv->buffer_size = size;
+            pool_priv->bank_index = ddr_bank;
+            pool_priv->dev_index = dev_index;
+            pool_priv->device_only_buffer = device_only_buffer;
+            pool_priv->pool_ptr = pool;
+
+            pool->pool_obj.buffer_size = size;
+            pool->pool_obj.bank_index = ddr_bank;
+            pool->pool_obj.dev_index = dev_index;
+            pool->pool_obj.device_only_buffer = device_only_buffer;
+            pool->pool_obj.private_do_not_touch = (void*) pool_priv;
+            if (device_pool) {
+                pool->device = priv->device;
+                priv->device->buffer_pools.emplace_back(pool);
+            }
+        }
+        priv->buffer_pools.emplace_back(pool);
+
+        return pool;
+    }
+
+    void put_buffer_pool(XmaBufferPool* pool) {
+        //Buffers still in use are freed when they are released
+        bool delete_pool = false;
+        {
+            std::unique_lock<std::mutex> guard1(g_device_pools_mutex, std::defer_lock);
+            if (pool->device) {
+                guard1.lock();
+            }
+            std::lock_guard<std::mutex> guard2(pool->m_mutex);
+            pool->num_owners--;
+            if (pool->num_owners > 0) {
+                return;
+            }
+            if (pool->device) {
+                pool->device->buffer_pools.remove(pool);
+            }
+            pool->pool_destroyed = true;
+            for (auto b_obj: pool->buffers_free) {
+                free_pool_buffer(b_obj);
+                pool->num_buffers--;
+            }
+            pool->buffers_free.clear();
+            pool->num_free_buffers = 0;
+            delete_pool = (pool->num_buffers == 0);
+        }
+        if (delete_pool) {
+            delete_buffer_pool(pool);
+        }
+    }
+
+    void destroy_session_buffer_pools(XmaHwSessionPrivate* priv) {
+        std::lock_guard<std::mutex> guard1(priv->buffer_pools_mutex);
+        for (auto pool: priv->buffer_pools) {
+            put_buffer_pool(pool);
+        }
+        priv->buffer_pools.clear();
+    }
 }
 
 namespace xma_core { namespace utils {
@@ -412,6 +570,22 @@ void get_session_cmd_load() {
             xma_core::get_session_name(itr1.session_type).c_str(), avg_cmds, (uint32_t)priv1->cmd_busy, (uint32_t)priv1->cmd_idle);
 
         xma_logmsg(level, "XMA-Session-Stats", "Session id: %d, max busy vs idle ticks: %d vs %d, relative cu load: %d", itr1.session_id, (uint32_t)priv1->cmd_busy_ticks, (uint32_t)priv1->cmd_idle_ticks, (uint32_t)priv1->kernel_complete_total);
+        uint32_t p50_us, p99_us, max_us;
+        uint64_t num_cmds = get_cmd_latency(priv1, p50_us, p99_us, max_us);
+        if (num_cmds != 0) {
+            xma_logmsg(level, "XMA-Session-Stats", "Session id: %d, cu cmd latency (usec) p50: <%d, p99: <%d, max: <%d, cmds: %lu", itr1.session_id, p50_us, p99_us, max_us, num_cmds);
+        }
+        {
+            std::lock_guard<std::mutex> guard1(priv1->buffer_pools_mutex);
+            for (auto pool: priv1->buffer_pools) {
+                float hit_rate = 0;
+                if (pool->num_allocs > 0) {
+                    hit_rate = (100.0 * pool->num_hits) / pool->num_allocs;
+                }
+                xma_logmsg(level, "XMA-Session-Stats", "Session id: %d, %s buffer pool size: %lu, ddr: %d, buffers: %d, free: %d, hit rate: %.2f%%", itr1.session_id,
+                    pool->device ? "device" : "session", pool->buffer_size, pool->bank_index, (uint32_t)pool->num_buffers, (uint32_t)pool->num_free_buffers, hit_rate);
+            }
+        }
         XmaHwKernel* kernel_info = priv1->kernel_info;
         if (kernel_info == NULL) {
             continue;
@@ -514,6 +688,55 @@ int32_t get_default_ddr_index(int32_t dev_index, int32_t cu_index) {
     }
 }
 
+static void record_cmd_latency(XmaHwSessionPrivate *priv1, const XmaHwExecBO& ebo) {
+    //NOTE: execbo lock must be already obtained
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - ebo.submit_time).count();
+    uint32_t bucket = 0;
+    while (usec > 0 && bucket < XMA_LATENCY_HIST_BUCKETS - 1) {
+        usec = usec >> 1;
+        bucket++;
+    }
+    priv1->cmd_latency_hist[bucket]++;
+}
+
+uint64_t get_cmd_latency(XmaHwSessionPrivate *priv1, uint32_t& p50_us, uint32_t& p99_us, uint32_t& max_us) {
+    //Returns upper bound of histogram bucket for each percentile
+    uint64_t total = 0;
+    for (auto val: priv1->cmd_latency_hist) {
+        total += val;
+    }
+    p50_us = 0;
+    p99_us = 0;
+    max_us = 0;
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t running = 0;
+    for (uint32_t i = 0; i < XMA_LATENCY_HIST_BUCKETS; i++) {
+        if (priv1->cmd_latency_hist[i] == 0) {
+            continue;
+        }
+        running += priv1->cmd_latency_hist[i];
+        uint32_t upper_us = 1U << i;
+        if (p50_us == 0 && running * 2 >= total) {
+            p50_us = upper_us;
+        }
+        if (p99_us == 0 && running * 100 >= total * 99) {
+            p99_us = upper_us;
+        }
+        max_us = upper_us;
+    }
+    return total;
+}
+
+static void notify_work_item_done(XmaHwSessionPrivate *priv1) {
+    //Take waiter lock so that notification is not lost between predicate check and wait
+    {
+        std::lock_guard<std::mutex> lk(priv1->m_mutex);
+    }
+    priv1->work_item_done_1plus.notify_all();
+}
+
 int32_t check_all_execbo(XmaSession s_handle) {
     //NOTE: execbo lock must be already obtained
     //Check only for commands in-progress in this sessions else too much checking will waste CPU cycles
@@ -535,6 +758,7 @@ int32_t check_all_execbo(XmaSession s_handle) {
                             priv1->kernel_complete_count++;
                             priv1->kernel_complete_total++;
                         }
+                        record_cmd_latency(priv1, ebo);
                         notify_execbo_is_free = true;
                         ebo.in_use = false;
                         cu_cmd->state = ERT_CMD_STATE_MAX;
@@ -566,6 +790,7 @@ int32_t check_all_execbo(XmaSession s_handle) {
                             priv1->kernel_complete_count++;
                             priv1->kernel_complete_total++;
                         }
+                        record_cmd_latency(priv1, ebo);
                         ebo.in_use = false;
                         cu_cmd->state = ERT_CMD_STATE_MAX;
                         notify_work_item_done_1plus = true;
@@ -587,12 +812,12 @@ int32_t check_all_execbo(XmaSession s_handle) {
                 priv1->execbo_is_free.notify_all();
             }
             if (notify_work_item_done_1plus) {
-                priv1->work_item_done_1plus.notify_all();
+                notify_work_item_done(priv1);
                 if (priv1->slowest_element) {
                     std::this_thread::yield();
                 }
             } else if (priv1->kernel_complete_count != 0) {
-                priv1->work_item_done_1plus.notify_all();
+                notify_work_item_done(priv1);
                 if (priv1->slowest_element) {
                     std::this_thread::yield();
                 }
@@ -606,5 +831,142 @@ int32_t check_all_execbo(XmaSession s_handle) {
     return XMA_SUCCESS;
 }
 
+uint32_t get_session_load(uint32_t cmd_busy, uint32_t cmd_idle, uint32_t num_cu_cmds) {
+    //Session without enough samples may still ramp up; Count it as fully loaded
+    uint32_t samples = cmd_busy + cmd_idle;
+    uint32_t load = XMA_LOAD_FULL;
+    if (samples >= XMA_LOAD_MIN_SAMPLES) {
+        load = (uint32_t)(((uint64_t)cmd_busy * XMA_LOAD_FULL) / samples);
+    }
+    return load + num_cu_cmds * XMA_LOAD_PER_CMD;
+}
+
+bool is_rebalance_needed(uint32_t cu_load, uint32_t alt_cu_load, uint32_t session_load) {
+    //After move alt CU has alt_cu_load + session_load; Must be clearly below current CU load
+    return (uint64_t)alt_cu_load + session_load + XMA_REBALANCE_MARGIN <= cu_load;
+}
+
+static bool is_same_kernel(const XmaHwKernel& kernel1, const XmaHwKernel& kernel2) {
+    //CU names are kernel:{instance}
+    if (kernel1.soft_kernel || kernel2.soft_kernel) {
+        return false;
+    }
+    std::string name1 = std::string((char*)kernel1.name);
+    std::string name2 = std::string((char*)kernel2.name);
+    return name1.substr(0, name1.find(":")) == name2.substr(0, name2.find(":"));
+}
+
+static void get_cu_loads(std::unordered_map<const XmaHwKernel*, uint32_t>& cu_loads) {
+    //singleton should be locked before calling this function
+    for (auto& itr1: g_xma_singleton->all_sessions_vec) {
+        XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) itr1.hw_session.private_do_not_use;
+        if (priv1 == NULL || priv1->kernel_info == NULL) {
+            continue;
+        }
+        cu_loads[priv1->kernel_info] += get_session_load(priv1->cmd_busy, priv1->cmd_idle, priv1->num_cu_cmds);
+    }
+}
+
+static uint32_t get_cu_load(const std::unordered_map<const XmaHwKernel*, uint32_t>& cu_loads, const XmaHwKernel& kernel) {
+    auto itr1 = cu_loads.find(&kernel);
+    if (itr1 == cu_loads.end()) {
+        return 0;
+    }
+    return itr1->second;
+}
+
+void select_least_loaded_cu(uint32_t& hwcfg_dev_index, int32_t& cu_index, int32_t req_ddr_index, const std::string& prefix) {
+    XmaHwCfg *hwcfg = &g_xma_singleton->hwcfg;
+    const XmaHwKernel& req_kernel = hwcfg->devices[hwcfg_dev_index].kernels[cu_index];
+    if (g_xma_singleton->load_balance == XMA_LOAD_BALANCE_NONE || req_kernel.soft_kernel) {
+        return;
+    }
+
+    std::unordered_map<const XmaHwKernel*, uint32_t> cu_loads;
+    std::lock_guard<std::mutex> guard1(g_xma_singleton->m_mutex);
+    //Singleton lock acquired
+    get_cu_loads(cu_loads);
+
+    //Requested CU wins ties
+    uint32_t best_dev_index = hwcfg_dev_index;
+    int32_t best_cu_index = cu_index;
+    uint32_t best_load = get_cu_load(cu_loads, req_kernel);
+    for (uint32_t d = 0; d < hwcfg->devices.size() && best_load != 0; d++) {
+        if (d != hwcfg_dev_index && g_xma_singleton->load_balance != XMA_LOAD_BALANCE_ALL_DEVICES) {
+            continue;
+        }
+        for (XmaHwKernel& kernel: hwcfg->devices[d].kernels) {
+            if (!is_same_kernel(kernel, req_kernel)) {
+                continue;
+            }
+            if (req_ddr_index >= 0 && req_ddr_index < MAX_DDR_MAP) {
+                //User selected ddr bank must stay valid for the selected CU
+                std::bitset<MAX_DDR_MAP> tmp_bset;
+                tmp_bset = kernel.ip_ddr_mapping;
+                if (!tmp_bset[req_ddr_index]) {
+                    continue;
+                }
+            }
+            uint32_t load = get_cu_load(cu_loads, kernel);
+            if (load < best_load) {
+                best_load = load;
+                best_dev_index = d;
+                best_cu_index = kernel.cu_index;
+            }
+        }
+    }
+    if (best_dev_index != hwcfg_dev_index || best_cu_index != cu_index) {
+        xma_logmsg(XMA_INFO_LOG, prefix.c_str(),
+                   "Load balance: session moved from CU %s on device %d to less loaded CU %s on device %d\n",
+                   (char*)req_kernel.name, hwcfg->devices[hwcfg_dev_index].dev_index,
+                   (char*)hwcfg->devices[best_dev_index].kernels[best_cu_index].name, hwcfg->devices[best_dev_index].dev_index);
+        hwcfg_dev_index = best_dev_index;
+        cu_index = best_cu_index;
+    }
+}
+
+void update_rebalance_hints() {
+    XmaHwCfg *hwcfg = &g_xma_singleton->hwcfg;
+    std::unordered_map<const XmaHwKernel*, uint32_t> cu_loads;
+    std::lock_guard<std::mutex> guard1(g_xma_singleton->m_mutex);
+    //Singleton lock acquired
+    get_cu_loads(cu_loads);
+
+    for (auto& itr1: g_xma_singleton->all_sessions_vec) {
+        XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) itr1.hw_session.private_do_not_use;
+        if (priv1 == NULL || priv1->kernel_info == NULL || priv1->device == NULL) {
+            continue;
+        }
+        XmaHwKernel* kernel_info = priv1->kernel_info;
+        bool hint = false;
+        //Only long running sessions get the hint
+        if (!kernel_info->soft_kernel && priv1->cmd_busy + priv1->cmd_idle >= XMA_LOAD_MIN_SAMPLES) {
+            uint32_t session_load = get_session_load(priv1->cmd_busy, priv1->cmd_idle, priv1->num_cu_cmds);
+            uint32_t cu_load = get_cu_load(cu_loads, *kernel_info);
+            for (XmaHwDevice& hw_device: hwcfg->devices) {
+                if (&hw_device != priv1->device && g_xma_singleton->load_balance != XMA_LOAD_BALANCE_ALL_DEVICES) {
+                    continue;
+                }
+                for (XmaHwKernel& kernel: hw_device.kernels) {
+                    if (&kernel == kernel_info || !is_same_kernel(kernel, *kernel_info)) {
+                        continue;
+                    }
+                    if (is_rebalance_needed(cu_load, get_cu_load(cu_loads, kernel), session_load)) {
+                        hint = true;
+                        break;
+                    }
+                }
+                if (hint) {
+                    break;
+                }
+            }
+        }
+        if (hint && !priv1->rebalance_hint) {
+            xma_logmsg(XMA_DEBUG_LOG, XMAUTILS_MOD, "Session id: %d, less loaded CU available than CU %s", itr1.session_id, (char*)kernel_info->name);
+        }
+        priv1->rebalance_hint = hint;
+    }
+}
+
 } // namespace utils
 } // namespace xma_core
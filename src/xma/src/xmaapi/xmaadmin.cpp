@@ -240,6 +240,9 @@ xma_admin_session_destroy(XmaAdminSession *session)
         xma_logmsg(XMA_ERROR_LOG, XMA_ADMIN_MOD,
                    "Error closing admin plugin\n");
 
+    // Free device buffer pools not released by plugin
+    xma_core::destroy_session_buffer_pools((XmaHwSessionPrivate*)session->base.hw_session.private_do_not_use);
+
     // Clean up the private data
     free(session->base.plugin_data);
 
@@ -76,6 +76,7 @@ void xma_thread1() {
     bool expected = false;
     bool desired = true;
     std::list<XmaLogMsg> list1;
+    uint32_t rebalance_ticks = 0;
     while (!g_xma_singleton->xma_exit) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
         while (!g_xma_singleton->log_msg_list_locked.compare_exchange_weak(expected, desired)) {
@@ -203,6 +204,13 @@ void xma_thread1() {
             if (slowest_session) {
                 slowest_session->slowest_element = true;
             }
+            if (g_xma_singleton->load_balance != XMA_LOAD_BALANCE_NONE) {
+                rebalance_ticks++;
+                if (rebalance_ticks >= XMA_REBALANCE_TICKS) {
+                    rebalance_ticks = 0;
+                    xma_core::utils::update_rebalance_hints();
+                }
+            }
         }
     }
     //Print all stats here
@@ -224,6 +232,11 @@ void xma_thread1() {
             xma_core::get_session_name(itr1.session_type).c_str(), avg_cmds, (uint32_t)priv1->cmd_busy, (uint32_t)priv1->cmd_idle);
 
         xclLogMsg(NULL, XRT_INFO, "XMA-Session-Stats", "Session id: %d, max busy vs idle ticks: %d vs %d, relative cu load: %d", itr1.session_id, (uint32_t)priv1->cmd_busy_ticks, (uint32_t)priv1->cmd_idle_ticks, (uint32_t)priv1->kernel_complete_total);
+        uint32_t p50_us, p99_us, max_us;
+        uint64_t num_cmds = xma_core::utils::get_cmd_latency(priv1, p50_us, p99_us, max_us);
+        if (num_cmds != 0) {
+            xclLogMsg(NULL, XRT_INFO, "XMA-Session-Stats", "Session id: %d, cu cmd latency (usec) p50: <%d, p99: <%d, max: <%d, cmds: %lu", itr1.session_id, p50_us, p99_us, max_us, num_cmds);
+        }
         XmaHwKernel* kernel_info = priv1->kernel_info;
         if (kernel_info == NULL) {
             continue;
@@ -248,45 +261,50 @@ void xma_thread1() {
     xclLogMsg(NULL, XRT_INFO, "XMA-Session-Stats", "--------\n");
 }
 
-void xma_thread2() {
+void xma_thread2(XmaHwDevice *device) {
+    //Completion waiter for one device. Only sessions on this device are
+    //checked, so completions on other devices are not delayed by this wait.
+    //Sessions are copied under singleton lock. Session destroy holds the
+    //singleton lock while plugin close waits for cu cmds, so the previous
+    //copy is used when the lock is busy.
     bool expected = false;
     bool desired = true;
-    int32_t session_index = 0;
-    int32_t num_sessions = -1;
+    std::vector<XmaSession> device_sessions;
     while (!g_xma_singleton->xma_exit) {
-        num_sessions = g_xma_singleton->all_sessions_vec.size();
-        if (num_sessions == 0) {
+        std::unique_lock<std::mutex> guard1(g_xma_singleton->m_mutex, std::try_to_lock);
+        if (guard1.owns_lock()) {
+            //Singleton lock acquired
+            device_sessions.clear();
+            for (auto& itr1: g_xma_singleton->all_sessions_vec) {
+                XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) itr1.hw_session.private_do_not_use;
+                if (priv1 != NULL && priv1->device == device) {
+                    device_sessions.push_back(itr1);
+                }
+            }
+            guard1.unlock();
+        }
+        if (device_sessions.size() == 0) {
             std::this_thread::sleep_for(std::chrono::milliseconds(30));
             continue;
         }
-        if (session_index >= num_sessions) {
-            session_index = 0;
-        }
-        XmaHwSessionPrivate *priv2 = (XmaHwSessionPrivate*) g_xma_singleton->all_sessions_vec[session_index].hw_session.private_do_not_use;
         if (g_xma_singleton->cpu_mode == XMA_CPU_MODE2) {
             std::this_thread::sleep_for(std::chrono::milliseconds(3));
         } else {
-            xclExecWait(priv2->dev_handle, 100);
+            xclExecWait(device->handle, 100);
         }
-        session_index++;
 
-        for (auto& itr1: g_xma_singleton->all_sessions_vec) {
+        for (auto& itr1: device_sessions) {
             if (g_xma_singleton->xma_exit) {
                 break;
             }
             XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) itr1.hw_session.private_do_not_use;
             expected = false;
-/*
-            while (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
-                std::this_thread::yield();
-                expected = false;
-            }
-*/
             if (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
                 continue;
             }
             //execbo lock acquired
 
+            //Wakes up only waiters of this session
             if (xma_core::utils::check_all_execbo(itr1) != XMA_SUCCESS) {
                 xma_logmsg(XMA_ERROR_LOG, XMAAPI_MOD, "XMA thread2 failed-4. Unexpected error\n");
                 //Release execbo lock
@@ -304,6 +322,25 @@ void xma_get_session_cmd_load() {
     xma_core::utils::get_session_cmd_load();
 }
 
+int32_t xma_get_session_rebalance_hint(XmaSession *session) {
+    if (session == NULL) {
+        xma_logmsg(XMA_ERROR_LOG, XMAAPI_MOD, "xma_get_session_rebalance_hint failed. Session is NULL.\n");
+        return XMA_ERROR;
+    }
+    //All session types have XmaSession base as first member
+    XmaSession& s_handle = *session;
+    XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) s_handle.hw_session.private_do_not_use;
+    if (priv1 == NULL) {
+        xma_logmsg(XMA_ERROR_LOG, XMAAPI_MOD, "xma_get_session_rebalance_hint failed. XMASession is corrupted.\n");
+        return XMA_ERROR;
+    }
+    if (s_handle.session_signature != (void*)(((uint64_t)priv1) | ((uint64_t)priv1->reserved))) {
+        xma_logmsg(XMA_ERROR_LOG, XMAAPI_MOD, "xma_get_session_rebalance_hint failed. XMASession is corrupted.\n");
+        return XMA_ERROR;
+    }
+    return priv1->rebalance_hint ? 1 : 0;
+}
+
 int32_t xma_initialize(XmaXclbinParameter *devXclbins, int32_t num_parms)
 {
     int32_t ret;
@@ -409,6 +446,13 @@ int32_t xma_initialize(XmaXclbinParameter *devXclbins, int32_t num_parms)
     g_xma_singleton->cpu_mode = xrt_core::config::get_xma_cpu_mode();
     xma_logmsg(XMA_DEBUG_LOG, XMAAPI_MOD, "XMA CPU Mode is: %d", g_xma_singleton->cpu_mode);
 
+    g_xma_singleton->load_balance = xrt_core::config::get_xma_load_balance();
+    if (g_xma_singleton->load_balance > XMA_LOAD_BALANCE_ALL_DEVICES) {
+        xma_logmsg(XMA_WARNING_LOG, XMAAPI_MOD, "Invalid xma_load_balance setting: %d. Using CU requested by session", g_xma_singleton->load_balance);
+        g_xma_singleton->load_balance = XMA_LOAD_BALANCE_NONE;
+    }
+    xma_logmsg(XMA_DEBUG_LOG, XMAAPI_MOD, "XMA Load Balance Mode is: %d", g_xma_singleton->load_balance);
+
     xma_logmsg(XMA_INFO_LOG, XMAAPI_MOD, "Init signal and exit handlers\n");
     ret = std::atexit(xma_exit);
     if (ret) {
@@ -423,10 +467,14 @@ int32_t xma_initialize(XmaXclbinParameter *devXclbins, int32_t num_parms)
     }
 
     g_xma_singleton->xma_thread1 = std::thread(xma_thread1);
-    g_xma_singleton->xma_thread2 = std::thread(xma_thread2);
+    for (XmaHwDevice& hw_device: g_xma_singleton->hwcfg.devices) {
+        g_xma_singleton->xma_thread2.emplace_back(xma_thread2, &hw_device);
+    }
     //Detach threads to let them run independently
     g_xma_singleton->xma_thread1.detach();
-    g_xma_singleton->xma_thread2.detach();
+    for (auto& thread2: g_xma_singleton->xma_thread2) {
+        thread2.detach();
+    }
 
     xma_init_sighandlers();
 
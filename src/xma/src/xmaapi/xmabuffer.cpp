@@ -21,9 +21,14 @@
 #include "app/xmalogger.h"
 #include "app/xmaerror.h"
 #include "lib/xmahw_lib.h"
+#include "lib/xma_utils.hpp"
 //#include <cstdio>
 #include <iostream>
 #include <cstring>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #define XMA_BUFFER_MOD "xmabuffer"
 
@@ -34,6 +39,65 @@ typedef struct XmaFrameSideData
     enum XmaFrameSideDataType type;
 } XmaFrameSideData;
 
+typedef struct XmaFramePool
+{
+    void*                   dummy;
+    std::mutex              m_mutex;
+    XmaFrameProperties      frame_props;
+    std::vector<XmaFrame*>  frames_free;
+    uint32_t                num_frames;//free + in use
+    bool                    pool_destroyed;
+    uint64_t                num_allocs;
+    uint64_t                num_hits;
+    uint64_t                num_misses;
+
+  XmaFramePool() {
+    dummy = NULL;
+    std::memset(&frame_props, 0, sizeof(frame_props));
+    num_frames = 0;
+    pool_destroyed = false;
+    num_allocs = 0;
+    num_hits = 0;
+    num_misses = 0;
+  }
+} XmaFramePool;
+
+//Owning pool of each pooled frame; Public XmaFrame has no private field
+static std::mutex g_pooled_frames_mutex;
+static std::unordered_map<XmaFrame*, XmaFramePool*> g_pooled_frames;
+static std::atomic<uint64_t> g_num_pooled_frames(0);
+
+static void
+xma_frame_pool_register(XmaFrame *frame, XmaFramePool *fpool)
+{
+    std::lock_guard<std::mutex> guard1(g_pooled_frames_mutex);
+    g_pooled_frames[frame] = fpool;
+    g_num_pooled_frames = g_pooled_frames.size();
+}
+
+static void
+xma_frame_pool_unregister(XmaFrame *frame)
+{
+    std::lock_guard<std::mutex> guard1(g_pooled_frames_mutex);
+    g_pooled_frames.erase(frame);
+    g_num_pooled_frames = g_pooled_frames.size();
+}
+
+static XmaFramePool*
+xma_frame_pool_get(XmaFrame *frame)
+{
+    //Frames are not looked up when no frame pool exists
+    if (g_num_pooled_frames == 0)
+        return NULL;
+    std::lock_guard<std::mutex> guard1(g_pooled_frames_mutex);
+    auto itr1 = g_pooled_frames.find(frame);
+    if (itr1 == g_pooled_frames.end())
+        return NULL;
+    return itr1->second;
+}
+
+static void xma_frame_pool_recycle(XmaFramePool *fpool, XmaFrame *frame);
+
 int32_t
 xma_frame_planes_get(XmaFrameProperties *frame_props)
 {
@@ -155,6 +219,9 @@ int32_t xma_add_ref_cnt(XmaBufferObj *b_obj, int32_t num) {
         return -999;
     }
     XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+    if (b_obj_priv->pool) {
+        return xma_core::add_pool_buffer_ref_cnt(b_obj, num);
+    }
     b_obj_priv->ref_cnt += num;
     return b_obj_priv->ref_cnt;
 }
@@ -210,6 +277,11 @@ xma_device_buffer_free(XmaBufferObj *b_obj)
         return;
     }
     XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+    if (b_obj_priv->pool) {
+        //Drop this reference; Pool buffer is recycled instead of freed
+        xma_core::add_pool_buffer_ref_cnt(b_obj, -1);
+        return;
+    }
 
     xclFreeBO(b_obj_priv->dev_handle, b_obj_priv->boHandle);
     b_obj_priv->dummy = NULL;
@@ -242,6 +314,14 @@ xma_frame_free(XmaFrame *frame)
     if (frame->data[0].refcount > 0)
         return;
 
+    XmaFramePool *fpool = xma_frame_pool_get(frame);
+    if (fpool) {
+        //Pooled frame; plane buffers are kept for reuse
+        xma_frame_clear_all_side_data(frame);
+        xma_frame_pool_recycle(fpool, frame);
+        return;
+    }
+
     for (int32_t i = 0; i < num_planes; i++) {
         if (!frame->data[i].is_clone) {
             switch (frame->data[i].buffer_type) {
@@ -265,6 +345,172 @@ xma_frame_free(XmaFrame *frame)
     frame = NULL;
 }
 
+static XmaFramePool*
+xma_frame_pool_check(XmaFramePoolHandle pool)
+{
+    XmaFramePool *fpool = (XmaFramePool*)pool;
+    if (fpool == NULL) {
+        xma_logmsg(XMA_ERROR_LOG, XMA_BUFFER_MOD, "Frame pool is NULL\n");
+        return NULL;
+    }
+    if (fpool->dummy != (void*)(((uint64_t)fpool) | signature)) {
+        xma_logmsg(XMA_ERROR_LOG, XMA_BUFFER_MOD, "Frame pool is corrupted or already destroyed\n");
+        return NULL;
+    }
+    return fpool;
+}
+
+static void
+xma_frame_pool_free_frame(XmaFrame *frame)
+{
+    xma_frame_pool_unregister(frame);
+    int32_t num_planes = xma_frame_planes_get(&frame->frame_props);
+    for (int32_t i = 0; i < num_planes; i++) {
+        free(frame->data[i].buffer);
+        frame->data[i].buffer = NULL;
+    }
+    free(frame);
+}
+
+XmaFramePoolHandle
+xma_frame_pool_create(XmaFrameProperties *frame_props, uint32_t num_frames)
+{
+    xma_logmsg(XMA_DEBUG_LOG, XMA_BUFFER_MOD,
+               "%s() pre-allocate %d frames\n", __func__, num_frames);
+    if (frame_props == NULL) {
+        xma_logmsg(XMA_ERROR_LOG, XMA_BUFFER_MOD, "%s() frame_props is NULL\n", __func__);
+        return NULL;
+    }
+    XmaFramePool *fpool = new XmaFramePool;
+    fpool->dummy = (void*)(((uint64_t)fpool) | signature);
+    fpool->frame_props = *frame_props;
+    fpool->frames_free.reserve(num_frames);
+    for (uint32_t i = 0; i < num_frames; i++) {
+        XmaFrame *frame = xma_frame_alloc(frame_props, false);
+        if (frame == NULL) {
+            xma_logmsg(XMA_ERROR_LOG, XMA_BUFFER_MOD, "%s() OOM!!\n", __func__);
+            xma_frame_pool_destroy(fpool);
+            return NULL;
+        }
+        xma_frame_pool_register(frame, fpool);
+        fpool->frames_free.emplace_back(frame);
+        fpool->num_frames++;
+    }
+
+    return (XmaFramePoolHandle)fpool;
+}
+
+XmaFrame*
+xma_frame_pool_alloc(XmaFramePoolHandle pool)
+{
+    XmaFramePool *fpool = xma_frame_pool_check(pool);
+    if (fpool == NULL)
+        return NULL;
+
+    XmaFrame *frame = NULL;
+    {
+        std::lock_guard<std::mutex> guard1(fpool->m_mutex);
+        fpool->num_allocs++;
+        if (!fpool->frames_free.empty()) {
+            frame = fpool->frames_free.back();
+            fpool->frames_free.pop_back();
+            fpool->num_hits++;
+        } else {
+            fpool->num_misses++;
+            fpool->num_frames++;
+        }
+    }
+    if (frame == NULL) {
+        frame = xma_frame_alloc(&fpool->frame_props, false);
+        if (frame == NULL) {
+            std::lock_guard<std::mutex> guard1(fpool->m_mutex);
+            fpool->num_frames--;
+            return NULL;
+        }
+        xma_frame_pool_register(frame, fpool);
+        return frame;
+    }
+
+    //Keep plane buffers; Reset everything else as done by xma_frame_alloc
+    XmaBufferRef planes[XMA_MAX_PLANES];
+    std::memcpy(planes, frame->data, sizeof(planes));
+    memset(frame, 0, sizeof(XmaFrame));
+    frame->frame_props = fpool->frame_props;
+    int32_t num_planes = xma_frame_planes_get(&frame->frame_props);
+    for (int32_t i = 0; i < num_planes; i++) {
+        frame->data[i].refcount = 1;
+        frame->data[i].is_clone = false;
+        frame->data[i].buffer_type = XMA_HOST_BUFFER_TYPE;
+        frame->data[i].buffer = planes[i].buffer;
+        frame->data[i].xma_device_buf = NULL;
+    }
+
+    return frame;
+}
+
+static void
+xma_frame_pool_recycle(XmaFramePool *fpool, XmaFrame *frame)
+{
+    bool delete_pool = false;
+    {
+        std::lock_guard<std::mutex> guard1(fpool->m_mutex);
+        if (!fpool->pool_destroyed) {
+            fpool->frames_free.emplace_back(frame);
+            return;
+        }
+        fpool->num_frames--;
+        delete_pool = (fpool->num_frames == 0);
+    }
+    xma_frame_pool_free_frame(frame);
+    if (delete_pool) {
+        delete fpool;
+    }
+}
+
+int32_t
+xma_frame_pool_get_stats(XmaFramePoolHandle pool, XmaBufferPoolStats *stats)
+{
+    XmaFramePool *fpool = xma_frame_pool_check(pool);
+    if (fpool == NULL || stats == NULL)
+        return XMA_ERROR_INVALID;
+
+    std::lock_guard<std::mutex> guard1(fpool->m_mutex);
+    stats->num_allocs = fpool->num_allocs;
+    stats->num_hits = fpool->num_hits;
+    stats->num_misses = fpool->num_misses;
+    stats->num_buffers = fpool->num_frames;
+    stats->num_free_buffers = fpool->frames_free.size();
+
+    return XMA_SUCCESS;
+}
+
+void
+xma_frame_pool_destroy(XmaFramePoolHandle pool)
+{
+    XmaFramePool *fpool = xma_frame_pool_check(pool);
+    if (fpool == NULL)
+        return;
+
+    bool delete_pool = false;
+    {
+        std::lock_guard<std::mutex> guard1(fpool->m_mutex);
+        xma_logmsg(XMA_DEBUG_LOG, XMA_BUFFER_MOD,
+                   "%s() pool hits %lu, misses %lu\n", __func__, fpool->num_hits, fpool->num_misses);
+        fpool->dummy = NULL;
+        fpool->pool_destroyed = true;
+        for (auto frame: fpool->frames_free) {
+            xma_frame_pool_free_frame(frame);
+            fpool->num_frames--;
+        }
+        fpool->frames_free.clear();
+        //Frames still in use delete the pool when last of them is freed
+        delete_pool = (fpool->num_frames == 0);
+    }
+    if (delete_pool) {
+        delete fpool;
+    }
+}
+
 XmaSideDataHandle
 xma_side_data_alloc(void                      *side_data,
                     enum XmaFrameSideDataType sd_type,
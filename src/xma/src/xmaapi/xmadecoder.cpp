@@ -140,6 +140,12 @@ xma_dec_session_create(XmaDecoderProperties *dec_props)
         }
     }
 
+    if (g_xma_singleton->load_balance != XMA_LOAD_BALANCE_NONE) {
+        xma_core::utils::select_least_loaded_cu(hwcfg_dev_index, cu_index, dec_props->ddr_bank_index, XMA_DECODER_MOD);
+        dec_session->decoder_props.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
+        dec_session->decoder_props.cu_index = cu_index;
+    }
+
     void* dev_handle = hwcfg->devices[hwcfg_dev_index].handle;
     XmaHwKernel* kernel_info = &hwcfg->devices[hwcfg_dev_index].kernels[cu_index];
     dec_session->base.hw_session.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
@@ -284,6 +290,9 @@ xma_dec_session_destroy(XmaDecoderSession *session)
         xma_logmsg(XMA_ERROR_LOG, XMA_DECODER_MOD,
                    "Error closing decoder plugin\n");
 
+    // Free device buffer pools not released by plugin
+    xma_core::destroy_session_buffer_pools((XmaHwSessionPrivate*)session->base.hw_session.private_do_not_use);
+
     // Clean up the private data
     free(session->base.plugin_data);
 
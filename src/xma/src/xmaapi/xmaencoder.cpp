@@ -179,6 +179,12 @@ xma_enc_session_create(XmaEncoderProperties *enc_props)
         }
     }
 
+    if (g_xma_singleton->load_balance != XMA_LOAD_BALANCE_NONE) {
+        xma_core::utils::select_least_loaded_cu(hwcfg_dev_index, cu_index, enc_props->ddr_bank_index, XMA_ENCODER_MOD);
+        enc_session->encoder_props.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
+        enc_session->encoder_props.cu_index = cu_index;
+    }
+
     void* dev_handle = hwcfg->devices[hwcfg_dev_index].handle;
     XmaHwKernel* kernel_info = &hwcfg->devices[hwcfg_dev_index].kernels[cu_index];
     enc_session->base.hw_session.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
@@ -332,6 +338,9 @@ xma_enc_session_destroy(XmaEncoderSession *session)
         xma_logmsg(XMA_ERROR_LOG, XMA_ENCODER_MOD,
                    "Error closing encoder plugin. Return code %d\n", rc);
 
+    // Free device buffer pools not released by plugin
+    xma_core::destroy_session_buffer_pools((XmaHwSessionPrivate*)session->base.hw_session.private_do_not_use);
+
     // Clean up the private data
     free(session->base.plugin_data);
 
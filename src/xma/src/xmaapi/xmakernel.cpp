@@ -137,6 +137,12 @@ xma_kernel_session_create(XmaKernelProperties *props)
         }
     }
 
+    if (g_xma_singleton->load_balance != XMA_LOAD_BALANCE_NONE) {
+        xma_core::utils::select_least_loaded_cu(hwcfg_dev_index, cu_index, props->ddr_bank_index, XMA_KERNEL_MOD);
+        session->kernel_props.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
+        session->kernel_props.cu_index = cu_index;
+    }
+
     void* dev_handle = hwcfg->devices[hwcfg_dev_index].handle;
     XmaHwKernel* kernel_info = &hwcfg->devices[hwcfg_dev_index].kernels[cu_index];
     session->base.hw_session.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
@@ -283,6 +289,9 @@ xma_kernel_session_destroy(XmaKernelSession *session)
         xma_logmsg(XMA_ERROR_LOG, XMA_KERNEL_MOD,
                    "Error closing kernel plugin\n");
 
+    // Free device buffer pools not released by plugin
+    xma_core::destroy_session_buffer_pools((XmaHwSessionPrivate*)session->base.hw_session.private_do_not_use);
+
     // Clean up the private data
     free(session->base.plugin_data);
 
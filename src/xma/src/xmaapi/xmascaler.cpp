@@ -231,6 +231,12 @@ xma_scaler_session_create(XmaScalerProperties *sc_props)
         }
     }
 
+    if (g_xma_singleton->load_balance != XMA_LOAD_BALANCE_NONE) {
+        xma_core::utils::select_least_loaded_cu(hwcfg_dev_index, cu_index, sc_props->ddr_bank_index, XMA_SCALER_MOD);
+        sc_session->props.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
+        sc_session->props.cu_index = cu_index;
+    }
+
     void* dev_handle = hwcfg->devices[hwcfg_dev_index].handle;
     XmaHwKernel* kernel_info = &hwcfg->devices[hwcfg_dev_index].kernels[cu_index];
     sc_session->base.hw_session.dev_index = hwcfg->devices[hwcfg_dev_index].dev_index;
@@ -383,6 +389,9 @@ xma_scaler_session_destroy(XmaScalerSession *session)
         xma_logmsg(XMA_ERROR_LOG, XMA_SCALER_MOD,
                    "Error closing scaler plugin. Return code %d\n", rc);
 
+    // Free device buffer pools not released by plugin
+    xma_core::destroy_session_buffer_pools((XmaHwSessionPrivate*)session->base.hw_session.private_do_not_use);
+
     // Clean up the private data
     free(session->base.plugin_data);
 
@@ -351,6 +351,10 @@ xma_plg_buffer_free(XmaSession s_handle, XmaBufferObj b_obj)
         return;
     }
     XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj.private_do_not_touch;
+    if (b_obj_priv->pool) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_free failed. Use xma_plg_buffer_pool_release_buffer for buffer pool buffers.");
+        return;
+    }
     //xclDeviceHandle dev_handle = s_handle.hw_session.dev_handle;
     xclFreeBO(b_obj_priv->dev_handle, b_obj_priv->boHandle);
     b_obj_priv->dummy = nullptr;
@@ -360,6 +364,260 @@ xma_plg_buffer_free(XmaSession s_handle, XmaBufferObj b_obj)
     delete b_obj_priv;
 }
 
+static XmaBufferPool* check_buffer_pool(XmaBufferPoolObj* b_pool, const char* func) {
+    if (b_pool == nullptr) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "%s failed. XmaBufferPoolObj is NULL.", func);
+        return nullptr;
+    }
+    XmaBufferPoolObjPrivate* pool_priv = (XmaBufferPoolObjPrivate*) b_pool->private_do_not_touch;
+    if (pool_priv == nullptr || pool_priv->dummy != (void*)(((uint64_t)pool_priv) | signature)) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "%s failed. XmaBufferPoolObj is corrupted.", func);
+        return nullptr;
+    }
+    return pool_priv->pool_ptr;
+}
+
+static XmaBufferObj* alloc_pool_buffer(XmaBufferPool* pool) {
+    XmaBufferObj* b_obj = new XmaBufferObj;
+    b_obj->data = nullptr;
+    b_obj->user_ptr = nullptr;
+    b_obj->device_only_buffer = false;
+    b_obj->private_do_not_touch = nullptr;
+    b_obj->size = pool->buffer_size;
+    b_obj->bank_index = pool->bank_index;
+    b_obj->dev_index = pool->dev_index;
+
+    xclBufferHandle b_obj_handle = 0;
+    if (create_bo(pool->dev_handle, *b_obj, pool->buffer_size, pool->bank_index, pool->device_only_buffer, b_obj_handle) != XMA_SUCCESS) {
+        delete b_obj;
+        return nullptr;
+    }
+
+    XmaBufferObjPrivate* tmp1 = new XmaBufferObjPrivate;
+    b_obj->private_do_not_touch = (void*) tmp1;
+    tmp1->dummy = (void*)(((uint64_t)tmp1) | signature);
+    tmp1->size = pool->buffer_size;
+    tmp1->paddr = b_obj->paddr;
+    tmp1->bank_index = b_obj->bank_index;
+    tmp1->dev_index = b_obj->dev_index;
+    tmp1->boHandle = b_obj_handle;
+    tmp1->device_only_buffer = b_obj->device_only_buffer;
+    tmp1->dev_handle = pool->dev_handle;
+    tmp1->pool = pool;
+
+    return b_obj;
+}
+
+static XmaBufferPoolObj*
+create_buffer_pool(XmaSession s_handle, size_t size, bool device_only_buffer, int32_t ddr_index, uint32_t num_buffers, bool device_pool, int32_t* return_code)
+{
+    XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) s_handle.hw_session.private_do_not_use;
+    if (priv1 == nullptr) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_create failed. XMASession is corrupted.");
+        if (return_code) *return_code = XMA_ERROR;
+        return nullptr;
+    }
+    if (s_handle.session_signature != (void*)(((uint64_t)priv1) | ((uint64_t)priv1->reserved))) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_create failed. XMASession is corrupted.");
+        if (return_code) *return_code = XMA_ERROR;
+        return nullptr;
+    }
+    if (size == 0) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_create failed. Buffer size is zero.");
+        if (return_code) *return_code = XMA_ERROR;
+        return nullptr;
+    }
+    if (!g_xma_singleton) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_create: libxmaplugin can not be used without loading libxmaapi");
+        if (return_code) *return_code = XMA_ERROR;
+        return nullptr;
+    }
+
+    int32_t ddr_bank = ddr_index;
+    if (ddr_index < 0) {
+        ddr_bank = s_handle.hw_session.bank_index;
+        if (ddr_bank < 0) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_create can not use default ddr_bank as kernel not connected to any DDR");
+            if (return_code) *return_code = XMA_ERROR;
+            return nullptr;
+        }
+    } else if ((uint32_t)ddr_index >= priv1->device->ddrs.size() || !priv1->device->ddrs[ddr_index].in_use) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_create failed. Invalid or unused DDR index: %d", ddr_index);
+        if (return_code) *return_code = XMA_ERROR;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard1(priv1->buffer_pools_mutex);
+    size_t num_pools = priv1->buffer_pools.size();
+    XmaBufferPool* pool = xma_core::get_buffer_pool(priv1, s_handle.hw_session.dev_index, size, ddr_bank, device_only_buffer, device_pool);
+    //Pool already created by this session stays registered on failure
+    bool new_pool = (priv1->buffer_pools.size() != num_pools);
+
+    //Pre-allocate so that steady state buffer requests do not go to the driver
+    bool alloc_failed = false;
+    {
+        std::lock_guard<std::mutex> guard2(pool->m_mutex);
+        while (pool->num_buffers < num_buffers) {
+            XmaBufferObj* b_obj = alloc_pool_buffer(pool);
+            if (b_obj == nullptr) {
+                alloc_failed = true;
+                break;
+            }
+            pool->num_buffers++;
+            pool->buffers_free.emplace_back(b_obj);
+            pool->num_free_buffers++;
+        }
+    }
+    if (alloc_failed) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_create failed to pre-allocate %d buffers", num_buffers);
+        if (new_pool) {
+            //Drop this session's ownership; pool and its buffers are freed with last owner
+            priv1->buffer_pools.remove(pool);
+            xma_core::put_buffer_pool(pool);
+        }
+        if (return_code) *return_code = XMA_ERROR;
+        return nullptr;
+    }
+
+    if (return_code) *return_code = XMA_SUCCESS;
+    return &pool->pool_obj;
+}
+
+XmaBufferPoolObj*
+xma_plg_buffer_pool_create(XmaSession s_handle, size_t size, bool device_only_buffer, int32_t ddr_index, uint32_t num_buffers, int32_t* return_code)
+{
+    return create_buffer_pool(s_handle, size, device_only_buffer, ddr_index, num_buffers, false, return_code);
+}
+
+XmaBufferPoolObj*
+xma_plg_device_buffer_pool_create(XmaSession s_handle, size_t size, bool device_only_buffer, int32_t ddr_index, uint32_t num_buffers, int32_t* return_code)
+{
+    return create_buffer_pool(s_handle, size, device_only_buffer, ddr_index, num_buffers, true, return_code);
+}
+
+XmaBufferObj*
+xma_plg_buffer_pool_get_buffer(XmaBufferPoolObj* b_pool, int32_t* return_code)
+{
+    XmaBufferPool* pool = check_buffer_pool(b_pool, __func__);
+    if (pool == nullptr) {
+        if (return_code) *return_code = XMA_ERROR;
+        return nullptr;
+    }
+
+    XmaBufferObj* b_obj = nullptr;
+    {
+        std::lock_guard<std::mutex> guard1(pool->m_mutex);
+        if (pool->pool_destroyed) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_get_buffer failed. Buffer pool is destroyed.");
+            if (return_code) *return_code = XMA_ERROR;
+            return nullptr;
+        }
+        pool->num_allocs++;
+        if (!pool->buffers_free.empty()) {
+            b_obj = pool->buffers_free.back();
+            pool->buffers_free.pop_back();
+            pool->num_free_buffers--;
+            pool->num_hits++;
+        } else {
+            //Reserve the new buffer so that pool is not deleted while allocating
+            pool->num_misses++;
+            pool->num_buffers++;
+        }
+    }
+    if (b_obj == nullptr) {
+        b_obj = alloc_pool_buffer(pool);
+        if (b_obj == nullptr) {
+            std::lock_guard<std::mutex> guard1(pool->m_mutex);
+            pool->num_buffers--;
+            if (return_code) *return_code = XMA_ERROR;
+            return nullptr;
+        }
+    }
+
+    //Plugin may have changed public fields of recycled buffer
+    XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+    b_obj->size = b_obj_priv->size;
+    b_obj->paddr = b_obj_priv->paddr;
+    b_obj->bank_index = b_obj_priv->bank_index;
+    b_obj->dev_index = b_obj_priv->dev_index;
+    b_obj->device_only_buffer = b_obj_priv->device_only_buffer;
+    b_obj->user_ptr = nullptr;
+    b_obj_priv->ref_cnt = 1;
+    b_obj_priv->pool_busy = true;
+
+    if (return_code) *return_code = XMA_SUCCESS;
+    return b_obj;
+}
+
+int32_t
+xma_plg_buffer_pool_release_buffer(XmaBufferObj* b_obj)
+{
+    if (xma_check_device_buffer(b_obj) != XMA_SUCCESS) {
+        return XMA_ERROR;
+    }
+    XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+    if (b_obj_priv->pool == nullptr) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_release_buffer failed. Buffer is not from a buffer pool.");
+        return XMA_ERROR;
+    }
+    if (!b_obj_priv->pool_busy) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_release_buffer failed. Buffer is already released.");
+        return XMA_ERROR;
+    }
+    xma_core::add_pool_buffer_ref_cnt(b_obj, -1);
+
+    return XMA_SUCCESS;
+}
+
+int32_t
+xma_plg_buffer_pool_get_stats(XmaBufferPoolObj* b_pool, XmaBufferPoolStats* stats)
+{
+    XmaBufferPool* pool = check_buffer_pool(b_pool, __func__);
+    if (pool == nullptr || stats == nullptr) {
+        return XMA_ERROR;
+    }
+    stats->num_allocs = pool->num_allocs;
+    stats->num_hits = pool->num_hits;
+    stats->num_misses = pool->num_misses;
+    stats->num_buffers = pool->num_buffers;
+    stats->num_free_buffers = pool->num_free_buffers;
+
+    return XMA_SUCCESS;
+}
+
+int32_t
+xma_plg_buffer_pool_destroy(XmaSession s_handle, XmaBufferPoolObj* b_pool)
+{
+    XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) s_handle.hw_session.private_do_not_use;
+    if (priv1 == nullptr) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_destroy failed. XMASession is corrupted.");
+        return XMA_ERROR;
+    }
+    if (s_handle.session_signature != (void*)(((uint64_t)priv1) | ((uint64_t)priv1->reserved))) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_destroy failed. XMASession is corrupted.");
+        return XMA_ERROR;
+    }
+    XmaBufferPool* pool = check_buffer_pool(b_pool, __func__);
+    if (pool == nullptr) {
+        return XMA_ERROR;
+    }
+
+    std::lock_guard<std::mutex> guard1(priv1->buffer_pools_mutex);
+    for (auto itr1 = priv1->buffer_pools.begin(); itr1 != priv1->buffer_pools.end(); itr1++) {
+        if (*itr1 != pool) {
+            continue;
+        }
+        xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_destroy: pool hits %lu, misses %lu",
+            (uint64_t)pool->num_hits, (uint64_t)pool->num_misses);
+        priv1->buffer_pools.erase(itr1);
+        //Pool is freed with last owner and last buffer in use
+        xma_core::put_buffer_pool(pool);
+        return XMA_SUCCESS;
+    }
+    xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_buffer_pool_destroy failed. Buffer pool does not belong to this session.");
+    return XMA_ERROR;
+}
+
 int32_t
 xma_plg_buffer_write(XmaSession s_handle,
                      XmaBufferObj  b_obj,
@@ -667,6 +925,7 @@ XmaCUCmdObj xma_plg_schedule_work_item(XmaSession s_handle,
             return cmd_obj_error;
         }
     }
+    priv1->kernel_execbos[bo_idx].submit_time = std::chrono::steady_clock::now();
     priv1->last_execbo_handle = priv1->kernel_execbos[bo_idx].handle;
 
     XmaCUCmdObj cmd_obj;
@@ -898,6 +1157,7 @@ XmaCUCmdObj xma_plg_schedule_cu_cmd(XmaSession s_handle,
             return cmd_obj_error;
         }
     }
+    priv1->kernel_execbos[bo_idx].submit_time = std::chrono::steady_clock::now();
     priv1->last_execbo_handle = priv1->kernel_execbos[bo_idx].handle;
 
     XmaCUCmdObj cmd_obj;
@@ -1006,6 +1266,8 @@ int32_t xma_plg_cu_cmd_status(XmaSession s_handle, XmaCUCmdObj* cmd_obj_array, i
 
     std::vector<XmaCUCmdObj> cmd_vector(cmd_obj_array, cmd_obj_array+num_cu_objs);
     do {
+        //Outstanding cmds before checking; completion thread decrements it for every completed cmd
+        uint32_t pending_cmds = priv1->num_cu_cmds;
         all_done = true;
         for (auto& cmd: cmd_vector) {
             if (s_handle.session_type < XMA_ADMIN && cmd.cu_index != kernel_tmp1->cu_index) {
@@ -1043,8 +1305,10 @@ int32_t xma_plg_cu_cmd_status(XmaSession s_handle, XmaCUCmdObj* cmd_obj_array, i
             all_done = true;
         } else if (!all_done) {
             if (g_xma_singleton->cpu_mode == XMA_CPU_MODE1) {
+                //Woken up by device completion thread when a cmd of this session completes
                 std::unique_lock<std::mutex> lk(priv1->m_mutex);
-                priv1->work_item_done_1plus.wait(lk);
+                priv1->work_item_done_1plus.wait_for(lk, std::chrono::milliseconds(10),
+                    [priv1, pending_cmds] { return priv1->num_cu_cmds < pending_cmds; });
                 lk.unlock();
             } else if (g_xma_singleton->cpu_mode == XMA_CPU_MODE2) {
                 std::this_thread::yield();
@@ -1138,8 +1402,10 @@ int32_t xma_plg_is_work_item_done(XmaSession s_handle, uint32_t timeout_ms)
     }
     if (g_xma_singleton->cpu_mode == XMA_CPU_MODE1) {
         while (iter1 > 0) {
+            //Woken up by device completion thread only for this session
             std::unique_lock<std::mutex> lk(priv1->m_mutex);
-            priv1->work_item_done_1plus.wait(lk);
+            priv1->work_item_done_1plus.wait_for(lk, std::chrono::milliseconds(10),
+                [priv1] { return priv1->kernel_complete_count != 0; });
             lk.unlock();
 
             count = priv1->kernel_complete_count;
@@ -1391,6 +1657,9 @@ int32_t xma_plg_add_ref_cnt(XmaBufferObj *b_obj, int32_t num) {
         return -999;
     }
     XmaBufferObjPrivate* b_obj_priv = (XmaBufferObjPrivate*) b_obj->private_do_not_touch;
+    if (b_obj_priv->pool) {
+        return xma_core::add_pool_buffer_ref_cnt(b_obj, num);
+    }
     b_obj_priv->ref_cnt += num;
     return b_obj_priv->ref_cnt;
 }
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2020, Xilinx Inc - All rights reserved
+ * Xilinx SDAccel Media Accelerator API
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <memory.h>
+#include <string>
+#include <iostream>
+#include "xma.h"
+#include "lib/xmaapi.h"
+#include "lib/xmahw_lib.h"
+#include "lib/xmalimits_lib.h"
+#include "lib/xma_utils.hpp"
+
+extern XmaSingleton *g_xma_singleton;
+
+int ck_assert_int_eq(int rc1, int rc2) {
+  if (rc1 != rc2) {
+    return -1;
+  } else {
+    return 0;
+  }
+}
+
+int ck_assert(bool result) {
+  if (!result) {
+    return -1;
+  } else {
+    return 0;
+  }
+}
+
+/* Mock CU cmd stats; No device is opened */
+static XmaHwSessionPrivate mock_privs[8];
+static int32_t num_mock_sessions = 0;
+
+static void add_kernel(XmaHwDevice& device, const char* name, uint64_t ddr_mapping)
+{
+    XmaHwKernel kernel;
+    strncpy((char*)kernel.name, name, MAX_KERNEL_NAME - 1);
+    kernel.cu_index = device.kernels.size();
+    kernel.ip_ddr_mapping = ddr_mapping;
+    kernel.in_use = true;
+    device.kernels.emplace_back(kernel);
+}
+
+static void xmaload_setup(uint32_t mode)
+{
+    g_xma_singleton->load_balance = mode;
+    g_xma_singleton->all_sessions_vec.clear();
+    g_xma_singleton->hwcfg.devices.clear();
+    g_xma_singleton->hwcfg.devices.resize(2);
+    g_xma_singleton->hwcfg.num_devices = 2;
+    for (uint32_t d = 0; d < 2; d++) {
+        XmaHwDevice& device = g_xma_singleton->hwcfg.devices[d];
+        device.dev_index = d;
+        /* enc_1 on DDR 0, enc_2 on DDR 1, enc_3 on DDR 0 & 1 */
+        add_kernel(device, "enc:{enc_1}", 0x1);
+        add_kernel(device, "enc:{enc_2}", 0x2);
+        add_kernel(device, "enc:{enc_3}", 0x3);
+        add_kernel(device, "scaler:{scaler_1}", 0x1);
+    }
+    num_mock_sessions = 0;
+}
+
+/* Session on dev/cu with busy vs idle samples and outstanding cmds */
+static void add_session(uint32_t dev, int32_t cu, uint32_t busy, uint32_t idle, uint32_t cmds)
+{
+    XmaHwSessionPrivate* priv = &mock_privs[num_mock_sessions];
+    priv->device = &g_xma_singleton->hwcfg.devices[dev];
+    priv->kernel_info = &priv->device->kernels[cu];
+    priv->cmd_busy = busy;
+    priv->cmd_idle = idle;
+    priv->num_cu_cmds = cmds;
+    priv->rebalance_hint = false;
+
+    XmaSession session;
+    memset(&session, 0, sizeof(session));
+    session.session_id = num_mock_sessions++;
+    session.session_type = XMA_ENCODER;
+    session.hw_session.private_do_not_use = priv;
+    g_xma_singleton->all_sessions_vec.emplace_back(session);
+}
+
+int xmaload_session_load()
+{
+    int rc = 0;
+    /* Too few samples count as fully loaded */
+    rc |= ck_assert_int_eq(xma_core::utils::get_session_load(10, 10, 0), XMA_LOAD_FULL);
+    rc |= ck_assert_int_eq(xma_core::utils::get_session_load(0, XMA_LOAD_MIN_SAMPLES, 0), 0);
+    rc |= ck_assert_int_eq(xma_core::utils::get_session_load(XMA_LOAD_MIN_SAMPLES, XMA_LOAD_MIN_SAMPLES, 2),
+                           XMA_LOAD_FULL / 2 + 2 * XMA_LOAD_PER_CMD);
+    rc |= ck_assert(xma_core::utils::is_rebalance_needed(2 * XMA_LOAD_FULL, 0, XMA_LOAD_FULL / 2));
+    rc |= ck_assert(!xma_core::utils::is_rebalance_needed(XMA_LOAD_FULL, XMA_LOAD_FULL / 2, XMA_LOAD_FULL / 2));
+    if (rc != 0) {
+      printf("ERROR: xmaload_session_load failed\n");
+    }
+    return rc;
+}
+
+int xmaload_select_none()
+{
+    int rc = 0;
+    xmaload_setup(XMA_LOAD_BALANCE_NONE);
+    add_session(0, 0, 200, 0, 4);
+    uint32_t dev = 0;
+    int32_t cu = 0;
+    xma_core::utils::select_least_loaded_cu(dev, cu, -1, "check_xmaload");
+    rc |= ck_assert_int_eq(dev, 0);
+    rc |= ck_assert_int_eq(cu, 0);
+    if (rc != 0) {
+      printf("ERROR: xmaload_select_none failed\n");
+    }
+    return rc;
+}
+
+int xmaload_select_device()
+{
+    int rc = 0;
+    xmaload_setup(XMA_LOAD_BALANCE_DEVICE);
+    add_session(0, 0, 200, 0, 4);
+    add_session(0, 1, 100, 100, 0);
+    add_session(1, 2, 0, 0, 0);
+    uint32_t dev = 0;
+    int32_t cu = 0;
+    /* enc_3 of device 0 is idle; device 1 is not considered */
+    xma_core::utils::select_least_loaded_cu(dev, cu, -1, "check_xmaload");
+    rc |= ck_assert_int_eq(dev, 0);
+    rc |= ck_assert_int_eq(cu, 2);
+
+    /* Other kernels are never selected */
+    dev = 0;
+    cu = 3;
+    add_session(0, 3, 200, 0, 4);
+    xma_core::utils::select_least_loaded_cu(dev, cu, -1, "check_xmaload");
+    rc |= ck_assert_int_eq(cu, 3);
+    if (rc != 0) {
+      printf("ERROR: xmaload_select_device failed\n");
+    }
+    return rc;
+}
+
+int xmaload_select_all_devices()
+{
+    int rc = 0;
+    xmaload_setup(XMA_LOAD_BALANCE_ALL_DEVICES);
+    for (int32_t cu = 0; cu < 3; cu++) {
+      add_session(0, cu, 200, 0, 4);
+      if (cu == 1) {
+        /* enc_2 of device 1 is the only idle CU */
+        add_session(1, cu, 0, 200, 0);
+      } else {
+        add_session(1, cu, 200, 0, 4);
+      }
+    }
+    uint32_t dev = 0;
+    int32_t cu = 0;
+    xma_core::utils::select_least_loaded_cu(dev, cu, -1, "check_xmaload");
+    rc |= ck_assert_int_eq(dev, 1);
+    rc |= ck_assert_int_eq(cu, 1);
+    if (rc != 0) {
+      printf("ERROR: xmaload_select_all_devices failed\n");
+    }
+    return rc;
+}
+
+int xmaload_select_ddr_bank()
+{
+    int rc = 0;
+    xmaload_setup(XMA_LOAD_BALANCE_DEVICE);
+    add_session(0, 0, 200, 0, 4);
+    add_session(0, 2, 200, 0, 4);
+    uint32_t dev = 0;
+    int32_t cu = 0;
+    /* enc_2 is idle but not connected to DDR 0 */
+    xma_core::utils::select_least_loaded_cu(dev, cu, 0, "check_xmaload");
+    rc |= ck_assert_int_eq(cu, 0);
+
+    /* Without ddr bank enc_2 is selected */
+    xma_core::utils::select_least_loaded_cu(dev, cu, -1, "check_xmaload");
+    rc |= ck_assert_int_eq(cu, 1);
+
+    /* enc_3 is connected to DDR 1 as well */
+    xmaload_setup(XMA_LOAD_BALANCE_DEVICE);
+    add_session(0, 1, 200, 0, 4);
+    cu = 1;
+    xma_core::utils::select_least_loaded_cu(dev, cu, 1, "check_xmaload");
+    rc |= ck_assert_int_eq(cu, 2);
+    if (rc != 0) {
+      printf("ERROR: xmaload_select_ddr_bank failed\n");
+    }
+    return rc;
+}
+
+int xmaload_rebalance_hints()
+{
+    int rc = 0;
+    xmaload_setup(XMA_LOAD_BALANCE_DEVICE);
+    add_session(0, 0, 200, 0, 4);
+    add_session(0, 0, 200, 0, 4);
+    add_session(0, 1, 10, 10, 0);
+    xma_core::utils::update_rebalance_hints();
+    /* Two busy sessions share enc_1 while enc_3 is idle */
+    rc |= ck_assert(mock_privs[0].rebalance_hint);
+    rc |= ck_assert(mock_privs[1].rebalance_hint);
+    /* Too few samples; no hint */
+    rc |= ck_assert(!mock_privs[2].rebalance_hint);
+    if (rc != 0) {
+      printf("ERROR: xmaload_rebalance_hints failed\n");
+    }
+    return rc;
+}
+
+int main()
+{
+    int number_failed = 0;
+    int rc;
+
+    rc = xmaload_session_load();
+    if (rc != 0) {
+      number_failed++;
+    }
+
+    rc = xmaload_select_none();
+    if (rc != 0) {
+      number_failed++;
+    }
+
+    rc = xmaload_select_device();
+    if (rc != 0) {
+      number_failed++;
+    }
+
+    rc = xmaload_select_all_devices();
+    if (rc != 0) {
+      number_failed++;
+    }
+
+    rc = xmaload_select_ddr_bank();
+    if (rc != 0) {
+      number_failed++;
+    }
+
+    rc = xmaload_rebalance_hints();
+    if (rc != 0) {
+      number_failed++;
+    }
+
+    g_xma_singleton->all_sessions_vec.clear();
+    g_xma_singleton->hwcfg.devices.clear();
+
+   if (number_failed == 0) {
+     printf("XMA check_xmaload test completed successfully\n");
+     return EXIT_SUCCESS;
+    } else {
+     printf("ERROR: XMA check_xmaload test failed\n");
+     return EXIT_FAILURE;
+    }
+}
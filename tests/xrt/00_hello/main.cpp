@@ -34,6 +34,7 @@ static void usage()
     std::cout << "usage: %s [options] -k <bitstream>\n\n";
     std::cout << "  -k <bitstream>\n";
     std::cout << "  -d <device_index>\n";
+    std::cout << "  -p <peer_device_index> for cross device copy\n";
     std::cout << "  -c <name of compute unit in xclbin>\n";
     std::cout << "  -v\n";
     std::cout << "  -h\n\n";
@@ -74,6 +75,50 @@ copy_test(const xrt::device& device, size_t bytes, int32_t grpidx)
     throw std::runtime_error("Value read back from copy bo does not match value written");
 }
 
+static void
+peer_copy(xrt::bo& src, const xrt::device& peer, size_t bytes, int32_t grpidx)
+{
+  auto src_data = src.map<char*>();
+  auto dst = xrt::bo(peer, bytes, 0, grpidx);
+  dst.copy(src, bytes);
+  dst.sync(XCL_BO_SYNC_BO_FROM_DEVICE , bytes, 0);
+  auto dst_data = dst.map<char*>();
+  if (!std::equal(src_data, src_data + bytes, dst_data))
+    throw std::runtime_error("Value read back from peer copy bo does not match value written");
+}
+
+static void
+peer_copy_test(const xrt::device& device, unsigned int peer_index, const std::string& xclbin_fnm,
+               const std::string& cu_name, size_t bytes, int32_t grpidx)
+{
+  auto bo = xrt::bo(device, bytes, 0, grpidx);
+  auto bo_data = bo.map<char*>();
+  auto sub = xrt::bo(bo, bytes / 2, bytes / 2);
+
+  {
+    auto peer = xrt::device(peer_index);
+    auto uuid = peer.load_xclbin(xclbin_fnm);
+    auto kernel = xrt::kernel(peer, uuid, cu_name, xrt::kernel::cu_access_mode::shared);
+    auto peer_grpidx = kernel.group_id(0);
+
+    // Repeated copies from the same bo reuse the import into the peer
+    // device, the import must see the current content of the bo
+    for (int i = 0; i < 3; ++i) {
+      std::generate_n(bo_data, bytes, []() { return std::rand() % 256; });
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE , bytes , 0);
+      peer_copy(bo, peer, bytes, peer_grpidx);
+      peer_copy(sub, peer, bytes / 2, peer_grpidx);
+    }
+  }
+
+  // Peer device is closed while bo is alive, a reopened peer device
+  // gets a new import
+  auto peer = xrt::device(peer_index);
+  auto uuid = peer.load_xclbin(xclbin_fnm);
+  auto kernel = xrt::kernel(peer, uuid, cu_name, xrt::kernel::cu_access_mode::shared);
+  peer_copy(bo, peer, bytes, kernel.group_id(0));
+}
+
 int run(int argc, char** argv)
 {
   if (argc < 3) {
@@ -85,6 +130,7 @@ int run(int argc, char** argv)
   std::string cu_name = "dummy";
   bool verbose = false;
   unsigned int device_index = 0;
+  int peer_index = -1;
 
   std::vector<std::string> args(argv+1,argv+argc);
   std::string cur;
@@ -107,6 +153,8 @@ int run(int argc, char** argv)
       xclbin_fnm = arg;
     else if (cur == "-d")
       device_index = std::stoi(arg);
+    else if (cur == "-p")
+      peer_index = std::stoi(arg);
     else if (cur == "-c")
       cu_name = arg;
     else
@@ -118,7 +166,7 @@ int run(int argc, char** argv)
 
   auto device = xrt::device(device_index);
   auto uuid = device.load_xclbin(xclbin_fnm);
-  auto kernel = xrt::kernel(device, uuid, cu_name);
+  auto kernel = xrt::kernel(device, uuid, cu_name, xrt::kernel::cu_access_mode::shared);
   auto grpidx = kernel.group_id(0);
 
   sync_test(device, grpidx);
@@ -127,6 +175,9 @@ int run(int argc, char** argv)
   // Copy through host not 64 byte aligned
   copy_test(device, 40, grpidx);
 
+  if (peer_index >= 0)
+    peer_copy_test(device, peer_index, xclbin_fnm, cu_name, 4096, grpidx);
+
   return 0;
 }
 
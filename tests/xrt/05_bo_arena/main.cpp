@@ -0,0 +1,235 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "experimental/xrt_device.h"
+#include "experimental/xrt_kernel.h"
+#include "experimental/xrt_bo.h"
+
+/**
+ * Exercise xrt::bo_arena allocation of small buffers.  Buffers are
+ * carved out of arena parent buffers, aligned to their size class,
+ * and released buffers are reused by later allocations.
+ */
+
+// Arena with 64KB chunks has size classes from 64 to 1024 bytes
+static constexpr size_t chunk_size = 64 * 1024;
+static constexpr size_t max_block_size = chunk_size / 64;
+
+static void usage()
+{
+    std::cout << "usage: %s [options] -k <bitstream>\n\n";
+    std::cout << "  -k <bitstream>\n";
+    std::cout << "  -d <device_index>\n";
+    std::cout << "  -c <name of compute unit in xclbin>\n";
+    std::cout << "  -v\n";
+    std::cout << "  -h\n\n";
+    std::cout << "";
+    std::cout << "* Bitstream is required\n";
+}
+
+static size_t
+size_class(size_t size)
+{
+  size_t cls = 64;
+  while (cls < size)
+    cls *= 2;
+  return cls;
+}
+
+static bool
+overlap(const xrt::bo& bo1, const xrt::bo& bo2)
+{
+  return bo1.address() < bo2.address() + bo2.size()
+    && bo2.address() < bo1.address() + bo1.size();
+}
+
+static void
+alignment_test(xrt::bo_arena& arena, int32_t grpidx, bool verbose)
+{
+  std::vector<xrt::bo> bos;
+  for (size_t size : {1, 40, 64, 65, 100, 128, 200, 512, 1000, 1024}) {
+    auto bo = arena.alloc(size, grpidx);
+    if (bo.size() != size)
+      throw std::runtime_error("Arena buffer size mismatch");
+    if (bo.address() % size_class(size))
+      throw std::runtime_error("Arena buffer of size " + std::to_string(size) + " is not aligned to its size class");
+    if (verbose)
+      std::cout << "size " << size << " address 0x" << std::hex << bo.address() << std::dec << "\n";
+    bos.push_back(std::move(bo));
+  }
+
+  // Live buffers must not share device memory
+  for (size_t i = 0; i < bos.size(); ++i)
+    for (size_t j = i + 1; j < bos.size(); ++j)
+      if (overlap(bos[i], bos[j]))
+        throw std::runtime_error("Arena buffers overlap");
+}
+
+static void
+reuse_test(xrt::bo_arena& arena, int32_t grpidx)
+{
+  uint64_t addr = 0;
+  {
+    auto bo = arena.alloc(100, grpidx);
+    addr = bo.address();
+  }
+
+  // Released buffer is reused by allocation of same size class
+  auto bo1 = arena.alloc(120, grpidx);
+  if (bo1.address() != addr)
+    throw std::runtime_error("Released arena buffer is not reused");
+
+  // Next buffer of the size class is a different block
+  auto bo2 = arena.alloc(100, grpidx);
+  if (bo2.address() == addr || overlap(bo1, bo2))
+    throw std::runtime_error("Arena buffer handed out twice");
+
+  // Exhaust more than one chunk; released buffers come back first
+  std::vector<xrt::bo> bos;
+  for (size_t i = 0; i < 2 * chunk_size / max_block_size; ++i)
+    bos.push_back(arena.alloc(max_block_size, grpidx));
+  std::vector<uint64_t> addrs;
+  for (auto& bo : bos)
+    addrs.push_back(bo.address());
+  bos.clear();
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    auto bo = arena.alloc(max_block_size, grpidx);
+    if (std::find(addrs.begin(), addrs.end(), bo.address()) == addrs.end())
+      throw std::runtime_error("Arena allocated new memory while free buffers exist");
+    bos.push_back(std::move(bo));
+  }
+}
+
+static void
+large_test(xrt::bo_arena& arena, int32_t grpidx)
+{
+  // Larger buffers are regular buffers
+  auto bo = arena.alloc(max_block_size + 1, grpidx);
+  if (bo.size() != max_block_size + 1)
+    throw std::runtime_error("Large arena buffer size mismatch");
+}
+
+static void
+sync_test(xrt::bo_arena& arena, int32_t grpidx)
+{
+  std::string testVector =  "hello\nthis is Xilinx arena BO read write test\n:-)\n";
+  const size_t data_size = testVector.size();
+
+  // Neighbour buffers must not be touched by sync of a sub buffer
+  auto bo1 = arena.alloc(data_size, grpidx);
+  auto bo2 = arena.alloc(data_size, grpidx);
+  auto bo1_data = bo1.map<char*>();
+  auto bo2_data = bo2.map<char*>();
+  std::copy_n(testVector.begin(), data_size, bo1_data);
+  std::fill_n(bo2_data, data_size, 'x');
+  bo1.sync(XCL_BO_SYNC_BO_TO_DEVICE, data_size, 0);
+  bo2.sync(XCL_BO_SYNC_BO_TO_DEVICE, data_size, 0);
+
+  // Device copy of bo2 is 'x', host copy is 'y'.  Syncing bo1 from
+  // device must not bring the 'x' back into bo2.
+  std::fill_n(bo1_data, data_size, 0);
+  std::fill_n(bo2_data, data_size, 'y');
+  bo1.sync(XCL_BO_SYNC_BO_FROM_DEVICE, data_size, 0);
+  if (!std::equal(testVector.begin(), testVector.end(), bo1_data))
+    throw std::runtime_error("Value read back from arena bo does not match value written");
+  if (std::count(bo2_data, bo2_data + data_size, 'y') != static_cast<long>(data_size))
+    throw std::runtime_error("Sync of arena bo modified neighbour bo");
+
+  // Device copy of bo2 is still intact
+  bo2.sync(XCL_BO_SYNC_BO_FROM_DEVICE, data_size, 0);
+  if (std::count(bo2_data, bo2_data + data_size, 'x') != static_cast<long>(data_size))
+    throw std::runtime_error("Neighbour arena bo was modified on device");
+}
+
+int run(int argc, char** argv)
+{
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  std::string xclbin_fnm;
+  std::string cu_name = "dummy";
+  bool verbose = false;
+  unsigned int device_index = 0;
+
+  std::vector<std::string> args(argv+1,argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    else if (arg == "-v") {
+      verbose = true;
+      continue;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-c")
+      cu_name = arg;
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  auto device = xrt::device(device_index);
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  auto kernel = xrt::kernel(device, uuid, cu_name, xrt::kernel::cu_access_mode::shared);
+  auto grpidx = kernel.group_id(0);
+
+  xrt::bo_arena arena(device, 0, chunk_size);
+  alignment_test(arena, grpidx, verbose);
+  reuse_test(arena, grpidx);
+  large_test(arena, grpidx);
+  sync_test(arena, grpidx);
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    auto ret = run(argc, argv);
+    std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (std::exception const& e) {
+    std::cout << "Exception: " << e.what() << "\n";
+    std::cout << "FAILED TEST\n";
+    return 1;
+  }
+
+  std::cout << "PASSED TEST\n";
+  return 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright (C) 2020 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "experimental/xrt_device.h"
+#include "experimental/xrt_kernel.h"
+#include "experimental/xrt_bo.h"
+
+/**
+ * Loads the same xclbin twice and runs the hello kernel after each
+ * load.  On hardware xocl skips the download of the xclbin the device
+ * already runs.  In emulation XRT skips relaunching the device
+ * process, which is checked in the runtime log.  Either way the
+ * kernel must run after the reload.
+ */
+
+static const char ini_fnm[] = "23_reload.ini";
+static const char log_fnm[] = "23_reload.log";
+static const char skip_msg[] = "xclbin already loaded, skipping download";
+
+static const char gold[] = "Hello World\n";
+
+static void usage()
+{
+    std::cout << "usage: %s [options] -k <bitstream>\n\n";
+    std::cout << "  -k <bitstream>\n";
+    std::cout << "  -d <index>\n";
+    std::cout << "  -v\n";
+    std::cout << "  -h\n\n";
+    std::cout << "* Bitstream is required\n";
+}
+
+static void
+run(const xrt::device& device, const xrt::uuid& uuid, bool verbose)
+{
+  auto hello = xrt::kernel(device, uuid, "hello:hello_1", xrt::kernel::cu_access_mode::shared);
+
+  auto bo = xrt::bo(device, 1024, 0, hello.group_id(0));
+  auto bo_data = bo.map<char*>();
+  std::fill(bo_data, bo_data + 1024, 0);
+  bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, 1024,0);
+
+  auto run = hello(bo);
+  run.wait();
+
+  bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE, 1024, 0);
+  if (verbose) {
+    std::cout << "RESULT: ";
+    for (unsigned i = 0; i < 20; ++i)
+      std::cout << bo_data[i];
+    std::cout << std::endl;
+  }
+  if (!std::equal(std::begin(gold), std::end(gold), bo_data))
+    throw std::runtime_error("Incorrect value obtained");
+}
+
+// Send the runtime log to a file unless the caller has an xrt.ini
+static bool
+init_runtime_log()
+{
+  if (std::getenv("XRT_INI_PATH"))
+    return false;
+
+  std::ofstream ini(ini_fnm);
+  ini << "[Runtime]\n"
+      << "runtime_log=" << log_fnm << "\n"
+      << "verbosity=6\n";
+  ini.close();
+  if (!ini)
+    throw std::runtime_error(std::string("Cannot write ") + ini_fnm);
+  return setenv("XRT_INI_PATH", ini_fnm, 0) == 0;
+}
+
+static unsigned int
+count_skips()
+{
+  std::ifstream log(log_fnm);
+  if (!log)
+    throw std::runtime_error(std::string("Cannot read ") + log_fnm);
+
+  unsigned int count = 0;
+  std::string line;
+  while (std::getline(log, line))
+    if (line.find(skip_msg) != std::string::npos)
+      ++count;
+  return count;
+}
+
+static xrt::uuid
+load(xrt::device& device, const std::string& xclbin_fnm)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "load_xclbin: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+            << " ms\n";
+  return uuid;
+}
+
+int run(int argc, char** argv)
+{
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  std::string xclbin_fnm;
+  bool verbose = false;
+  unsigned int device_index = 0;
+
+  std::vector<std::string> args(argv+1,argv+argc);
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+    else if (arg == "-v") {
+      verbose = true;
+      continue;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  // Must precede the first XRT call, which reads the ini file
+  auto logged = init_runtime_log();
+  bool emulation = std::getenv("XCL_EMULATION_MODE") != nullptr;
+
+  auto device = xrt::device(device_index);
+  auto uuid = load(device, xclbin_fnm);
+  run(device, uuid, verbose);
+  if (logged && emulation && count_skips() != 0)
+    throw std::runtime_error("first load of xclbin was skipped");
+
+  // Same xclbin again, kernel objects of the first load are gone
+  auto reload_uuid = load(device, xclbin_fnm);
+  if (reload_uuid != uuid)
+    throw std::runtime_error("uuid of reloaded xclbin does not match");
+  if (logged && emulation && count_skips() != 1)
+    throw std::runtime_error("reload of identical xclbin was not skipped");
+  run(device, reload_uuid, verbose);
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    auto ret = run(argc, argv);
+    std::cout << "PASSED TEST\n";
+    return ret;
+  }
+  catch (std::exception const& e) {
+    std::cout << "Exception: " << e.what() << "\n";
+    std::cout << "FAILED TEST\n";
+    return 1;
+  }
+
+  std::cout << "PASSED TEST\n";
+  return 0;
+}